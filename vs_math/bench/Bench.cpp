@@ -0,0 +1,175 @@
+#include "bench.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace {
+// Escapes quotes and backslashes of benchmark name
+std::string quoted(const std::string &text) {
+    std::string result = "\"";
+    for (size_t idx = 0; idx < text.size(); ++idx) {
+        if (text[idx] == '"' || text[idx] == '\\')
+            result += '\\';
+        result += text[idx];
+    }
+    return result + "\"";
+}
+
+// Reads JSON string starting at pos, which points to opening quote, and moves pos behind it
+bool readString(const std::string &json, size_t &pos, std::string &value) {
+    value.clear();
+    for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+        if (json[pos] == '\\' && pos + 1 < json.size())
+            ++pos;
+        value += json[pos];
+    }
+    if (pos >= json.size())
+        return false;
+    ++pos;
+    return true;
+}
+
+/*
+ * Reads ns_per_item of every benchmark of baseline. Only format of writeJson() is supported, so that parser is a
+ * search for "name" keys followed by "ns_per_item" key of the same object
+ */
+bool readBaseline(const char *filename, std::map<std::string, double> &baseline) {
+    std::ifstream file(filename);
+    if (!file)
+        return false;
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string json = content.str();
+    const std::string name_key = "\"name\":", time_key = "\"ns_per_item\":";
+
+    size_t pos = json.find("\"benchmarks\"");
+    if (pos == std::string::npos)
+        return false;
+    while ((pos = json.find(name_key, pos)) != std::string::npos) {
+        pos = json.find('"', pos + name_key.size());
+        std::string name;
+        if (pos == std::string::npos || !readString(json, pos, name))
+            return false;
+        size_t time = json.find(time_key, pos), object_end = json.find('}', pos);
+        if (time == std::string::npos || time > object_end)
+            return false;
+        baseline[name] = std::strtod(json.c_str() + time + time_key.size(), nullptr);
+        pos = object_end;
+    }
+    return true;
+}
+} // namespace
+
+Bench::Options &Bench::options() {
+    static Options options;
+    return options;
+}
+
+std::vector<Bench::Result> &Bench::results() {
+    static std::vector<Result> results;
+    return results;
+}
+
+bool Bench::isSelected(const char *name) {
+    return options().filter.empty() || std::string(name).find(options().filter) != std::string::npos;
+}
+
+void Bench::report(const Result &result) {
+    std::printf("%-48s %14.1f ns/run %10.2f ns/item", result.name.c_str(), result.ns_per_run, result.ns_per_item);
+    const double *counters = result.counters;
+    const double items = (double)(result.items == 0 ? 1 : result.items);
+    if (counters[PerfCounters::CYCLES] > 0 && counters[PerfCounters::INSTRUCTIONS] >= 0)
+        std::printf(" %6.2f IPC", counters[PerfCounters::INSTRUCTIONS] / counters[PerfCounters::CYCLES]);
+    if (counters[PerfCounters::CACHE_MISSES] >= 0)
+        std::printf(" %9.3f cache-miss/item", counters[PerfCounters::CACHE_MISSES] / items);
+    if (counters[PerfCounters::BRANCH_MISSES] >= 0)
+        std::printf(" %9.3f branch-miss/item", counters[PerfCounters::BRANCH_MISSES] / items);
+    std::printf("\n");
+    std::fflush(stdout);
+    results().push_back(result);
+}
+
+bool Bench::writeJson(const char *filename) {
+    std::ofstream file(filename);
+    if (!file)
+        return false;
+
+    char date[32] = "";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#ifdef NDEBUG
+    const char *build = "release";
+#else
+    const char *build = "debug";
+#endif
+    char buf[128];
+    file << "{\n  \"context\": {\n";
+    file << "    \"date\": " << quoted(date) << ",\n";
+    file << "    \"build_type\": " << quoted(build) << ",\n";
+    file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    std::snprintf(buf, sizeof(buf), "    \"min_time\": %g,\n", options().min_seconds);
+    file << buf;
+    file << "    \"repetitions\": " << options().repetitions << ",\n";
+    file << "    \"perf_counters\": " << (options().perf && PerfCounters::instance().isAvailable() ? "true" : "false")
+         << "\n  },\n";
+    file << "  \"benchmarks\": [";
+    const std::vector<Result> &all = results();
+    for (size_t idx = 0; idx < all.size(); ++idx) {
+        file << (idx == 0 ? "\n" : ",\n");
+        file << "    {\"name\": " << quoted(all[idx].name) << ", \"items\": " << all[idx].items
+             << ", \"runs\": " << all[idx].runs;
+        std::snprintf(buf, sizeof(buf), ", \"ns_per_run\": %.3f, \"ns_per_item\": %.4f", all[idx].ns_per_run,
+                      all[idx].ns_per_item);
+        file << buf;
+        const double *counters = all[idx].counters;
+        const double items = (double)(all[idx].items == 0 ? 1 : all[idx].items);
+        if (counters[PerfCounters::CYCLES] > 0 && counters[PerfCounters::INSTRUCTIONS] >= 0) {
+            std::snprintf(buf, sizeof(buf), ", \"ipc\": %.4f",
+                          counters[PerfCounters::INSTRUCTIONS] / counters[PerfCounters::CYCLES]);
+            file << buf;
+        }
+        for (size_t event = 0; event < PerfCounters::EVENTS; ++event) {
+            if (counters[event] < 0)
+                continue;
+            std::snprintf(buf, sizeof(buf), ", \"%s_per_item\": %.4f",
+                          PerfCounters::getName((PerfCounters::Event)event), counters[event] / items);
+            file << buf;
+        }
+        file << "}";
+    }
+    file << "\n  ]\n}\n";
+    return (bool)file;
+}
+
+int Bench::compareWithBaseline(const char *filename, double threshold) {
+    std::map<std::string, double> baseline;
+    if (!readBaseline(filename, baseline))
+        return -1;
+
+    std::printf("\nComparison with %s, regression threshold %.1f%%\n", filename, threshold * 100);
+    std::printf("%-48s %14s %14s %9s\n", "benchmark", "base ns/item", "ns/item", "change");
+    int regressions = 0;
+    size_t matched = 0;
+    const std::vector<Result> &all = results();
+    for (size_t idx = 0; idx < all.size(); ++idx) {
+        std::map<std::string, double>::const_iterator base = baseline.find(all[idx].name);
+        if (base == baseline.end() || base->second <= 0)
+            continue;
+        ++matched;
+        const double change = all[idx].ns_per_item / base->second - 1;
+        const char *mark = "";
+        if (change > threshold) {
+            mark = "  REGRESSION";
+            ++regressions;
+        } else if (change < -threshold) {
+            mark = "  improvement";
+        }
+        std::printf("%-48s %14.2f %14.2f %+8.1f%%%s\n", all[idx].name.c_str(), base->second, all[idx].ns_per_item,
+                    change * 100, mark);
+    }
+    std::printf("%zu of %zu benchmarks found in baseline, %d regressions\n", matched, all.size(), regressions);
+    return regressions;
+}
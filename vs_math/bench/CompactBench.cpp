@@ -0,0 +1,267 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+const size_t BOXES = 4096;
+const size_t DIM = 3;
+
+// Boxes with random corners in [0, 10]^DIM and sides up to 3, half of them intersect the central one
+std::vector<ICompact *> createBoxes(size_t count, IMultiIndex const *grid) {
+    std::srand(42);
+    std::vector<ICompact *> boxes(count);
+    double left[DIM], right[DIM];
+    for (size_t box = 0; box < count; ++box) {
+        for (size_t idx = 0; idx < DIM; ++idx) {
+            left[idx] = 10.0 * std::rand() / RAND_MAX;
+            right[idx] = left[idx] + 3.0 * std::rand() / RAND_MAX;
+        }
+        IVector *left_vec = IVector::createVector(DIM, left);
+        IVector *right_vec = IVector::createVector(DIM, right);
+        boxes[box] = ICompact::createCompact(left_vec, right_vec, grid);
+        delete left_vec;
+        delete right_vec;
+    }
+    return boxes;
+}
+
+struct Scene {
+    IMultiIndex *grid;
+    ICompact *center;
+    std::vector<ICompact *> boxes;
+    std::vector<ICompact *> results;
+
+    Scene() {
+        size_t grid_data[DIM] = {11, 11, 11};
+        double center_left[DIM] = {3, 3, 3}, center_right[DIM] = {8, 8, 8};
+        grid = IMultiIndex::createMultiIndex(DIM, grid_data);
+        IVector *left = IVector::createVector(DIM, center_left);
+        IVector *right = IVector::createVector(DIM, center_right);
+        center = ICompact::createCompact(left, right, grid);
+        delete left;
+        delete right;
+        boxes = createBoxes(BOXES, grid);
+        results.assign(BOXES, nullptr);
+    }
+    ~Scene() {
+        for (size_t box = 0; box < boxes.size(); ++box)
+            delete boxes[box];
+        delete center;
+        delete grid;
+    }
+    double release() {
+        double created = 0;
+        for (size_t box = 0; box < results.size(); ++box) {
+            created += results[box] != nullptr;
+            delete results[box];
+            results[box] = nullptr;
+        }
+        return created;
+    }
+};
+} // namespace
+
+void CompactBench::benchIntersection() {
+    Scene scene;
+
+    Bench::measure("intersection/pairwise", BOXES, [&]() {
+        for (size_t box = 0; box < BOXES; ++box)
+            scene.results[box] = ICompact::createIntersection(scene.center, scene.boxes[box], scene.grid, 1e-9);
+        return scene.release();
+    });
+    Bench::measure("intersection/batch", BOXES, [&]() {
+        ICompact::createIntersections(scene.center, scene.boxes.data(), BOXES, scene.grid, 1e-9,
+                                      scene.results.data());
+        return scene.release();
+    });
+}
+
+void CompactBench::benchSpan() {
+    Scene scene;
+
+    Bench::measure("span/pairwise", BOXES, [&]() {
+        for (size_t box = 0; box < BOXES; ++box)
+            scene.results[box] = ICompact::createCompactSpan(scene.center, scene.boxes[box], scene.grid);
+        return scene.release();
+    });
+    Bench::measure("span/batch", BOXES, [&]() {
+        ICompact::createCompactSpans(scene.center, scene.boxes.data(), BOXES, scene.grid, scene.results.data());
+        return scene.release();
+    });
+}
+
+void CompactBench::benchIsInside() {
+    Scene scene;
+    const size_t points = 1 << 16;
+    std::vector<double> rows(points * DIM);
+    for (size_t idx = 0; idx < rows.size(); ++idx)
+        rows[idx] = 11.0 * std::rand() / RAND_MAX;
+    std::vector<uint8_t> mask((points + 7) / 8);
+    std::vector<size_t> nodes(points);
+    size_t order_data[DIM] = {0, 1, 2};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(DIM, order_data);
+    IVector *point = IVector::createVector(DIM, rows.data());
+
+    Bench::measure("isInside/single", points, [&]() {
+        double inside = 0;
+        for (size_t idx = 0; idx < points; ++idx) {
+            point->setData(DIM, rows.data() + idx * DIM);
+            inside += scene.center->isInside(point);
+        }
+        return inside;
+    });
+    Bench::measure("isInside/batch", points, [&]() {
+        scene.center->isInsideBatch(rows.data(), points, mask.data());
+        return (double)mask[0];
+    });
+    Bench::measure("isInside/batch+nearest", points, [&]() {
+        scene.center->isInsideBatch(rows.data(), points, mask.data(), order, nodes.data());
+        return (double)nodes[0];
+    });
+
+    delete point;
+    delete order;
+}
+
+void CompactBench::benchNodeCoords() {
+    // Per-node cost of random access, iterator and block generation, against dimension and nodes per axis. The last
+    // grid has more nodes per axis than fit into coordinate tables
+    const size_t shapes[][2] = {{2, 8}, {2, 128}, {2, 1024}, {4, 8}, {4, 32}, {6, 4}, {6, 10}, {1, 1 << 17}};
+    const size_t tile = 1024;
+    std::vector<double> block;
+    char name[64];
+
+    for (size_t shape = 0; shape < sizeof(shapes) / sizeof(shapes[0]); ++shape) {
+        const size_t dim = shapes[shape][0], nodes = shapes[shape][1];
+        std::vector<double> left(dim, -1.0), right(dim, 1.0);
+        std::vector<size_t> grid_data(dim, nodes), order_data(dim), index_data(dim, 0);
+        for (size_t idx = 0; idx < dim; ++idx)
+            order_data[idx] = idx;
+        IVector *left_vec = IVector::createVector(dim, left.data());
+        IVector *right_vec = IVector::createVector(dim, right.data());
+        IMultiIndex *grid = IMultiIndex::createMultiIndex(dim, grid_data.data());
+        IMultiIndex *order = IMultiIndex::createMultiIndex(dim, order_data.data());
+        IMultiIndex *index = IMultiIndex::createMultiIndex(dim, index_data.data());
+        ICompact *com = ICompact::createCompact(left_vec, right_vec, grid);
+        IVector *val = IVector::createVector(dim, left.data());
+        const size_t count = com->getNodesCount();
+        block.resize(tile * dim);
+
+        std::snprintf(name, sizeof(name), "nodes/getVectorCoords d=%zu n=%zu", dim, nodes);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            for (size_t node = 0; node < count; ++node) {
+                com->fromLinear(node, order, index);
+                com->getVectorCoords(index, val);
+                acc += val->getData()[0];
+            }
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "nodes/getNode d=%zu n=%zu", dim, nodes);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            for (size_t node = 0; node < count; ++node) {
+                com->getNode(node, order, block.data());
+                acc += block[0];
+            }
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "nodes/iterator d=%zu n=%zu", dim, nodes);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            ICompact::IIterator *iter = com->getBegin(order);
+            for (; iter->isValid(); iter->next()) {
+                iter->getVectorCoords(block.data(), dim);
+                acc += block[0];
+            }
+            delete iter;
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "nodes/generateNodes d=%zu n=%zu", dim, nodes);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            for (size_t start = 0; start < count; start += tile) {
+                com->generateNodes(start, std::min(tile, count - start), order, block.data());
+                acc += block[0];
+            }
+            return acc;
+        });
+
+        delete val;
+        delete com;
+        delete index;
+        delete order;
+        delete grid;
+        delete right_vec;
+        delete left_vec;
+    }
+}
+
+void CompactBench::benchTraversal() {
+    // 7-point stencil over field of n^3 doubles, compact spans [0, n - 1] along axes, so coordinates are positions
+    const size_t n = 160, dim = 3;
+    std::vector<double> field(n * n * n);
+    for (size_t idx = 0; idx < field.size(); ++idx)
+        field[idx] = (double)(idx % 17);
+    std::vector<double> left(dim, 0.0), right(dim, (double)(n - 1));
+    std::vector<size_t> grid_data(dim, n), order_data(dim), tile_data(dim, 16);
+    for (size_t idx = 0; idx < dim; ++idx)
+        order_data[idx] = idx;
+    IVector *left_vec = IVector::createVector(dim, left.data());
+    IVector *right_vec = IVector::createVector(dim, right.data());
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(dim, grid_data.data());
+    IMultiIndex *order = IMultiIndex::createMultiIndex(dim, order_data.data());
+    IMultiIndex *tile = IMultiIndex::createMultiIndex(dim, tile_data.data());
+    ICompact *com = ICompact::createCompact(left_vec, right_vec, grid);
+
+    const struct {
+        const char *name;
+        ICompact::TRAVERSAL traversal;
+    } orders[] = {{"traversal/stencil lexicographic", ICompact::TRAVERSAL::LEXICOGRAPHIC},
+                  {"traversal/stencil tiled 16^3", ICompact::TRAVERSAL::TILED},
+                  {"traversal/stencil morton", ICompact::TRAVERSAL::MORTON},
+                  {"traversal/stencil hilbert", ICompact::TRAVERSAL::HILBERT}};
+    const size_t stride[] = {1, n, n * n};
+    for (size_t kind = 0; kind < sizeof(orders) / sizeof(orders[0]); ++kind) {
+        Bench::measure(orders[kind].name, com->getNodesCount(), [&]() {
+            double acc = 0, coords[3];
+            ICompact::IIterator *iter = com->getBegin(order, orders[kind].traversal, tile);
+            for (; iter->isValid(); iter->next()) {
+                iter->getVectorCoords(coords, dim);
+                size_t center = 0;
+                for (size_t axis = 0; axis < dim; ++axis)
+                    center += (size_t)coords[axis] * stride[axis];
+                double value = -6.0 * field[center];
+                for (size_t axis = 0; axis < dim; ++axis) {
+                    size_t pos = (size_t)coords[axis];
+                    value += field[pos > 0 ? center - stride[axis] : center];
+                    value += field[pos + 1 < n ? center + stride[axis] : center];
+                }
+                acc += value;
+            }
+            delete iter;
+            return acc;
+        });
+    }
+
+    delete com;
+    delete tile;
+    delete order;
+    delete grid;
+    delete right_vec;
+    delete left_vec;
+}
+
+void CompactBench::benchAll() {
+    std::cout << "Running all Compact benchmarks" << std::endl;
+
+    benchIntersection();
+    benchSpan();
+    benchIsInside();
+    benchNodeCoords();
+    benchTraversal();
+
+    std::cout << "Finished all Compact benchmarks" << std::endl;
+}
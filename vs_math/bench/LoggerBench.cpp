@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <iostream>
+
+namespace {
+const char *const LOG_FILE = "logger_bench.log";
+const size_t RECORDS = 1 << 14;
+} // namespace
+
+void LoggerBench::benchLog() {
+    // Cost of call as seen by caller, async logger formats and writes on background thread
+    ILogger *sync = ILogger::createLogger(LOG_FILE);
+    Bench::measure("log/sync file", RECORDS, [&]() {
+        for (size_t idx = 0; idx < RECORDS; ++idx)
+            sync->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return 1.0;
+    });
+    delete sync;
+
+    const struct {
+        const char *name;
+        ILogger::Overflow policy;
+    } policies[] = {{"log/async file drop", ILogger::Overflow::DROP},
+                    {"log/async file block", ILogger::Overflow::BLOCK}};
+    for (size_t kind = 0; kind < sizeof(policies) / sizeof(policies[0]); ++kind) {
+        ILogger *async = ILogger::createAsyncLogger(LOG_FILE, true, RECORDS, policies[kind].policy);
+        Bench::measure(policies[kind].name, RECORDS, [&]() {
+            for (size_t idx = 0; idx < RECORDS; ++idx)
+                async->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+            return 1.0;
+        });
+        delete async;
+    }
+
+    ILogger *binary = ILogger::createBinaryLogger(LOG_FILE);
+    Bench::measure("log/binary file", RECORDS, [&]() {
+        for (size_t idx = 0; idx < RECORDS; ++idx)
+            binary->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return 1.0;
+    });
+
+    ILogger *thread_safe = ILogger::createThreadSafeLogger(binary);
+    Bench::measure("log/thread-safe binary file", RECORDS, [&]() {
+        for (size_t idx = 0; idx < RECORDS; ++idx)
+            thread_safe->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return 1.0;
+    });
+    delete thread_safe;
+    delete binary;
+
+    // Repeated call site, only the first record reaches synchronous logger
+    ILogger *file_logger = ILogger::createLogger(LOG_FILE);
+    ILogger *limited = ILogger::createRateLimitedLogger(file_logger, 3600.0);
+    Bench::measure("log/rate limited repeated", RECORDS, [&]() {
+        for (size_t idx = 0; idx < RECORDS; ++idx)
+            limited->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        return 1.0;
+    });
+    delete limited;
+    delete file_logger;
+    std::remove(LOG_FILE);
+}
+
+void LoggerBench::benchAll() {
+    std::cout << "Running all Logger benchmarks" << std::endl;
+
+    benchLog();
+
+    std::cout << "Finished all Logger benchmarks" << std::endl;
+}
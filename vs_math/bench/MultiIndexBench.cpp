@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include <iostream>
+#include <vector>
+
+void MultiIndexBench::benchIncrement() {
+    // Odometer walk over n^d indices, as done by grid iterators: the fastest axis is incremented, overflowing axes
+    // are reset and carry into the next one
+    const size_t shapes[][2] = {{2, 256}, {4, 16}, {8, 4}};
+    char name[64];
+    for (size_t shape = 0; shape < sizeof(shapes) / sizeof(shapes[0]); ++shape) {
+        const size_t dim = shapes[shape][0], nodes = shapes[shape][1];
+        size_t count = 1;
+        for (size_t axis = 0; axis < dim; ++axis)
+            count *= nodes;
+        std::vector<size_t> zeros(dim, 0);
+        IMultiIndex *index = IMultiIndex::createMultiIndex(dim, zeros.data());
+
+        std::snprintf(name, sizeof(name), "multiindex/incAxisIndex d=%zu n=%zu", dim, nodes);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            index->setData(dim, zeros.data());
+            for (size_t step = 0; step < count; ++step) {
+                size_t axis = 0, val = 0;
+                index->incAxisIndex(axis, 1);
+                while (index->getAxisIndex(axis, val) == RC::SUCCESS && val == nodes && axis + 1 < dim) {
+                    index->setAxisIndex(axis, 0);
+                    index->incAxisIndex(++axis, 1);
+                }
+                acc += val;
+            }
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "multiindex/clone d=%zu", dim);
+        Bench::measure(name, count, [&]() {
+            double acc = 0;
+            for (size_t step = 0; step < count; ++step) {
+                IMultiIndex *copy = index->clone();
+                acc += copy->getData()[0];
+                delete copy;
+            }
+            return acc;
+        });
+
+        delete index;
+    }
+}
+
+void MultiIndexBench::benchAll() {
+    std::cout << "Running all MultiIndex benchmarks" << std::endl;
+
+    benchIncrement();
+
+    std::cout << "Finished all MultiIndex benchmarks" << std::endl;
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char *const EVENT_NAMES[] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == Bench::PerfCounters::EVENTS,
+              "Every event must have a name");
+
+#ifdef __linux__
+const uint64_t EVENT_CONFIGS[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+                                  PERF_COUNT_HW_BRANCH_MISSES};
+
+int openEvent(uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group == -1 ? 1 : 0; // group is enabled and disabled through its leader
+    attr.exclude_kernel = 1;             // allowed with perf_event_paranoid up to 2
+    attr.exclude_hv = 1;
+    attr.inherit = 1;                    // threads started after opening, as workers of pools, are counted too
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+// Value of event scaled up if kernel multiplexed counters and event was counting only part of the time
+double readEvent(int fd) {
+    uint64_t values[3] = {0, 0, 0}; // value, time enabled, time running
+    if (read(fd, values, sizeof(values)) != (ssize_t)sizeof(values) || values[2] == 0)
+        return -1;
+    return (double)values[0] * ((double)values[1] / (double)values[2]);
+}
+#endif
+} // namespace
+
+const char *Bench::PerfCounters::getName(Event event) { return EVENT_NAMES[event]; }
+
+Bench::PerfCounters &Bench::PerfCounters::instance() {
+    static PerfCounters counters;
+    return counters;
+}
+
+Bench::PerfCounters::PerfCounters() : available(false) {
+    for (size_t event = 0; event < EVENTS; ++event)
+        fds[event] = -1;
+#ifdef __linux__
+    // Events are opened as one group, so they count exactly the same instructions. Cycles lead the group, without
+    // them nothing is collected, other events may be missing on some CPUs and virtual machines
+    fds[CYCLES] = openEvent(EVENT_CONFIGS[CYCLES], -1);
+    if (fds[CYCLES] < 0) {
+        reason = std::strerror(errno);
+        return;
+    }
+    for (size_t event = CYCLES + 1; event < EVENTS; ++event)
+        fds[event] = openEvent(EVENT_CONFIGS[event], fds[CYCLES]);
+    available = true;
+#else
+    reason = "perf_event_open is supported on Linux only";
+#endif
+}
+
+Bench::PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (size_t event = EVENTS; event-- > 0;)
+        if (fds[event] >= 0)
+            close(fds[event]);
+#endif
+}
+
+void Bench::PerfCounters::start() {
+#ifdef __linux__
+    if (!available)
+        return;
+    ioctl(fds[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void Bench::PerfCounters::stop(double *values) {
+    for (size_t event = 0; event < EVENTS; ++event)
+        values[event] = -1;
+#ifdef __linux__
+    if (!available)
+        return;
+    ioctl(fds[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (size_t event = 0; event < EVENTS; ++event)
+        if (fds[event] >= 0)
+            values[event] = readEvent(fds[event]);
+#endif
+}
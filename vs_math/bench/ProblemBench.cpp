@@ -0,0 +1,196 @@
+#include "AutoDiff.h"
+#include "ProblemKernel.h"
+#include "bench.hpp"
+#include "tests.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+// Extended Rosenbrock of dim args for any type of numbers
+struct Rosenbrock {
+    size_t dim;
+
+    template <class T>
+    T operator()(T const *x, T const *) const {
+        T sum = 0;
+        for (size_t axis = 0; axis + 1 < dim; ++axis) {
+            const T valley = x[axis + 1] - x[axis] * x[axis], shift = 1 - x[axis];
+            sum += 100 * valley * valley + shift * shift;
+        }
+        return sum;
+    }
+};
+} // namespace
+
+void ProblemBench::benchEval() {
+    // Same quadratic form evaluated point by point through IVector, by batch of kernel in one thread and by all threads
+    const size_t dims[] = {2, 8}, n = 1 << 16;
+    char name[64];
+    for (size_t idx = 0; idx < sizeof(dims) / sizeof(dims[0]); ++idx) {
+        const size_t dim = dims[idx];
+        auto f = [dim](double const *x, double const *p) {
+            double sum = 0;
+            for (size_t axis = 0; axis < dim; ++axis)
+                sum += p[0] * x[axis] * x[axis] + p[1] * x[axis];
+            return sum;
+        };
+        ICompact *args = createBox(dim, -1, 1, 2), *params = createBox(2, -10, 10, 2);
+        IProblem *problem = IProblem::createProblem(params, args, ProblemKernel::make(f));
+        double p_data[] = {2, -1};
+        IVector *p = IVector::createVector(2, p_data);
+        problem->setParams(p);
+        std::vector<double> rows(n * dim), out(n);
+        for (size_t coord = 0; coord < rows.size(); ++coord)
+            rows[coord] = std::sin((double)coord);
+        IVector *x = IVector::createVector(dim, rows.data());
+
+        std::snprintf(name, sizeof(name), "problem/evalByArgs d=%zu", dim);
+        Bench::measure(name, n, [&]() {
+            double acc = 0;
+            for (size_t row = 0; row < n; ++row) {
+                x->setData(dim, rows.data() + row * dim);
+                acc += problem->evalByArgs(x);
+            }
+            return acc;
+        });
+        problem->setThreads(1);
+        std::snprintf(name, sizeof(name), "problem/evalByArgsBatch d=%zu threads=1", dim);
+        Bench::measure(name, n, [&]() {
+            problem->evalByArgsBatch(rows.data(), n, out.data());
+            return out[n - 1];
+        });
+        problem->setThreads(0);
+        std::snprintf(name, sizeof(name), "problem/evalByArgsBatch d=%zu threads=all", dim);
+        Bench::measure(name, n, [&]() {
+            problem->evalByArgsBatch(rows.data(), n, out.data());
+            return out[n - 1];
+        });
+
+        delete x;
+        delete p;
+        delete problem;
+        delete args;
+        delete params;
+    }
+}
+
+void ProblemBench::benchGradient() {
+    // Finite differences cost 2 * d evaluations per gradient, exact gradient of kernel is a single call
+    const size_t dim = 8, n = 1 << 12;
+    auto f = [](double const *x, double const *) {
+        double sum = 0;
+        for (size_t axis = 0; axis < dim; ++axis)
+            sum += x[axis] * x[axis];
+        return sum;
+    };
+    auto grad = [](double const *x, double const *, double *g) {
+        for (size_t axis = 0; axis < dim; ++axis)
+            g[axis] = 2 * x[axis];
+    };
+    auto exact = ProblemKernel::withGradient(f, grad);
+    ICompact *args = createBox(dim, -1, 1, 2);
+    IDiffProblem *differences = IDiffProblem::createDiffProblem(nullptr, args, ProblemKernel::make(f));
+    IDiffProblem *with_gradient = IDiffProblem::createDiffProblem(nullptr, args, exact.kernel());
+    std::vector<double> rows(n * dim);
+    for (size_t coord = 0; coord < rows.size(); ++coord)
+        rows[coord] = std::sin((double)coord);
+    IVector *x = IVector::createVector(dim, rows.data());
+    IVector *g = IVector::createVector(dim, rows.data());
+
+    const struct {
+        const char *name;
+        IDiffProblem *problem;
+    } cases[] = {{"problem/evalGradientByArgs d=8 differences", differences},
+                 {"problem/evalGradientByArgs d=8 exact", with_gradient}};
+    for (size_t idx = 0; idx < sizeof(cases) / sizeof(cases[0]); ++idx) {
+        IDiffProblem *problem = cases[idx].problem;
+        Bench::measure(cases[idx].name, n, [&]() {
+            double acc = 0;
+            for (size_t row = 0; row < n; ++row) {
+                x->setData(dim, rows.data() + row * dim);
+                problem->evalGradientByArgs(x, g);
+                acc += g->getData()[0];
+            }
+            return acc;
+        });
+    }
+
+    delete g;
+    delete x;
+    delete with_gradient;
+    delete differences;
+    delete args;
+}
+
+void ProblemBench::benchAutoDiff() {
+    // Gradient by finite differences costs 2 * d evaluations, by reverse mode one evaluation recording tape and one
+    // sweep back. Mixed derivative by differences needs prod(orders + 1) evaluations, by forward mode one evaluation
+    // over Taylor coefficients
+    const size_t dims[] = {8, 32};
+    const size_t n = 1 << 8;
+    char name[96];
+    for (size_t idx = 0; idx < sizeof(dims) / sizeof(dims[0]); ++idx) {
+        const size_t dim = dims[idx];
+        Rosenbrock f = {dim};
+        auto plain = [&f](double const *x, double const *p) { return f(x, p); };
+        ICompact *args = createBox(dim, -1, 1, 2);
+        IDiffProblem *differences = IDiffProblem::createDiffProblem(nullptr, args, ProblemKernel::make(plain));
+        IDiffProblem *autodiff = IDiffProblem::createDiffProblem(nullptr, args, AutoDiff::kernel(f));
+        std::vector<double> rows(n * dim);
+        for (size_t coord = 0; coord < rows.size(); ++coord)
+            rows[coord] = std::sin((double)coord);
+        IVector *x = IVector::createVector(dim, rows.data());
+        IVector *g = IVector::createVector(dim, rows.data());
+        std::vector<size_t> orders(dim, 0);
+        orders[0] = 2;
+        orders[1] = 1;
+        IMultiIndex *index = IMultiIndex::createMultiIndex(dim, orders.data());
+
+        const struct {
+            const char *method;
+            IDiffProblem *problem;
+        } cases[] = {{"differences", differences}, {"autodiff", autodiff}};
+        for (size_t method = 0; method < sizeof(cases) / sizeof(cases[0]); ++method) {
+            IDiffProblem *problem = cases[method].problem;
+            std::snprintf(name, sizeof(name), "problem/evalGradientByArgs rosenbrock d=%zu %s", dim,
+                          cases[method].method);
+            Bench::measure(name, n, [&]() {
+                double acc = 0;
+                for (size_t row = 0; row < n; ++row) {
+                    x->setData(dim, rows.data() + row * dim);
+                    problem->evalGradientByArgs(x, g);
+                    acc += g->getData()[0];
+                }
+                return acc;
+            });
+            std::snprintf(name, sizeof(name), "problem/evalDerivativeByArgs (2, 1) rosenbrock d=%zu %s", dim,
+                          cases[method].method);
+            Bench::measure(name, n, [&]() {
+                double acc = 0;
+                for (size_t row = 0; row < n; ++row) {
+                    x->setData(dim, rows.data() + row * dim);
+                    acc += problem->evalDerivativeByArgs(x, index);
+                }
+                return acc;
+            });
+        }
+
+        delete index;
+        delete g;
+        delete x;
+        delete autodiff;
+        delete differences;
+        delete args;
+    }
+}
+
+void ProblemBench::benchAll() {
+    std::cout << "Running all Problem benchmarks" << std::endl;
+
+    benchEval();
+    benchGradient();
+    benchAutoDiff();
+
+    std::cout << "Finished all Problem benchmarks" << std::endl;
+}
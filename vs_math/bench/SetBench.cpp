@@ -0,0 +1,148 @@
+#include "bench.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+const size_t SIZES[] = {16, 128, 512};
+const size_t DIMS[] = {2, 16};
+const double TOL = 1e-9;
+// Patterns searched by one run of find benchmarks, every second one is absent from set
+const size_t PATTERNS = 64;
+
+// Distinct vectors, vectors with indices from first to first + count - 1 of the same sequence
+std::vector<IVector *> createVectors(size_t first, size_t count, size_t dim) {
+    std::vector<IVector *> vectors(count);
+    std::vector<double> data(dim);
+    for (size_t vec = 0; vec < count; ++vec) {
+        for (size_t idx = 0; idx < dim; ++idx)
+            data[idx] = (double)((first + vec) * dim + idx) * 0.5;
+        vectors[vec] = IVector::createVector(dim, data.data());
+    }
+    return vectors;
+}
+
+void destroy(std::vector<IVector *> &vectors) {
+    for (size_t vec = 0; vec < vectors.size(); ++vec)
+        delete vectors[vec];
+    vectors.clear();
+}
+
+ISet *createSet(const std::vector<IVector *> &vectors) {
+    ISet *set = ISet::createSet();
+    for (size_t vec = 0; vec < vectors.size(); ++vec)
+        set->insert(vectors[vec], IVector::NORM::SECOND, TOL);
+    return set;
+}
+} // namespace
+
+void SetBench::benchInsert() {
+    char name[64];
+    for (size_t dim_kind = 0; dim_kind < sizeof(DIMS) / sizeof(DIMS[0]); ++dim_kind) {
+        for (size_t size_kind = 0; size_kind < sizeof(SIZES) / sizeof(SIZES[0]); ++size_kind) {
+            const size_t dim = DIMS[dim_kind], size = SIZES[size_kind];
+            std::vector<IVector *> vectors = createVectors(0, size, dim);
+
+            // Every insert scans the set for duplicate, so cost per vector grows with size
+            std::snprintf(name, sizeof(name), "set/insert n=%zu d=%zu", size, dim);
+            Bench::measure(name, size, [&]() {
+                ISet *set = createSet(vectors);
+                double inserted = (double)set->getSize();
+                delete set;
+                return inserted;
+            });
+            destroy(vectors);
+        }
+    }
+}
+
+void SetBench::benchFind() {
+    char name[64];
+    for (size_t dim_kind = 0; dim_kind < sizeof(DIMS) / sizeof(DIMS[0]); ++dim_kind) {
+        for (size_t size_kind = 0; size_kind < sizeof(SIZES) / sizeof(SIZES[0]); ++size_kind) {
+            const size_t dim = DIMS[dim_kind], size = SIZES[size_kind];
+            std::vector<IVector *> vectors = createVectors(0, size, dim);
+            ISet *set = createSet(vectors);
+            std::vector<IVector *> patterns = createVectors(size, PATTERNS, dim);
+            for (size_t pat = 0; pat < PATTERNS; pat += 2)
+                patterns[pat]->setData(dim, vectors[pat * 7919 % size]->getData());
+            IVector *found = IVector::createVector(dim, vectors[0]->getData());
+
+            std::snprintf(name, sizeof(name), "set/findFirst n=%zu d=%zu", size, dim);
+            Bench::measure(name, PATTERNS, [&]() {
+                double hits = 0;
+                for (size_t pat = 0; pat < PATTERNS; ++pat)
+                    hits += set->findFirst(patterns[pat], IVector::NORM::SECOND, TOL) == RC::SUCCESS;
+                return hits;
+            });
+            std::snprintf(name, sizeof(name), "set/findFirstAndCopyCoords n=%zu d=%zu", size, dim);
+            Bench::measure(name, PATTERNS, [&]() {
+                double hits = 0;
+                for (size_t pat = 0; pat < PATTERNS; ++pat)
+                    hits += set->findFirstAndCopyCoords(patterns[pat], IVector::NORM::SECOND, TOL, found) ==
+                            RC::SUCCESS;
+                return hits;
+            });
+            std::snprintf(name, sizeof(name), "set/iterate n=%zu d=%zu", size, dim);
+            Bench::measure(name, size, [&]() {
+                double acc = 0;
+                ISet::IIterator *iter = set->getBegin();
+                for (; iter->isValid(); iter->next()) {
+                    iter->getVectorCoords(found);
+                    acc += found->getData()[0];
+                }
+                delete iter;
+                return acc;
+            });
+
+            delete found;
+            destroy(patterns);
+            delete set;
+            destroy(vectors);
+        }
+    }
+}
+
+void SetBench::benchAlgebra() {
+    char name[64];
+    for (size_t dim_kind = 0; dim_kind < sizeof(DIMS) / sizeof(DIMS[0]); ++dim_kind) {
+        for (size_t size_kind = 0; size_kind < sizeof(SIZES) / sizeof(SIZES[0]); ++size_kind) {
+            const size_t dim = DIMS[dim_kind], size = SIZES[size_kind];
+            // Operands share half of their vectors
+            std::vector<IVector *> vectors1 = createVectors(0, size, dim);
+            std::vector<IVector *> vectors2 = createVectors(size / 2, size, dim);
+            ISet *set1 = createSet(vectors1), *set2 = createSet(vectors2);
+
+            const struct {
+                const char *name;
+                ISet *(*op)(ISet const *const &, ISet const *const &, IVector::NORM, double);
+            } ops[] = {{"makeUnion", ISet::makeUnion},
+                       {"makeIntersection", ISet::makeIntersection},
+                       {"sub", ISet::sub},
+                       {"symSub", ISet::symSub}};
+            for (size_t op = 0; op < sizeof(ops) / sizeof(ops[0]); ++op) {
+                std::snprintf(name, sizeof(name), "set/%s n=%zu d=%zu", ops[op].name, size, dim);
+                Bench::measure(name, 2 * size, [&]() {
+                    ISet *result = ops[op].op(set1, set2, IVector::NORM::SECOND, TOL);
+                    double result_size = result == nullptr ? 0 : (double)result->getSize();
+                    delete result;
+                    return result_size;
+                });
+            }
+
+            delete set1;
+            delete set2;
+            destroy(vectors1);
+            destroy(vectors2);
+        }
+    }
+}
+
+void SetBench::benchAll() {
+    std::cout << "Running all Set benchmarks" << std::endl;
+
+    benchInsert();
+    benchFind();
+    benchAlgebra();
+
+    std::cout << "Finished all Set benchmarks" << std::endl;
+}
@@ -0,0 +1,208 @@
+#include "ISolver.h"
+#include "ProblemKernel.h"
+#include "bench.hpp"
+#include "tests.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+const double PI = 3.14159265358979323846;
+
+// Rastrigin: 10 * d + sum of x[i]^2 - 10 * cos(2 * pi * x[i]), local solvers stop at the nearest of many minima
+double rastrigin(double const *x, size_t dim) {
+    double sum = 10 * (double)dim;
+    for (size_t axis = 0; axis < dim; ++axis)
+        sum += x[axis] * x[axis] - 10 * std::cos(2 * PI * x[axis]);
+    return sum;
+}
+void rastriginGradient(double const *x, size_t dim, double *g) {
+    for (size_t axis = 0; axis < dim; ++axis)
+        g[axis] = 2 * x[axis] + 20 * PI * std::sin(2 * PI * x[axis]);
+}
+
+/*
+ * Measures solve from init by every method and line search: time per iteration goes to report, convergence (iterations,
+ * values and gradients evaluated, reached value) is printed below it
+ */
+void benchFunction(const char *function, IDiffProblem *problem, ICompact *box, double const *init) {
+    const ISolver::Method methods[] = {ISolver::Method::GRADIENT_DESCENT, ISolver::Method::BFGS,
+                                       ISolver::Method::LBFGS};
+    const char *method_names[] = {"gd", "bfgs", "lbfgs"};
+    const ISolver::LineSearch searches[] = {ISolver::LineSearch::ARMIJO, ISolver::LineSearch::WOLFE};
+    const char *search_names[] = {"armijo", "wolfe"};
+    const size_t dim = problem->getArgsDim();
+    IVector *start = IVector::createVector(dim, init);
+    char name[96];
+    for (size_t method = 0; method < sizeof(methods) / sizeof(methods[0]); ++method) {
+        for (size_t search = 0; search < sizeof(searches) / sizeof(searches[0]); ++search) {
+            ISolver::Options options;
+            options.method = methods[method];
+            options.lineSearch = searches[search];
+            options.maxIterations = 20000;
+            ISolver *solver = ISolver::createSolver(options);
+            solver->setProblem(problem);
+            solver->setArgsDomain(box);
+
+            std::snprintf(name, sizeof(name), "solver/%s d=%zu %s %s", function, dim, method_names[method],
+                          search_names[search]);
+            solver->solveByArgs(start, nullptr);
+            const ISolver::Summary summary = solver->getSummary();
+            const double ns = Bench::measure(name, summary.iterations, [&]() {
+                solver->solveByArgs(start, nullptr);
+                return solver->getSummary().value;
+            });
+            if (ns > 0)
+                std::printf("    %zu iterations, %zu values, %zu gradients, f = %.3e, %s\n", summary.iterations,
+                            summary.evaluations, summary.gradients, summary.value,
+                            summary.converged ? "converged" : "not converged");
+            delete solver;
+        }
+    }
+    delete start;
+}
+} // namespace
+
+void SolverBench::benchRosenbrock() {
+    // Extended Rosenbrock: sum of 100 * (x[i + 1] - x[i]^2)^2 + (1 - x[i])^2, narrow curved valley towards (1, ..., 1)
+    const size_t dims[] = {2, 16};
+    for (size_t idx = 0; idx < sizeof(dims) / sizeof(dims[0]); ++idx) {
+        const size_t dim = dims[idx];
+        auto f = [dim](double const *x, double const *) {
+            double sum = 0;
+            for (size_t axis = 0; axis + 1 < dim; ++axis) {
+                const double valley = x[axis + 1] - x[axis] * x[axis], shift = 1 - x[axis];
+                sum += 100 * valley * valley + shift * shift;
+            }
+            return sum;
+        };
+        auto grad = [dim](double const *x, double const *, double *g) {
+            for (size_t axis = 0; axis < dim; ++axis)
+                g[axis] = 0;
+            for (size_t axis = 0; axis + 1 < dim; ++axis) {
+                const double valley = x[axis + 1] - x[axis] * x[axis];
+                g[axis] += -400 * x[axis] * valley - 2 * (1 - x[axis]);
+                g[axis + 1] += 200 * valley;
+            }
+        };
+        auto exact = ProblemKernel::withGradient(f, grad);
+        ICompact *box = createBox(dim, -5, 5, 2);
+        IDiffProblem *problem = IDiffProblem::createDiffProblem(nullptr, box, exact.kernel());
+        std::vector<double> init(dim);
+        for (size_t axis = 0; axis < dim; ++axis)
+            init[axis] = axis % 2 == 0 ? -1.2 : 1;
+        benchFunction("rosenbrock", problem, box, init.data());
+        delete problem;
+        delete box;
+    }
+}
+
+void SolverBench::benchRastrigin() {
+    const size_t dims[] = {2, 16};
+    for (size_t idx = 0; idx < sizeof(dims) / sizeof(dims[0]); ++idx) {
+        const size_t dim = dims[idx];
+        auto f = [dim](double const *x, double const *) { return rastrigin(x, dim); };
+        auto grad = [dim](double const *x, double const *, double *g) { rastriginGradient(x, dim, g); };
+        auto exact = ProblemKernel::withGradient(f, grad);
+        ICompact *box = createBox(dim, -5.12, 5.12, 2);
+        IDiffProblem *problem = IDiffProblem::createDiffProblem(nullptr, box, exact.kernel());
+        std::vector<double> init(dim, 2.3);
+        benchFunction("rastrigin", problem, box, init.data());
+        delete problem;
+        delete box;
+    }
+}
+
+void SolverBench::benchMultiStart() {
+    // Rastrigin from every node of 11 x 11 grid and from Halton points in 4-D box, by one thread and by all of them:
+    // time per local solve goes to report, distinct optima and the best value are printed below it
+    const struct {
+        size_t dim;
+        ISolver::Seeds seeds;
+        const char *seeds_name;
+    } cases[] = {{2, ISolver::Seeds::GRID, "grid"}, {4, ISolver::Seeds::HALTON, "halton"}};
+    char name[96];
+    for (size_t idx = 0; idx < sizeof(cases) / sizeof(cases[0]); ++idx) {
+        const size_t dim = cases[idx].dim;
+        auto f = [dim](double const *x, double const *) { return rastrigin(x, dim); };
+        auto grad = [dim](double const *x, double const *, double *g) { rastriginGradient(x, dim, g); };
+        auto exact = ProblemKernel::withGradient(f, grad);
+        ICompact *box = createBox(dim, -5.12, 5.12, 11);
+        IDiffProblem *problem = IDiffProblem::createDiffProblem(nullptr, box, exact.kernel());
+        for (size_t threads = 1; threads <= 2; ++threads) {
+            ISolver::Options options;
+            options.seeds = cases[idx].seeds;
+            options.seedsCount = 256;
+            options.threads = threads == 1 ? 1 : 0;
+            ISolver *solver = ISolver::createSolver(options);
+            solver->setProblem(problem);
+            solver->setArgsDomain(box);
+
+            std::snprintf(name, sizeof(name), "solver/multistart rastrigin d=%zu %s threads=%s", dim,
+                          cases[idx].seeds_name, threads == 1 ? "1" : "all");
+            solver->solveByArgs(nullptr, nullptr);
+            const ISolver::Summary summary = solver->getSummary();
+            const double ns = Bench::measure(name, summary.starts, [&]() {
+                solver->solveByArgs(nullptr, nullptr);
+                return solver->getSummary().value;
+            });
+            ISet *optima = nullptr;
+            solver->getOptima(optima);
+            if (ns > 0 && optima != nullptr)
+                std::printf("    %zu starts, %zu iterations, %zu optima, f = %.3e\n", summary.starts,
+                            summary.iterations, optima->getSize(), summary.value);
+            delete optima;
+            delete solver;
+        }
+        delete problem;
+        delete box;
+    }
+}
+
+void SolverBench::benchGrid() {
+    // Rastrigin by grid search: fine grid at once by one thread and by all of them, then coarse grid with refinements
+    // around the best nodes. Time per node goes to report, the best value is printed below it
+    const struct {
+        size_t dim, nodes, levels;
+    } cases[] = {{2, 301, 0}, {4, 21, 0}, {2, 21, 10}, {4, 9, 10}};
+    char name[96];
+    for (size_t idx = 0; idx < sizeof(cases) / sizeof(cases[0]); ++idx) {
+        const size_t dim = cases[idx].dim;
+        auto f = [dim](double const *x, double const *) { return rastrigin(x, dim); };
+        ICompact *box = createBox(dim, -5.12, 5.12, cases[idx].nodes);
+        IProblem *problem = IProblem::createProblem(nullptr, box, ProblemKernel::make(f));
+        for (size_t threads = 1; threads <= 2; ++threads) {
+            ISolver::GridOptions options;
+            options.levels = cases[idx].levels;
+            options.threads = threads == 1 ? 1 : 0;
+            ISolver *solver = ISolver::createGridSolver(options);
+            solver->setProblem(problem);
+            solver->setArgsDomain(box);
+
+            std::snprintf(name, sizeof(name), "solver/grid rastrigin d=%zu nodes=%zu levels=%zu threads=%s", dim,
+                          cases[idx].nodes, cases[idx].levels, threads == 1 ? "1" : "all");
+            solver->solveByArgs(nullptr, nullptr);
+            const ISolver::Summary summary = solver->getSummary();
+            const double ns = Bench::measure(name, summary.evaluations, [&]() {
+                solver->solveByArgs(nullptr, nullptr);
+                return solver->getSummary().value;
+            });
+            if (ns > 0)
+                std::printf("    %zu nodes, f = %.3e\n", summary.evaluations, summary.value);
+            delete solver;
+        }
+        delete problem;
+        delete box;
+    }
+}
+
+void SolverBench::benchAll() {
+    std::cout << "Running all Solver benchmarks" << std::endl;
+
+    benchRosenbrock();
+    benchRastrigin();
+    benchMultiStart();
+    benchGrid();
+
+    std::cout << "Finished all Solver benchmarks" << std::endl;
+}
@@ -0,0 +1,124 @@
+#include "bench.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+const size_t DIMS[] = {2, 16, 128, 1024};
+// Vectors processed by one run, so that runs of small dimensions aren't dominated by timer overhead
+const size_t VECTORS = 256;
+
+struct Operands {
+    std::vector<IVector *> lhs, rhs;
+
+    explicit Operands(size_t dim) {
+        std::vector<double> data(dim);
+        for (size_t vec = 0; vec < VECTORS; ++vec) {
+            for (size_t idx = 0; idx < dim; ++idx)
+                data[idx] = (double)((vec + idx) % 13) - 6.0;
+            lhs.push_back(IVector::createVector(dim, data.data()));
+            for (size_t idx = 0; idx < dim; ++idx)
+                data[idx] += 1e-3;
+            rhs.push_back(IVector::createVector(dim, data.data()));
+        }
+    }
+    ~Operands() {
+        for (size_t vec = 0; vec < VECTORS; ++vec) {
+            delete lhs[vec];
+            delete rhs[vec];
+        }
+    }
+};
+} // namespace
+
+void VectorBench::benchArithmetic() {
+    char name[64];
+    for (size_t kind = 0; kind < sizeof(DIMS) / sizeof(DIMS[0]); ++kind) {
+        const size_t dim = DIMS[kind];
+        Operands ops(dim);
+
+        // add allocates result, inc works in place
+        std::snprintf(name, sizeof(name), "vector/add d=%zu", dim);
+        Bench::measure(name, VECTORS * dim, [&]() {
+            double acc = 0;
+            for (size_t vec = 0; vec < VECTORS; ++vec) {
+                IVector *sum = IVector::add(ops.lhs[vec], ops.rhs[vec]);
+                acc += sum->getData()[0];
+                delete sum;
+            }
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "vector/inc+dec d=%zu", dim);
+        Bench::measure(name, VECTORS * dim, [&]() {
+            for (size_t vec = 0; vec < VECTORS; ++vec) {
+                ops.lhs[vec]->inc(ops.rhs[vec]);
+                ops.lhs[vec]->dec(ops.rhs[vec]);
+            }
+            return ops.lhs[0]->getData()[0];
+        });
+        std::snprintf(name, sizeof(name), "vector/dot d=%zu", dim);
+        Bench::measure(name, VECTORS * dim, [&]() {
+            double acc = 0;
+            for (size_t vec = 0; vec < VECTORS; ++vec)
+                acc += IVector::dot(ops.lhs[vec], ops.rhs[vec]);
+            return acc;
+        });
+        std::snprintf(name, sizeof(name), "vector/clone d=%zu", dim);
+        Bench::measure(name, VECTORS * dim, [&]() {
+            double acc = 0;
+            for (size_t vec = 0; vec < VECTORS; ++vec) {
+                IVector *copy = ops.lhs[vec]->clone();
+                acc += copy->getData()[0];
+                delete copy;
+            }
+            return acc;
+        });
+    }
+}
+
+void VectorBench::benchNorm() {
+    const struct {
+        const char *name;
+        IVector::NORM norm;
+    } norms[] = {{"first", IVector::NORM::FIRST},
+                 {"second", IVector::NORM::SECOND},
+                 {"chebyshev", IVector::NORM::CHEBYSHEV}};
+    char name[64];
+    for (size_t kind = 0; kind < sizeof(DIMS) / sizeof(DIMS[0]); ++kind) {
+        const size_t dim = DIMS[kind];
+        Operands ops(dim);
+        for (size_t norm = 0; norm < sizeof(norms) / sizeof(norms[0]); ++norm) {
+            std::snprintf(name, sizeof(name), "vector/norm %s d=%zu", norms[norm].name, dim);
+            Bench::measure(name, VECTORS * dim, [&]() {
+                double acc = 0;
+                for (size_t vec = 0; vec < VECTORS; ++vec)
+                    acc += ops.lhs[vec]->norm(norms[norm].norm);
+                return acc;
+            });
+        }
+    }
+}
+
+void VectorBench::benchEquals() {
+    char name[64];
+    for (size_t kind = 0; kind < sizeof(DIMS) / sizeof(DIMS[0]); ++kind) {
+        const size_t dim = DIMS[kind];
+        Operands ops(dim);
+        std::snprintf(name, sizeof(name), "vector/equals d=%zu", dim);
+        Bench::measure(name, VECTORS * dim, [&]() {
+            double acc = 0;
+            for (size_t vec = 0; vec < VECTORS; ++vec)
+                acc += IVector::equals(ops.lhs[vec], ops.rhs[vec], IVector::NORM::SECOND, 1e-6);
+            return acc;
+        });
+    }
+}
+
+void VectorBench::benchAll() {
+    std::cout << "Running all Vector benchmarks" << std::endl;
+
+    benchArithmetic();
+    benchNorm();
+    benchEquals();
+
+    std::cout << "Finished all Vector benchmarks" << std::endl;
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include "ICompact.h"
+#include "IDiffProblem.h"
+#include "ILogger.h"
+#include "IMultiIndex.h"
+#include "ISet.h"
+#include "ISolver.h"
+#include "IVector.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Bench {
+/*
+ * Hardware counters of calling thread read through Linux perf_event_open
+ *
+ * Threads started by calling thread after counters were opened, as workers of parallel benchmarks, are counted too,
+ * their counts are added to the calling thread ones
+ *
+ * Counters may be unavailable: on other systems, in containers and virtual machines without PMU, or if
+ * kernel.perf_event_paranoid forbids them. Then isAvailable() is false, getReason() explains why and stop() returns -1
+ * for every event, so benchmarks fall back to wall-clock time only
+ */
+class PerfCounters {
+  public:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENTS };
+
+    // Counters are opened on the first call
+    static PerfCounters &instance();
+    static const char *getName(Event event);
+
+    bool isAvailable() const { return available; }
+    const std::string &getReason() const { return reason; }
+
+    void start();
+    // Writes EVENTS values counted since start(), -1 for events, which can't be counted
+    void stop(double *values);
+
+  private:
+    int fds[EVENTS];
+    bool available;
+    std::string reason;
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+};
+
+struct Options {
+    double min_seconds = 0.2; // minimal wall-clock time of one measurement, repetitions are doubled until it's reached
+    size_t repetitions = 1;   // measurements per benchmark, the fastest one is reported
+    std::string filter;       // only benchmarks, whose names contain it, are run
+    bool perf = false;        // collect hardware counters if they are available
+};
+
+struct Result {
+    std::string name;
+    size_t items;
+    size_t runs; // runs of fn in the fastest measurement
+    double ns_per_run;
+    double ns_per_item;
+    double counters[PerfCounters::EVENTS]; // per run in the fastest measurement, -1 if not collected
+};
+
+Options &options();
+
+// Results of all benchmarks run so far in order of running
+std::vector<Result> &results();
+
+bool isSelected(const char *name);
+
+// Prints result and appends it to results()
+void report(const Result &result);
+
+/*
+ * Writes results() as JSON {"context": {...}, "benchmarks": [{"name", "items", "runs", "ns_per_run",
+ * "ns_per_item"}]}. Collected hardware counters add "ipc" and "<event>_per_item" keys
+ *
+ * @return false if file can't be written
+ */
+bool writeJson(const char *filename);
+
+/*
+ * Compares ns_per_item of results() with ones of benchmarks of the same name in JSON written by writeJson() and prints
+ * the change
+ *
+ * @param [in] threshold Relative slowdown, starting from which benchmark is reported as regression, 0.1 is 10%
+ *
+ * @return Quantity of regressions or -1 if baseline can't be read
+ */
+int compareWithBaseline(const char *filename, double threshold);
+
+/*
+ * Runs fn until it takes at least options().min_seconds and reports average time of one run and of one processed item,
+ * with options().perf also IPC and misses per item
+ *
+ * @param [in] name Name of benchmark in report, "<group>/<operation> <parameters>"
+ *
+ * @param [in] items Quantity of items (nodes, boxes, vectors...) processed by one run of fn
+ *
+ * @param [in] fn Callable returning double, results are accumulated so that compiler can't throw the work away
+ *
+ * @return Time of one run in nanoseconds, 0 if benchmark is filtered out
+ */
+template <class Fn>
+double measure(const char *name, size_t items, Fn fn) {
+    typedef std::chrono::steady_clock Clock;
+    static volatile double sink = 0;
+    if (!isSelected(name))
+        return 0;
+
+    Result result = {name, items, 0, 0, 0, {}};
+    const bool perf = options().perf && PerfCounters::instance().isAvailable();
+    double counters[PerfCounters::EVENTS];
+    for (size_t event = 0; event < PerfCounters::EVENTS; ++event)
+        result.counters[event] = -1;
+    for (size_t repetition = 0; repetition < options().repetitions; ++repetition) {
+        size_t runs = 1;
+        double seconds = 0;
+        while (true) {
+            double acc = 0;
+            if (perf)
+                PerfCounters::instance().start();
+            Clock::time_point start = Clock::now();
+            for (size_t run = 0; run < runs; ++run)
+                acc += fn();
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (perf)
+                PerfCounters::instance().stop(counters);
+            sink = sink + acc;
+            if (seconds >= options().min_seconds)
+                break;
+            runs *= 2;
+        }
+        double ns_per_run = seconds * 1e9 / runs;
+        if (repetition == 0 || ns_per_run < result.ns_per_run) {
+            result.runs = runs;
+            result.ns_per_run = ns_per_run;
+            for (size_t event = 0; event < PerfCounters::EVENTS && perf; ++event)
+                result.counters[event] = counters[event] < 0 ? -1 : counters[event] / runs;
+        }
+    }
+
+    result.ns_per_item = result.ns_per_run / (items == 0 ? 1 : items);
+    report(result);
+    return result.ns_per_run;
+}
+}; // namespace Bench
+
+namespace CompactBench {
+void benchIntersection();
+void benchSpan();
+void benchIsInside();
+void benchNodeCoords();
+void benchTraversal();
+
+void benchAll();
+}; // namespace CompactBench
+
+namespace LoggerBench {
+void benchLog();
+
+void benchAll();
+}; // namespace LoggerBench
+
+namespace VectorBench {
+void benchArithmetic();
+void benchNorm();
+void benchEquals();
+
+void benchAll();
+}; // namespace VectorBench
+
+namespace SetBench {
+void benchInsert();
+void benchFind();
+void benchAlgebra();
+
+void benchAll();
+}; // namespace SetBench
+
+namespace MultiIndexBench {
+void benchIncrement();
+
+void benchAll();
+}; // namespace MultiIndexBench
+
+namespace ProblemBench {
+void benchEval();
+void benchGradient();
+void benchAutoDiff();
+
+void benchAll();
+}; // namespace ProblemBench
+
+namespace SolverBench {
+void benchRosenbrock();
+void benchRastrigin();
+void benchMultiStart();
+void benchGrid();
+
+void benchAll();
+}; // namespace SolverBench
@@ -0,0 +1,90 @@
+#include "bench.hpp"
+#include <cstdlib>
+#include <cstring>
+
+/*
+ * Usage: vs_math-bench [--filter <substring>] [--min-time <seconds>] [--repetitions <n>] [--perf] [--json <file>]
+ *                      [--baseline <file>] [--threshold <percent>]
+ *
+ * --json writes results for regression tracking, --baseline compares them with results written earlier and makes
+ * exit code 1 if any benchmark got slower per item by more than threshold (10% by default). --perf adds IPC, cache
+ * and branch misses per item from hardware counters, if the system allows to read them
+ */
+namespace {
+int usage(const char *program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--filter <substring>] [--min-time <seconds>] [--repetitions <n>] [--perf] [--json <file>] "
+                 "[--baseline <file>] [--threshold <percent>]\n",
+                 program);
+    return 2;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *json = nullptr, *baseline = nullptr;
+    double threshold = 10;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (std::strcmp(argv[arg], "--perf") == 0) {
+            Bench::options().perf = true;
+            continue;
+        }
+        if (arg + 1 >= argc)
+            return usage(argv[0]);
+        const char *value = argv[arg + 1];
+        if (std::strcmp(argv[arg], "--filter") == 0)
+            Bench::options().filter = value;
+        else if (std::strcmp(argv[arg], "--min-time") == 0)
+            Bench::options().min_seconds = std::atof(value);
+        else if (std::strcmp(argv[arg], "--repetitions") == 0)
+            Bench::options().repetitions = (size_t)std::atoi(value);
+        else if (std::strcmp(argv[arg], "--json") == 0)
+            json = value;
+        else if (std::strcmp(argv[arg], "--baseline") == 0)
+            baseline = value;
+        else if (std::strcmp(argv[arg], "--threshold") == 0)
+            threshold = std::atof(value);
+        else
+            return usage(argv[0]);
+        ++arg;
+    }
+    if (Bench::options().min_seconds <= 0 || Bench::options().repetitions == 0 || threshold < 0)
+        return usage(argv[0]);
+    if (Bench::options().perf && !Bench::PerfCounters::instance().isAvailable())
+        std::fprintf(stderr, "Hardware counters are unavailable (%s), measuring time only\n",
+                     Bench::PerfCounters::instance().getReason().c_str());
+
+    // Warnings of expected failures, like duplicates skipped by set algebra, would be measured and flood the report
+    ILogger *logger = ILogger::createLogger();
+    logger->setLevel(ILogger::Level::SEVERE);
+    IVector::setLogger(logger);
+    ISet::setLogger(logger);
+    IMultiIndex::setLogger(logger);
+    ICompact::setLogger(logger);
+    IProblem::setLogger(logger);
+    IDiffProblem::setLogger(logger);
+    ISolver::setLogger(logger);
+
+    VectorBench::benchAll();
+    SetBench::benchAll();
+    MultiIndexBench::benchAll();
+    CompactBench::benchAll();
+    ProblemBench::benchAll();
+    SolverBench::benchAll();
+    LoggerBench::benchAll();
+
+    delete logger;
+
+    int result = 0;
+    if (json != nullptr && !Bench::writeJson(json)) {
+        std::fprintf(stderr, "Can't write %s\n", json);
+        result = 1;
+    }
+    if (baseline != nullptr) {
+        int regressions = Bench::compareWithBaseline(baseline, threshold / 100);
+        if (regressions < 0)
+            std::fprintf(stderr, "Can't read baseline %s\n", baseline);
+        if (regressions != 0)
+            result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,589 @@
+#pragma once
+#include "ProblemKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+ * Automatic differentiation of f(args, params) written once as template over type of numbers
+ *
+ * Var is reverse mode: operations on it are recorded to tape of calling thread, one backward sweep over the tape gives
+ * gradient by all variables at once. Jet is forward mode: truncated Taylor series by several variables, order 1 by one
+ * variable is a dual number. Jet gives mixed derivative of any orders, its size is product of (order + 1) over axes,
+ * which must not exceed Detail::MAX_COEFFICIENTS. Math functions of the namespace accept double, Var and Jet, so the
+ * same code evaluates all of them
+ *
+ * kernel() instantiates f for double (values), Var (gradients) and Jet of 4, 16 and 64 coefficients (mixed
+ * derivatives) by args and by params, derivative is taken by the smallest Jet holding its coefficients. All of them are
+ * exact up to rounding. Tapes and buffers of threads grow to the largest function once and are reused
+ *
+ * Example:
+ *     struct Rosenbrock {
+ *         template <class T>
+ *         T operator()(T const *x, T const *p) const {
+ *             return (p[0] - x[0]) * (p[0] - x[0]) + p[1] * AutoDiff::pow(x[1] - x[0] * x[0], 2);
+ *         }
+ *     } f;
+ *     IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, AutoDiff::kernel(f));
+ */
+namespace AutoDiff {
+namespace Detail {
+const size_t NONE = (size_t)-1;
+// Coefficients of the largest Jet
+const size_t MAX_COEFFICIENTS = 64;
+
+template <class T>
+T *scratch(size_t size) {
+    static thread_local std::vector<T> buffer;
+    if (buffer.size() < size)
+        buffer.resize(size);
+    return buffer.data();
+}
+
+/*
+ * Operations recorded by Var: node has up to two parents, partial derivatives by them and adjoint of backward sweep.
+ * Nodes are kept between evaluations, so recording writes into place and only the largest function grows them
+ */
+class Tape {
+  public:
+    static Tape &current() {
+        static thread_local Tape tape;
+        return tape;
+    }
+
+    Tape() : size(0) {}
+
+    void clear() { size = 0; }
+    size_t record(size_t parent0, double partial0, size_t parent1, double partial1) {
+        if (size == nodes.size())
+            nodes.resize(std::max<size_t>(2 * size, 256));
+        Node &node = nodes[size];
+        node.parents[0] = parent0;
+        node.parents[1] = parent1;
+        node.partials[0] = partial0;
+        node.partials[1] = partial1;
+        node.adjoint = 0;
+        return size++;
+    }
+
+    // Writes to grad derivatives of node result by the first dim nodes
+    void backward(size_t result, size_t dim, double *grad) {
+        if (result != NONE)
+            nodes[result].adjoint = 1;
+        for (size_t idx = size; idx-- > dim;) {
+            Node const &node = nodes[idx];
+            if (node.adjoint == 0)
+                continue;
+            if (node.parents[0] != NONE)
+                nodes[node.parents[0]].adjoint += node.partials[0] * node.adjoint;
+            if (node.parents[1] != NONE)
+                nodes[node.parents[1]].adjoint += node.partials[1] * node.adjoint;
+        }
+        for (size_t axis = 0; axis < dim; ++axis)
+            grad[axis] = axis < size ? nodes[axis].adjoint : 0;
+    }
+
+  private:
+    struct Node {
+        size_t parents[2];
+        double partials[2];
+        double adjoint;
+    };
+    std::vector<Node> nodes;
+    size_t size;
+};
+
+/*
+ * Layout of Jet coefficients for orders of the current derivative: coefficient of monomial prod(dx[i]^k[i]) for
+ * k <= orders has mixed-radix number with radix orders[i] + 1. Products are sums over pairs m <= k of coefficients m
+ * and k - m, the pairs are enumerated once per orders
+ */
+class Shape {
+  public:
+    struct Pair {
+        size_t m, rest;
+        // m[j], where j is the first axis with k[j] > 0
+        double weight;
+    };
+
+    size_t count;
+    std::vector<size_t> strides;
+    // k[j] of coefficient k, pairs of k are first[k]...first[k + 1] - 1
+    std::vector<double> degrees;
+    std::vector<size_t> first;
+    std::vector<Pair> pairs;
+
+    // Layout is looked up once per derivative and then passes from operands to results of Jet
+    static Shape &current() {
+        static thread_local Shape shape;
+        return shape;
+    }
+
+    Shape() : count(1) {}
+
+    // False if there are more than capacity coefficients
+    bool reset(size_t dim, size_t const *orders, size_t capacity) {
+        if (dim == last.size() && std::equal(orders, orders + dim, last.begin()))
+            return true;
+        size_t size = 1;
+        for (size_t axis = 0; axis < dim; ++axis) {
+            if (orders[axis] + 1 > capacity / size)
+                return false;
+            size *= orders[axis] + 1;
+        }
+        count = 1;
+        strides.assign(dim, 0);
+        for (size_t axis = 0; axis < dim; ++axis) {
+            if (orders[axis] > 0)
+                strides[axis] = count;
+            count *= orders[axis] + 1;
+        }
+        last.assign(orders, orders + dim);
+        degrees.assign(count, 0);
+        first.assign(count + 1, 0);
+        pairs.clear();
+        std::vector<size_t> k(dim), m(dim);
+        for (size_t linear = 0; linear < count; ++linear) {
+            size_t axis_j = dim;
+            for (size_t axis = 0; axis < dim; ++axis) {
+                k[axis] = strides[axis] == 0 ? 0 : linear / strides[axis] % (orders[axis] + 1);
+                if (k[axis] > 0 && axis_j == dim)
+                    axis_j = axis;
+            }
+            degrees[linear] = axis_j == dim ? 0 : (double)k[axis_j];
+            m.assign(dim, 0);
+            while (true) {
+                size_t m_linear = 0;
+                for (size_t axis = 0; axis < dim; ++axis)
+                    m_linear += m[axis] * strides[axis];
+                Pair pair = {m_linear, linear - m_linear, axis_j == dim ? 0 : (double)m[axis_j]};
+                pairs.push_back(pair);
+                size_t axis = 0;
+                while (axis < dim && m[axis] == k[axis])
+                    m[axis++] = 0;
+                if (axis == dim)
+                    break;
+                ++m[axis];
+            }
+            first[linear + 1] = pairs.size();
+        }
+        return true;
+    }
+
+  private:
+    std::vector<size_t> last;
+};
+} // namespace Detail
+
+/*
+ * Number of reverse mode: value and node of tape of calling thread, constants aren't recorded. Tape is looked up once
+ * per variable and then passes from operands to results
+ */
+class Var {
+  public:
+    double value;
+    size_t node;
+    // nullptr for constants
+    Detail::Tape *tape;
+
+    Var(double value = 0) : value(value), node(Detail::NONE), tape(nullptr) {}
+
+    // New independent variable on tape, which is the one of calling thread by default
+    static Var variable(double value, Detail::Tape &tape = Detail::Tape::current()) {
+        Var result(value);
+        result.tape = &tape;
+        result.node = tape.record(Detail::NONE, 0, Detail::NONE, 0);
+        return result;
+    }
+
+    Var &operator+=(Var const &other);
+    Var &operator-=(Var const &other);
+    Var &operator*=(Var const &other);
+    Var &operator/=(Var const &other);
+};
+
+namespace Detail {
+inline Var record(double value, Var const &a, double da) {
+    Var result(value);
+    if (a.tape != nullptr) {
+        result.tape = a.tape;
+        result.node = a.tape->record(a.node, da, NONE, 0);
+    }
+    return result;
+}
+inline Var record(double value, Var const &a, double da, Var const &b, double db) {
+    Var result(value);
+    result.tape = a.tape != nullptr ? a.tape : b.tape;
+    if (result.tape != nullptr)
+        result.node = result.tape->record(a.node, da, b.node, db);
+    return result;
+}
+} // namespace Detail
+
+inline Var operator+(Var const &a, Var const &b) { return Detail::record(a.value + b.value, a, 1, b, 1); }
+inline Var operator-(Var const &a, Var const &b) { return Detail::record(a.value - b.value, a, 1, b, -1); }
+inline Var operator*(Var const &a, Var const &b) { return Detail::record(a.value * b.value, a, b.value, b, a.value); }
+inline Var operator/(Var const &a, Var const &b) {
+    const double value = a.value / b.value;
+    return Detail::record(value, a, 1 / b.value, b, -value / b.value);
+}
+inline Var operator-(Var const &a) { return Detail::record(-a.value, a, -1); }
+inline Var operator+(Var const &a) { return a; }
+inline Var &Var::operator+=(Var const &other) { return *this = *this + other; }
+inline Var &Var::operator-=(Var const &other) { return *this = *this - other; }
+inline Var &Var::operator*=(Var const &other) { return *this = *this * other; }
+inline Var &Var::operator/=(Var const &other) { return *this = *this / other; }
+
+inline bool operator<(Var const &a, Var const &b) { return a.value < b.value; }
+inline bool operator>(Var const &a, Var const &b) { return a.value > b.value; }
+inline bool operator<=(Var const &a, Var const &b) { return a.value <= b.value; }
+inline bool operator>=(Var const &a, Var const &b) { return a.value >= b.value; }
+inline bool operator==(Var const &a, Var const &b) { return a.value == b.value; }
+inline bool operator!=(Var const &a, Var const &b) { return a.value != b.value; }
+
+inline Var exp(Var const &a) {
+    const double value = std::exp(a.value);
+    return Detail::record(value, a, value);
+}
+inline Var log(Var const &a) { return Detail::record(std::log(a.value), a, 1 / a.value); }
+inline Var sqrt(Var const &a) {
+    const double value = std::sqrt(a.value);
+    return Detail::record(value, a, 0.5 / value);
+}
+inline Var sin(Var const &a) { return Detail::record(std::sin(a.value), a, std::cos(a.value)); }
+inline Var cos(Var const &a) { return Detail::record(std::cos(a.value), a, -std::sin(a.value)); }
+inline Var pow(Var const &a, double power) {
+    return Detail::record(std::pow(a.value, power), a, power * std::pow(a.value, power - 1));
+}
+inline Var fabs(Var const &a) { return Detail::record(std::fabs(a.value), a, a.value < 0 ? -1 : 1); }
+
+/*
+ * Number of forward mode: Capacity coefficients of Taylor series in layout of Detail::Shape. Shape is given to
+ * variables and passes from operands to results, constants have none, keep the value only and take shortcuts, so axes
+ * of zero order cost about as much as evaluation by doubles. Only count coefficients of shape are read and written
+ *
+ * Arithmetic is defined by friends, so that doubles and integers are converted to constant Jet in mixed expressions
+ */
+template <size_t Capacity>
+class Jet {
+  public:
+    static const size_t CAPACITY = Capacity;
+    double c[Capacity];
+    // nullptr for constants: only c[0] is meaningful, other coefficients are zeros
+    Detail::Shape const *shape;
+
+    Jet(double value = 0) : shape(nullptr) { c[0] = value; }
+    Jet(Jet const &other) : shape(other.shape) { copy(other); }
+    Jet &operator=(Jet const &other) {
+        shape = other.shape;
+        copy(other);
+        return *this;
+    }
+
+    // Variable of axis with stride of its coefficients (0 for constant along all axes of derivative)
+    static Jet variable(double value, size_t stride, Detail::Shape const &shape) {
+        if (stride == 0)
+            return Jet(value);
+        Jet result = series(value, shape);
+        std::fill(result.c + 1, result.c + shape.count, 0.0);
+        result.c[stride] = 1;
+        return result;
+    }
+    // Non-constant with value, coefficients above c[0] are to be written by caller
+    static Jet series(double value, Detail::Shape const &shape) {
+        Jet result(value);
+        result.shape = &shape;
+        return result;
+    }
+
+    size_t count() const { return shape == nullptr ? 1 : shape->count; }
+    double value() const { return c[0]; }
+    double coefficient(size_t k) const { return k == 0 || shape != nullptr ? c[k] : 0; }
+
+    friend Jet operator+(Jet const &a, Jet const &b) {
+        if (a.shape == nullptr || b.shape == nullptr) {
+            Jet result(a.shape == nullptr ? b : a);
+            result.c[0] = a.c[0] + b.c[0];
+            return result;
+        }
+        Jet result = series(0, *a.shape);
+        for (size_t k = 0, count = a.shape->count; k < count; ++k)
+            result.c[k] = a.c[k] + b.c[k];
+        return result;
+    }
+    friend Jet operator-(Jet const &a) {
+        Jet result(a);
+        for (size_t k = 0, count = a.count(); k < count; ++k)
+            result.c[k] = -result.c[k];
+        return result;
+    }
+    friend Jet operator-(Jet const &a, Jet const &b) {
+        if (b.shape == nullptr) {
+            Jet result(a);
+            result.c[0] = a.c[0] - b.c[0];
+            return result;
+        }
+        Jet result = -b;
+        result.c[0] += a.c[0];
+        for (size_t k = 1, count = a.count(); k < count; ++k)
+            result.c[k] += a.c[k];
+        return result;
+    }
+    friend Jet operator+(Jet const &a) { return a; }
+    friend Jet operator*(Jet const &a, double b) {
+        Jet result(a);
+        for (size_t k = 0, count = a.count(); k < count; ++k)
+            result.c[k] *= b;
+        return result;
+    }
+    friend Jet operator*(double a, Jet const &b) { return b * a; }
+    friend Jet operator/(Jet const &a, double b) { return a * (1 / b); }
+    friend Jet operator*(Jet const &a, Jet const &b) {
+        if (a.shape == nullptr)
+            return b * a.c[0];
+        if (b.shape == nullptr)
+            return a * b.c[0];
+        Detail::Shape const &shape = *a.shape;
+        Jet result = series(0, shape);
+        for (size_t k = 0; k < shape.count; ++k) {
+            double sum = 0;
+            for (size_t idx = shape.first[k]; idx < shape.first[k + 1]; ++idx)
+                sum += a.c[shape.pairs[idx].m] * b.c[shape.pairs[idx].rest];
+            result.c[k] = sum;
+        }
+        return result;
+    }
+    // c = a / b: b[0] * c[k] = a[k] - sum of b[m] * c[k - m] over 0 < m <= k
+    friend Jet operator/(Jet const &a, Jet const &b) {
+        if (b.shape == nullptr)
+            return a * (1 / b.c[0]);
+        Detail::Shape const &shape = *b.shape;
+        Jet result = series(0, shape);
+        for (size_t k = 0; k < shape.count; ++k) {
+            double sum = a.coefficient(k);
+            for (size_t idx = shape.first[k] + 1; idx < shape.first[k + 1]; ++idx)
+                sum -= b.c[shape.pairs[idx].m] * result.c[shape.pairs[idx].rest];
+            result.c[k] = sum / b.c[0];
+        }
+        return result;
+    }
+    // Sums accumulated in loops are updated in place, constant terms touch c[0] only
+    Jet &operator+=(Jet const &other) {
+        if (shape == nullptr)
+            return *this = *this + other;
+        c[0] += other.c[0];
+        for (size_t k = 1, count = other.count(); k < count; ++k)
+            c[k] += other.c[k];
+        return *this;
+    }
+    Jet &operator-=(Jet const &other) {
+        if (shape == nullptr)
+            return *this = *this - other;
+        c[0] -= other.c[0];
+        for (size_t k = 1, count = other.count(); k < count; ++k)
+            c[k] -= other.c[k];
+        return *this;
+    }
+    Jet &operator*=(Jet const &other) { return *this = *this * other; }
+    Jet &operator/=(Jet const &other) { return *this = *this / other; }
+
+    friend bool operator<(Jet const &a, Jet const &b) { return a.c[0] < b.c[0]; }
+    friend bool operator>(Jet const &a, Jet const &b) { return a.c[0] > b.c[0]; }
+    friend bool operator<=(Jet const &a, Jet const &b) { return a.c[0] <= b.c[0]; }
+    friend bool operator>=(Jet const &a, Jet const &b) { return a.c[0] >= b.c[0]; }
+    friend bool operator==(Jet const &a, Jet const &b) { return a.c[0] == b.c[0]; }
+    friend bool operator!=(Jet const &a, Jet const &b) { return a.c[0] != b.c[0]; }
+
+  private:
+    // Constants are copied often and have one coefficient, which isn't worth a call of memcpy
+    void copy(Jet const &other) {
+        c[0] = other.c[0];
+        if (other.shape != nullptr)
+            std::copy(other.c + 1, other.c + other.shape->count, c + 1);
+    }
+};
+
+/*
+ * Functions follow from differential equations along axis j of each coefficient, e.g. b = exp(a) gives
+ * k[j] * b[k] = sum of m[j] * a[m] * b[k - m] over m <= k, so every coefficient costs one pass over its pairs
+ */
+template <size_t Capacity>
+Jet<Capacity> exp(Jet<Capacity> const &a) {
+    if (a.shape == nullptr)
+        return Jet<Capacity>(std::exp(a.c[0]));
+    Detail::Shape const &shape = *a.shape;
+    Jet<Capacity> result = Jet<Capacity>::series(std::exp(a.c[0]), shape);
+    for (size_t k = 1; k < shape.count; ++k) {
+        double sum = 0;
+        for (size_t idx = shape.first[k] + 1; idx < shape.first[k + 1]; ++idx)
+            sum += shape.pairs[idx].weight * a.c[shape.pairs[idx].m] * result.c[shape.pairs[idx].rest];
+        result.c[k] = sum / shape.degrees[k];
+    }
+    return result;
+}
+template <size_t Capacity>
+Jet<Capacity> log(Jet<Capacity> const &a) {
+    if (a.shape == nullptr)
+        return Jet<Capacity>(std::log(a.c[0]));
+    Detail::Shape const &shape = *a.shape;
+    Jet<Capacity> result = Jet<Capacity>::series(std::log(a.c[0]), shape);
+    for (size_t k = 1; k < shape.count; ++k) {
+        double sum = shape.degrees[k] * a.c[k];
+        for (size_t idx = shape.first[k] + 1; idx + 1 < shape.first[k + 1]; ++idx)
+            sum -= shape.pairs[idx].weight * result.c[shape.pairs[idx].m] * a.c[shape.pairs[idx].rest];
+        result.c[k] = sum / (shape.degrees[k] * a.c[0]);
+    }
+    return result;
+}
+template <size_t Capacity>
+Jet<Capacity> sqrt(Jet<Capacity> const &a) {
+    if (a.shape == nullptr)
+        return Jet<Capacity>(std::sqrt(a.c[0]));
+    Detail::Shape const &shape = *a.shape;
+    Jet<Capacity> result = Jet<Capacity>::series(std::sqrt(a.c[0]), shape);
+    for (size_t k = 1; k < shape.count; ++k) {
+        double sum = a.c[k];
+        for (size_t idx = shape.first[k] + 1; idx + 1 < shape.first[k + 1]; ++idx)
+            sum -= result.c[shape.pairs[idx].m] * result.c[shape.pairs[idx].rest];
+        result.c[k] = sum / (2 * result.c[0]);
+    }
+    return result;
+}
+namespace Detail {
+template <size_t Capacity>
+void sinCos(Jet<Capacity> const &a, Jet<Capacity> &sin, Jet<Capacity> &cos) {
+    if (a.shape == nullptr) {
+        sin = Jet<Capacity>(std::sin(a.c[0]));
+        cos = Jet<Capacity>(std::cos(a.c[0]));
+        return;
+    }
+    Shape const &shape = *a.shape;
+    sin = Jet<Capacity>::series(std::sin(a.c[0]), shape);
+    cos = Jet<Capacity>::series(std::cos(a.c[0]), shape);
+    for (size_t k = 1; k < shape.count; ++k) {
+        double sin_sum = 0, cos_sum = 0;
+        for (size_t idx = shape.first[k] + 1; idx < shape.first[k + 1]; ++idx) {
+            const double term = shape.pairs[idx].weight * a.c[shape.pairs[idx].m];
+            sin_sum += term * cos.c[shape.pairs[idx].rest];
+            cos_sum -= term * sin.c[shape.pairs[idx].rest];
+        }
+        sin.c[k] = sin_sum / shape.degrees[k];
+        cos.c[k] = cos_sum / shape.degrees[k];
+    }
+}
+} // namespace Detail
+template <size_t Capacity>
+Jet<Capacity> sin(Jet<Capacity> const &a) {
+    Jet<Capacity> sin, cos;
+    Detail::sinCos(a, sin, cos);
+    return sin;
+}
+template <size_t Capacity>
+Jet<Capacity> cos(Jet<Capacity> const &a) {
+    Jet<Capacity> sin, cos;
+    Detail::sinCos(a, sin, cos);
+    return cos;
+}
+// b = a^power: a[0] * k[j] * b[k] = sum of (power * m[j] - k[j] + m[j]) * a[m] * b[k - m] over 0 < m <= k
+template <size_t Capacity>
+Jet<Capacity> pow(Jet<Capacity> const &a, double power) {
+    if (a.shape == nullptr)
+        return Jet<Capacity>(std::pow(a.c[0], power));
+    Detail::Shape const &shape = *a.shape;
+    Jet<Capacity> result = Jet<Capacity>::series(std::pow(a.c[0], power), shape);
+    for (size_t k = 1; k < shape.count; ++k) {
+        double sum = 0;
+        for (size_t idx = shape.first[k] + 1; idx < shape.first[k + 1]; ++idx) {
+            const double weight = shape.pairs[idx].weight;
+            sum += (power * weight - shape.degrees[k] + weight) * a.c[shape.pairs[idx].m] *
+                   result.c[shape.pairs[idx].rest];
+        }
+        result.c[k] = sum / (shape.degrees[k] * a.c[0]);
+    }
+    return result;
+}
+template <size_t Capacity>
+Jet<Capacity> fabs(Jet<Capacity> const &a) {
+    return a.c[0] < 0 ? -a : a;
+}
+
+// The same functions for double, so templated code calls AutoDiff:: for any type of numbers
+inline double exp(double a) { return std::exp(a); }
+inline double log(double a) { return std::log(a); }
+inline double sqrt(double a) { return std::sqrt(a); }
+inline double sin(double a) { return std::sin(a); }
+inline double cos(double a) { return std::cos(a); }
+inline double pow(double a, double power) { return std::pow(a, power); }
+inline double fabs(double a) { return std::fabs(a); }
+
+namespace Detail {
+template <class F, bool ByArgs>
+void gradient(double const *args, size_t argsDim, double const *params, size_t paramsDim, double *grad,
+              void *context) {
+    Tape &tape = Tape::current();
+    tape.clear();
+    Var *vars = scratch<Var>(argsDim + paramsDim);
+    for (size_t axis = 0; axis < argsDim; ++axis)
+        vars[axis] = ByArgs ? Var::variable(args[axis], tape) : Var(args[axis]);
+    for (size_t axis = 0; axis < paramsDim; ++axis)
+        vars[argsDim + axis] = ByArgs ? Var(params[axis]) : Var::variable(params[axis], tape);
+    const Var result = (*static_cast<F const *>(context))(vars, vars + argsDim);
+    tape.backward(result.node, ByArgs ? argsDim : paramsDim, grad);
+}
+
+// The highest coefficient of f by Jet of Capacity, which holds coefficients of shape
+template <class F, bool ByArgs, size_t Capacity>
+double highest(double const *args, size_t argsDim, double const *params, size_t paramsDim, Shape const &shape,
+               void *context) {
+    typedef Jet<Capacity> Number;
+    Number *jets = scratch<Number>(argsDim + paramsDim);
+    for (size_t axis = 0; axis < argsDim; ++axis)
+        jets[axis] = ByArgs ? Number::variable(args[axis], shape.strides[axis], shape) : Number(args[axis]);
+    for (size_t axis = 0; axis < paramsDim; ++axis)
+        jets[argsDim + axis] =
+            ByArgs ? Number(params[axis]) : Number::variable(params[axis], shape.strides[axis], shape);
+    const Number result = (*static_cast<F const *>(context))(jets, jets + argsDim);
+    return result.coefficient(shape.count - 1);
+}
+
+template <class F, bool ByArgs>
+double derivative(double const *args, size_t argsDim, double const *params, size_t paramsDim, size_t const *orders,
+                  void *context) {
+    Shape &shape = Shape::current();
+    if (!shape.reset(ByArgs ? argsDim : paramsDim, orders, MAX_COEFFICIENTS))
+        return std::numeric_limits<double>::quiet_NaN();
+    const double coefficient =
+        shape.count <= 4    ? highest<F, ByArgs, 4>(args, argsDim, params, paramsDim, shape, context)
+        : shape.count <= 16 ? highest<F, ByArgs, 16>(args, argsDim, params, paramsDim, shape, context)
+                            : highest<F, ByArgs, MAX_COEFFICIENTS>(args, argsDim, params, paramsDim, shape, context);
+
+    // Derivative is the highest coefficient times product of factorials of orders
+    double scale = 1;
+    for (size_t axis = 0; axis < (ByArgs ? argsDim : paramsDim); ++axis)
+        for (size_t factor = 2; factor <= orders[axis]; ++factor)
+            scale *= (double)factor;
+    return coefficient * scale;
+}
+} // namespace Detail
+
+/*
+ * Kernel of templated f: T f(T const *args, T const *params) for T = double, Var and Jet. Kernel keeps pointer to f,
+ * it must outlive problem and its clones
+ */
+template <class F>
+IProblem::Kernel kernel(F const &f) {
+    IProblem::Kernel kernel = {&ProblemKernel::Detail::eval<F>,
+                               &ProblemKernel::Detail::evalBatch<F>,
+                               &Detail::gradient<F, true>,
+                               &Detail::gradient<F, false>,
+                               &Detail::derivative<F, true>,
+                               &Detail::derivative<F, false>,
+                               const_cast<void *>(static_cast<void const *>(&f))};
+    return kernel;
+}
+// Kernel would keep pointer to temporary
+template <class F>
+IProblem::Kernel kernel(F const &&) = delete;
+} // namespace AutoDiff
@@ -0,0 +1,177 @@
+#pragma once
+#include "ILogger.h"
+#include "RC.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Format of binary log written by ILogger::createBinaryLogger() and reader of it
+ *
+ * File starts with header followed by entries, every entry starts with its kind byte. STRING entry defines text of
+ * interned string before the first record referring to it, RECORD entry has fixed width. Numbers are little-endian
+ *
+ *   header: magic "VSMLOG\0\0", u32 version, u32 reserved, u64 start_time, u64 start_wall
+ *   STRING: u8 kind, u32 id, u32 length, length bytes of text
+ *   RECORD: u8 kind, u64 time, u64 repeats, u32 srcfile, u32 function, i32 line, u16 code, u8 level
+ *
+ * Times are nanoseconds of monotonic clock, start_wall is time of start_time in nanoseconds since Unix epoch. String 0
+ * is empty one, it's used by records without information about caller. Log appended to existing file starts with its
+ * own header and string table
+ */
+namespace BinaryLog {
+const char MAGIC[8] = {'V', 'S', 'M', 'L', 'O', 'G', '\0', '\0'};
+const uint32_t VERSION = 1;
+const size_t HEADER_SIZE = 32;
+const size_t STRING_HEADER_SIZE = 9;
+const size_t RECORD_SIZE = 32;
+
+enum Kind : uint8_t { STRING = 1, RECORD = 2 };
+
+struct Header {
+    uint64_t start_time;
+    uint64_t start_wall;
+};
+
+struct Record {
+    uint64_t time;
+    uint64_t repeats; // quantity of records collapsed into this one, see ILogger::logRepeated()
+    uint32_t srcfile; // string ids
+    uint32_t function;
+    int32_t line;
+    RC code;
+    ILogger::Level level;
+};
+
+// Appends bytes lower bytes of value
+inline void put(std::vector<char> &out, uint64_t value, size_t bytes) {
+    for (size_t idx = 0; idx < bytes; ++idx, value >>= 8)
+        out.push_back((char)(value & 0xFF));
+}
+
+inline uint64_t get(const char *in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t idx = bytes; idx-- > 0;)
+        value = value << 8 | (unsigned char)in[idx];
+    return value;
+}
+
+inline void putHeader(std::vector<char> &out, const Header &header) {
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    put(out, VERSION, 4);
+    put(out, 0, 4);
+    put(out, header.start_time, 8);
+    put(out, header.start_wall, 8);
+}
+
+inline void putString(std::vector<char> &out, uint32_t id, const char *text, size_t length) {
+    out.push_back((char)STRING);
+    put(out, id, 4);
+    put(out, length, 4);
+    out.insert(out.end(), text, text + length);
+}
+
+inline void putRecord(std::vector<char> &out, const Record &record) {
+    out.push_back((char)RECORD);
+    put(out, record.time, 8);
+    put(out, record.repeats, 8);
+    put(out, record.srcfile, 4);
+    put(out, record.function, 4);
+    put(out, (uint32_t)record.line, 4);
+    put(out, (uint16_t)record.code, 2);
+    put(out, (uint8_t)record.level, 1);
+}
+
+/*
+ * Sequential reader of binary log, it doesn't log errors but returns them
+ */
+class Reader {
+  public:
+    Reader() : header(), strings(1) {}
+
+    /*
+     * Returns FILE_NOT_FOUND if file can't be opened, INVALID_ARGUMENT if it isn't binary log of supported version
+     */
+    RC open(const char *filename) {
+        file.open(filename, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return RC::FILE_NOT_FOUND;
+        char kind;
+        if (!file.get(kind) || kind != MAGIC[0])
+            return RC::INVALID_ARGUMENT;
+        return readHeader();
+    }
+
+    /*
+     * Reads next record, strings defined before it become available with getString()
+     *
+     * Returns INDEX_OUT_OF_BOUND at the end of log, IO_ERROR if log is truncated or corrupted
+     */
+    RC next(Record &record) {
+        char kind;
+        while (file.get(kind)) {
+            if (kind == (char)RECORD) {
+                char buf[RECORD_SIZE - 1];
+                if (!file.read(buf, sizeof(buf)))
+                    return RC::IO_ERROR;
+                record.time = get(buf, 8);
+                record.repeats = get(buf + 8, 8);
+                record.srcfile = (uint32_t)get(buf + 16, 4);
+                record.function = (uint32_t)get(buf + 20, 4);
+                record.line = (int32_t)(uint32_t)get(buf + 24, 4);
+                record.code = (RC)get(buf + 28, 2);
+                record.level = (ILogger::Level)get(buf + 30, 1);
+                if (record.srcfile >= strings.size() || record.function >= strings.size() ||
+                    (size_t)record.code >= (size_t)RC::AMOUNT || (size_t)record.level > (size_t)ILogger::Level::INFO)
+                    return RC::IO_ERROR;
+                return RC::SUCCESS;
+            }
+            if (kind == MAGIC[0]) {
+                if (readHeader() != RC::SUCCESS)
+                    return RC::IO_ERROR;
+                continue;
+            }
+            if (kind != (char)STRING)
+                return RC::IO_ERROR;
+            char buf[STRING_HEADER_SIZE - 1];
+            if (!file.read(buf, sizeof(buf)))
+                return RC::IO_ERROR;
+            uint32_t id = (uint32_t)get(buf, 4);
+            uint32_t length = (uint32_t)get(buf + 4, 4);
+            // Ids are given in order of appearance
+            if (id != strings.size())
+                return RC::IO_ERROR;
+            std::string text(length, '\0');
+            if (length > 0 && !file.read(&text[0], length))
+                return RC::IO_ERROR;
+            strings.push_back(text);
+        }
+        return file.eof() ? RC::INDEX_OUT_OF_BOUND : RC::IO_ERROR;
+    }
+
+    const Header &getHeader() const { return header; }
+    // Text of string id, empty one for unknown id
+    const std::string &getString(uint32_t id) const { return id < strings.size() ? strings[id] : strings[0]; }
+
+  private:
+    std::ifstream file;
+    Header header;
+    std::vector<std::string> strings;
+
+    // Reads header, whose first byte is already read, and starts new string table
+    RC readHeader() {
+        char buf[HEADER_SIZE];
+        buf[0] = MAGIC[0];
+        if (!file.read(buf + 1, HEADER_SIZE - 1) || std::memcmp(buf, MAGIC, sizeof(MAGIC)) != 0 ||
+            get(buf + 8, 4) != VERSION)
+            return RC::INVALID_ARGUMENT;
+        header.start_time = get(buf + 16, 8);
+        header.start_wall = get(buf + 24, 8);
+        strings.resize(1);
+        return RC::SUCCESS;
+    }
+};
+}; // namespace BinaryLog
@@ -1,13 +1,20 @@
 #pragma once
+#include <cstdint>
+#include <functional>
 #include "Interfacedllexport.h"
 #include "ILogger.h"
 #include "IVector.h"
 #include "RC.h"
 #include "IMultiIndex.h"
+#include "IGridSpec.h"
 
 class LIB_EXPORT ICompact {
 public:
     static ICompact* createCompact(IVector const * vec1, IVector const * vec2, IMultiIndex const *nodeQuantities);
+    /*
+    * Create compact with grid nodes placed along axes as described by gridSpec (see IGridSpec)
+    */
+    static ICompact* createCompact(IVector const * vec1, IVector const * vec2, IGridSpec const *gridSpec);
 
     virtual ICompact *clone() const = 0;
 
@@ -16,6 +23,18 @@ public:
 
     virtual bool isInside(IVector const * const&vec) const = 0;
     /*
+    * Classifies count points given as row-major block (count rows of getDim() doubles)
+    *
+    * Result is packed bitmask: bit (i % 8) of mask[i / 8] is set if point i is inside compact, mask must hold
+    * (count + 7) / 8 bytes
+    */
+    virtual RC isInsideBatch(double const * const &rows, size_t count, uint8_t * const &mask) const = 0;
+    /*
+    * Same as isInsideBatch(rows, count, mask), additionally writes to nodes[i] number (in bypassOrder numbering, see
+    * toLinear()) of grid node nearest to point i, or getNodesCount() if point i is outside
+    */
+    virtual RC isInsideBatch(double const * const &rows, size_t count, uint8_t * const &mask, IMultiIndex const * const &bypassOrder, size_t * const &nodes) const = 0;
+    /*
     * Method creating new IVector and assigning new address to val
     */
     virtual RC getVectorCopy(IMultiIndex const *index, IVector *& val) const = 0;
@@ -28,14 +47,98 @@ public:
     virtual RC getLeftBoundary(IVector *& vec) const = 0;
     // правейшая по всем координатам
     virtual RC getRightBoundary(IVector *& vec) const = 0;
+    // Non-owning access to boundaries coordinates, pointers are valid while compact is alive
+    virtual double const* getLeftBoundaryData() const = 0;
+    virtual double const* getRightBoundaryData() const = 0;
     virtual size_t getDim() const = 0;
+    // Returns copy of node quantities, caller owns it
     virtual IMultiIndex* getGrid() const = 0;
+    // Non-owning access to node quantities along axes (getDim() elements), pointer is valid while compact is alive
+    virtual size_t const* getGridData() const = 0;
+    // total amount of grid nodes, product of node quantities over all axes
+    virtual size_t getNodesCount() const = 0;
+
+    /*
+    * Mixed-radix numbering of grid nodes: first axis of bypassOrder is the least significant digit, so node numbers
+    * go in the same order as iterator with this bypassOrder visits nodes
+    *
+    * toLinear() calculates number of node with position index, fromLinear() writes position of node nodeIndex to index
+    */
+    virtual RC toLinear(IMultiIndex const * const &index, IMultiIndex const * const &bypassOrder, size_t &nodeIndex) const = 0;
+    virtual RC fromLinear(size_t nodeIndex, IMultiIndex const * const &bypassOrder, IMultiIndex * const &index) const = 0;
+    /*
+    * Method copy coordinates of node nodeIndex to caller-owned buffer of getDim() doubles
+    */
+    virtual RC getNode(size_t nodeIndex, IMultiIndex const * const &bypassOrder, double * const &coords) const = 0;
+
+    /*
+    * Method writes count grid nodes to out as row-major block (count rows of getDim() doubles)
+    *
+    * Nodes are numbered in the same order as iterator with the same bypassOrder visits them: first axis of bypassOrder
+    * is the fastest one. Whole grid can be generated in tiles by calling the method for startIndex = 0, tile, 2 * tile...
+    * while startIndex < getNodesCount()
+    *
+    * @param [in] startIndex Number of the first node of the block
+    *
+    * @param [in] count Quantity of nodes in the block, startIndex + count must not exceed getNodesCount()
+    *
+    * @param [in] bypassOrder Multi-index, that defining bypass order of axis
+    *
+    * @param [in] out Caller-owned buffer of count * getDim() doubles
+    */
+    virtual RC generateNodes(size_t startIndex, size_t count, IMultiIndex const * const &bypassOrder, double * const &out) const = 0;
+    /*
+    * Method calls fn for every grid node from several threads
+    *
+    * Grid is split into tiles of consecutive nodes (in bypassOrder numbering), tiles are balanced between threads with
+    * work stealing. fn receives number of the node and pointer to its getDim() coordinates, which is valid only during
+    * the call. fn must be safe to call from different threads simultaneously. If fn throws, no more nodes are visited
+    * and the first exception is rethrown to caller after all threads stopped
+    *
+    * @param [in] bypassOrder Multi-index, that defining bypass order of axis
+    *
+    * @param [in] fn Function called for each node
+    *
+    * @param [in] threads Quantity of threads, 0 means all hardware threads
+    */
+    virtual RC parallelForEachNode(IMultiIndex const * const &bypassOrder, const std::function<void(size_t, double const *)> &fn, size_t threads = 0) const = 0;
+
+    // True if nodes are equally spaced along every axis
+    virtual bool isUniform() const = 0;
+    /*
+    * Adaptive refinement of sub-box of the grid
+    *
+    * Creates compact over box between nodes first and last (positions, first <= last on every axis), which contains
+    * all nodes of this compact from the box and midpoints between neighbour ones, i.e. 2 * (last - first) + 1 nodes
+    * along each axis. Nodes of the refinement with even positions along all axes coincide with nodes of this compact
+    */
+    virtual ICompact* createRefinement(IMultiIndex const * const &first, IMultiIndex const * const &last) const = 0;
+    /*
+    * Method writes to out (row-major, in bypassOrder numbering) only nodes having odd position along some axis, i.e.
+    * for refinement created by createRefinement() exactly new nodes, which aren't nodes of refined compact
+    *
+    * @param [in] capacity Quantity of rows in out
+    *
+    * @param [out] count Quantity of such nodes, only first capacity of them are written
+    */
+    virtual RC generateRefinementNodes(IMultiIndex const * const &bypassOrder, double * const &out, size_t capacity, size_t &count) const = 0;
 
     //  grid используется для задания сетки на получившемся пересечении
     static ICompact* createIntersection(ICompact const *op1, ICompact const *op2, IMultiIndex const* const grid, double tol);
     /* CompactSpan - компактная оболочка: строим наименьшее компактное множество, содержащее 2 переданных */
     static ICompact* createCompactSpan(ICompact const *op1, ICompact const *op2, IMultiIndex const* const grid);
 
+    /*
+    * Batch versions: results[i] is intersection/span of op and others[i], nullptr if intersection is empty
+    *
+    * Boxes are processed without any temporary IVector, only resulting compacts are allocated. On error no results are
+    * left allocated
+    *
+    * @param [in] results Caller-owned array of count pointers
+    */
+    static RC createIntersections(ICompact const *op, ICompact const * const *others, size_t count, IMultiIndex const* const grid, double tol, ICompact **results);
+    static RC createCompactSpans(ICompact const *op, ICompact const * const *others, size_t count, IMultiIndex const* const grid, ICompact **results);
+
     class IIterator {
     public:
         virtual IIterator * getNext() = 0;
@@ -59,6 +162,10 @@ public:
         * Method copy data from vector in ISet to vector val
         */
         virtual RC getVectorCoords(IVector * const& val) const = 0;
+        /*
+        * Method copy coordinates of current node to caller-owned buffer of dim doubles
+        */
+        virtual RC getVectorCoords(double * const& buf, size_t dim) const = 0;
 
         virtual ~IIterator() = 0;
 
@@ -70,9 +177,30 @@ public:
         IIterator() = default;
     };
 
+    // Strategies of grid bypass, see getBegin(bypassOrder, traversal, tileSizes)
+    enum class TRAVERSAL {
+        LEXICOGRAPHIC, // axes are iterated as odometer digits, the first axis of bypassOrder is the fastest one
+        TILED,         // grid is split into tiles, nodes of a tile are visited lexicographically, then the next tile
+        MORTON,        // Z-order curve, nodes close in bypass are close in grid
+        HILBERT        // Hilbert curve, for grids of 2^k nodes per axis consecutive nodes are neighbours in grid
+    };
+
     virtual IIterator* getIterator(IMultiIndex const * const&index, IMultiIndex const * const &bypassOrder) const = 0;
     // возвращает итератор на левейшую границу
     virtual IIterator* getBegin(IMultiIndex const * const &bypassOrder) const = 0;
+    /*
+    * Returns iterator on the left boundary, which visits every node once in order given by traversal
+    *
+    * Tiles and curves keep neighbours of a node close in bypass, so stencil-like computations reusing values of
+    * neighbour nodes stay in cache. Curves are built over the smallest cube of 2^k nodes per axis covering the grid,
+    * its nodes outside the grid are skipped
+    *
+    * @param [in] bypassOrder Order of axes, the first one is the fastest one inside tiles and the least significant in
+    * curve codes
+    *
+    * @param [in] tileSizes Quantities of nodes of tile along axes, required for TILED only
+    */
+    virtual IIterator* getBegin(IMultiIndex const * const &bypassOrder, TRAVERSAL traversal, IMultiIndex const * const &tileSizes = nullptr) const = 0;
     // возвращает итератор на правейшую границу
     virtual IIterator* getEnd(IMultiIndex const * const &bypassOrder) const = 0;
     
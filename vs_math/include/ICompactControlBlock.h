@@ -21,6 +21,17 @@ public:
     * @param [in] val Buffer for vector data
     */
     virtual RC get(IMultiIndex const * const &currentIndex, IVector* const &val) const = 0;
+    /*
+    * Control block moves iterator forward like get(currentIndex, bypassOrder) and updates only coordinates of axes,
+    * whose position was changed
+    *
+    * @param [in] currentIndex Multi-index of current iterator position
+    *
+    * @param [in] bypassOrder Multi-index, that defining bypass orred of axis
+    *
+    * @param [in] coords Caller-owned buffer of getDim() doubles holding coordinates of currentIndex
+    */
+    virtual RC get(IMultiIndex * const &currentIndex, IMultiIndex const * const &bypassOrder, double * const &coords) const = 0;
 
     virtual ~ICompactControlBlock() = 0;
 
@@ -0,0 +1,63 @@
+#pragma once
+#include "ICompact.h"
+#include "Interfacedllexport.h"
+#include "RC.h"
+#include <cstddef>
+
+/*
+ * Spatial index over a fixed collection of compacts for fast point location
+ *
+ * Compacts are referred by their position in array passed to createCompactIndex(). Index copies boundaries of
+ * compacts, so they may be destroyed after creation. Errors are logged with ICompact::getLogger()
+ */
+class LIB_EXPORT ICompactIndex {
+public:
+    /*
+    * Builds bounding volume hierarchy over compacts
+    *
+    * @param [in] compacts Array of count compacts of the same dimension
+    *
+    * @param [in] threads Quantity of threads for building, 0 means all hardware threads
+    */
+    static ICompactIndex* createCompactIndex(ICompact const * const *compacts, size_t count, size_t threads = 0);
+
+    virtual size_t getDim() const = 0;
+    virtual size_t getSize() const = 0;
+
+    /*
+    * Method finds all compacts containing point
+    *
+    * @param [in] point Coordinates of point, getDim() doubles
+    *
+    * @param [in] found Caller-owned buffer for capacity compact numbers
+    *
+    * @param [out] count Quantity of compacts containing point, only first capacity of them are written to found
+    */
+    virtual RC findContaining(double const * const &point, size_t * const &found, size_t capacity, size_t &count) const = 0;
+    /*
+    * Method finds all compacts intersecting box [left, right] (same semantic of buffers as findContaining)
+    */
+    virtual RC findOverlapping(double const * const &left, double const * const &right, size_t * const &found, size_t capacity, size_t &count) const = 0;
+
+    /*
+    * Batch version of findContaining for points given as row-major block
+    *
+    * Result is written in compressed form: numbers of compacts containing point i are
+    * found[offsets[i]], ..., found[offsets[i + 1] - 1]. If offsets[count] > capacity, only offsets are written and
+    * INDEX_OUT_OF_BOUND is returned, so call can be repeated with larger buffer
+    *
+    * @param [in] offsets Caller-owned buffer of count + 1 elements
+    *
+    * @param [in] threads Quantity of threads, 0 means all hardware threads
+    */
+    virtual RC findContainingBatch(double const * const &rows, size_t count, size_t * const &offsets, size_t * const &found, size_t capacity, size_t threads = 0) const = 0;
+
+    virtual ~ICompactIndex() = 0;
+
+private:
+    ICompactIndex(const ICompactIndex&) = delete;
+    ICompactIndex& operator=(const ICompactIndex&) = delete;
+
+protected:
+    ICompactIndex() = default;
+};
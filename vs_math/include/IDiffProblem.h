@@ -5,7 +5,10 @@
 
 class LIB_EXPORT IDiffProblem : public IProblem {
 public:
-    static IDiffProblem * createDiffProblem(ICompact const * const &params, ICompact const * const &args);
+    /*
+    * Same as IProblem::createProblem(), derivatives are taken from kernel or approximated with finite differences
+    */
+    static IDiffProblem * createDiffProblem(ICompact const * const &params, ICompact const * const &args, Kernel const &kernel);
     IDiffProblem * clone() const override = 0;
 
     static RC setLogger(ILogger * const logger);
@@ -20,9 +23,16 @@ public:
     double evalByParams(IVector const *const &params) const override = 0;
     double evalByArgs(IVector const *const &args) const override = 0;
 
+    /*
+    * Derivative of order index[i] along axis i of args (params) at args (params), NaN on error. Values of kernel
+    * functions are used when possible, otherwise central differences of order index[i] along every axis
+    */
     virtual double evalDerivativeByArgs(IVector const * const &args, IMultiIndex const * const &index) const = 0;
     virtual double evalDerivativeByParams(IVector const * const &params, IMultiIndex const * const &index) const = 0;
 
+    /*
+    * Gradient written to val of getArgsDim() (getParamsDim()) coordinates, central differences cost 2 * dim values
+    */
     virtual RC evalGradientByArgs(IVector const * const &args, IVector * const &val) const = 0;
     virtual RC evalGradientByParams(IVector const * const &params, IVector * const &val) const = 0;
 
@@ -0,0 +1,51 @@
+#pragma once
+#include "IMultiIndex.h"
+#include "Interfacedllexport.h"
+#include "RC.h"
+#include <cstddef>
+
+/*
+ * Description of grid nodes placement along every axis of a compact
+ *
+ * Nodes of an axis are given by their relative positions in [0, 1]: first node is 0 (left boundary), last node is 1
+ * (right boundary), positions strictly increase. Single node of an axis is placed at the left boundary. Errors are
+ * logged with ICompact::getLogger()
+ */
+class LIB_EXPORT IGridSpec {
+public:
+    enum class SPACING {
+        UNIFORM,   // equal distances between neighbour nodes
+        CHEBYSHEV, // Chebyshev-Lobatto nodes (1 - cos(pi * k / (n - 1))) / 2, dense near boundaries
+        GEOMETRIC, // distances between neighbour nodes form geometric progression with given ratio
+        CUSTOM     // positions given by setAxisNodes()
+    };
+
+    /*
+    * Create spec of uniform grid with given quantities of nodes
+    */
+    static IGridSpec* createGridSpec(IMultiIndex const * const &nodeQuantities);
+    virtual IGridSpec* clone() const = 0;
+
+    virtual size_t getDim() const = 0;
+    virtual size_t getNodes(size_t axis) const = 0;
+    virtual SPACING getSpacing(size_t axis) const = 0;
+    // Relative positions of getNodes(axis) nodes, pointer is valid until axis is changed
+    virtual double const* getAxisNodes(size_t axis) const = 0;
+    // True if all axes are uniform
+    virtual bool isUniform() const = 0;
+
+    /*
+    * @param [in] ratio Ratio of neighbour distances for GEOMETRIC spacing (next / previous), ignored otherwise
+    */
+    virtual RC setAxis(size_t axis, SPACING spacing, size_t nodes, double ratio = 1) = 0;
+    virtual RC setAxisNodes(size_t axis, size_t nodes, double const * const &positions) = 0;
+
+    virtual ~IGridSpec() = 0;
+
+private:
+    IGridSpec(const IGridSpec&) = delete;
+    IGridSpec& operator=(const IGridSpec&) = delete;
+
+protected:
+    IGridSpec() = default;
+};
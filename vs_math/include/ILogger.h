@@ -1,17 +1,79 @@
 #pragma once
 #include "RC.h"
 #include "Interfacedllexport.h"
+#include "Stats.h"
+#include <cstddef>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 /*
 * Defines for comfortable logging with information about caller
+*
+* Level and module of record are checked inline before virtual call of logger, nullptr logger is ignored.
+* VS_MATH_LOG_LEVEL is the most verbose level compiled in: -1 none, 0 SEVERE, 1 WARNING, 2 INFO. By default it's 0
+* if NDEBUG is defined and 2 otherwise, so release builds don't even evaluate arguments of WARNING and INFO calls
 */
+#ifndef VS_MATH_LOG_LEVEL
+#ifdef NDEBUG
+#define VS_MATH_LOG_LEVEL 0
+#else
+#define VS_MATH_LOG_LEVEL 2
+#endif
+#endif
 
+#define SendLog(Logger, Mod, Code, Lvl)                                                                                \
+    ((void)ILogger::send((Logger), (Mod), (Code), (Lvl), __FILE__, __func__, __LINE__))
+#if VS_MATH_LOG_LEVEL >= 0
+#define SendSevere(Logger, Mod, Code) SendLog(Logger, Mod, Code, ILogger::Level::SEVERE)
+#else
+#define SendSevere(Logger, Mod, Code) ((void)0)
+#endif
+#if VS_MATH_LOG_LEVEL >= 1
+#define SendWarning(Logger, Mod, Code) SendLog(Logger, Mod, Code, ILogger::Level::WARNING)
+#else
+#define SendWarning(Logger, Mod, Code) ((void)0)
+#endif
+#if VS_MATH_LOG_LEVEL >= 2
+#define SendInfo(Logger, Mod, Code) SendLog(Logger, Mod, Code, ILogger::Level::INFO)
+#else
+#define SendInfo(Logger, Mod, Code) ((void)0)
+#endif
+
+namespace LoggerDetail {
 /*
-#define SendLog(Logger, Code, Level) Logger->log((Code), (Level), __FILE__, __func__, __LINE__)
-#define SendSevere(Logger, Code) Logger->severe((Code), __FILE__, __func__, __LINE__)
-#define SendWarning(Logger, Code) Logger->warning((Code), __FILE__, __func__, __LINE__)
-#define SendInfo(Logger, Code) Logger->info((Code), __FILE__, __func__, __LINE__)
+* Relaxed atomic access to plain integer. std::atomic member would make exported ILogger a class with members without
+* DLL interface (C4251), aligned volatile long is accessed atomically by MSVC
 */
+inline long load(long const &value) {
+#ifdef _MSC_VER
+    return *(long const volatile *)&value;
+#else
+    return __atomic_load_n(&value, __ATOMIC_RELAXED);
+#endif
+}
+inline void store(long &value, long desired) {
+#ifdef _MSC_VER
+    _InterlockedExchange((long volatile *)&value, desired);
+#else
+    __atomic_store_n(&value, desired, __ATOMIC_RELAXED);
+#endif
+}
+inline void fetchOr(long &value, long bits) {
+#ifdef _MSC_VER
+    _InterlockedOr((long volatile *)&value, bits);
+#else
+    __atomic_fetch_or(&value, bits, __ATOMIC_RELAXED);
+#endif
+}
+inline void fetchAnd(long &value, long bits) {
+#ifdef _MSC_VER
+    _InterlockedAnd((long volatile *)&value, bits);
+#else
+    __atomic_fetch_and(&value, bits, __ATOMIC_RELAXED);
+#endif
+}
+}; // namespace LoggerDetail
 
 class LIB_EXPORT ILogger {
 public:
@@ -21,8 +83,32 @@ public:
         INFO     // Optional information
     };
 
+    /*
+    * Parts of library, which may be enabled or disabled for logging independently
+    */
+    enum class Module {
+        VECTOR,
+        SET,
+        COMPACT,
+        MULTI_INDEX,
+        PROBLEM,
+        SOLVER,
+        AMOUNT
+    };
+
+    /*
+    * Behaviour of asynchronous logger, when its queue of records is full
+    */
+    enum class Overflow {
+        DROP,  // Record is discarded, quantity of discarded records is reported with the next written ones
+        BLOCK  // Caller waits until background thread frees a place in queue
+    };
+
     /*
     * Create logger to log into standard output
+    *
+    * Loggers created by createLogger() aren't thread-safe, wrap them with createThreadSafeLogger() to log from several
+    * threads. Static setLogger() of library interfaces may be called from any thread
     */
     static ILogger *createLogger();
 
@@ -35,6 +121,65 @@ public:
     */
     static ILogger *createLogger(const char* const& filename, bool overwrite = true);
 
+    /*
+    * Create logger, which only puts fixed-size records into lock-free queue, records are formatted and written into
+    * standard output by background thread in batches
+    *
+    * srcfile and function are stored as pointers, so they must outlive logger, as __FILE__ and __func__ do
+    *
+    * @param [in] capacity Quantity of records in queue, rounded up to power of two
+    *
+    * @param [in] policy Behaviour when queue is full
+    */
+    static ILogger *createAsyncLogger(size_t capacity = 4096, Overflow policy = Overflow::DROP);
+
+    /*
+    * Same as createAsyncLogger() but writes into file, see createLogger(filename, overwrite)
+    *
+    * Returns nullptr if file couldn't be opened
+    */
+    static ILogger *createAsyncLogger(const char* const& filename, bool overwrite = true, size_t capacity = 4096,
+                                      Overflow policy = Overflow::DROP);
+
+    /*
+    * Create logger writing fixed-width binary records with monotonic nanosecond timestamps, srcfile and function are
+    * interned into string table of log. Format is described in BinaryLog.h, vs_math-logdecode turns log into text or
+    * CSV
+    *
+    * Returns nullptr if file couldn't be opened
+    */
+    static ILogger *createBinaryLogger(const char* const& filename, bool overwrite = true);
+
+    /*
+    * Create decorator, which collapses repeated records of the same call site (code, level, srcfile, line)
+    *
+    * The first record of call site is passed to logger at once, the following ones are only counted until interval
+    * passes, then the next record is passed with logRepeated() and quantity of records it stands for. Decorator has no
+    * thread of its own: counts of call sites, which went silent, are passed by the first record of any call site after
+    * interval, by flush() and destructor, so decorator must be deleted before logger, which isn't owned by it. Records
+    * without information about caller and records of call sites beyond internal table are passed as is
+    *
+    * @param [in] logger Logger receiving records
+    *
+    * @param [in] interval Minimal time in seconds between records of one call site, at most INT64_MAX nanoseconds
+    */
+    static ILogger *createRateLimitedLogger(ILogger* const& logger, double interval = 1.0);
+
+    /*
+    * Create decorator, which may be used from several threads at once
+    *
+    * Every thread puts its records with timestamps into its own buffer, buffers of exited threads are reused by threads
+    * started later. When buffer of some thread is full, records are older than 0.1 second or flush() is called,
+    * buffers of all threads are drained and merged by time, then records are passed to logger by one thread at a time,
+    * so logger doesn't need to be thread-safe. Records left are passed by destructor, so decorator must be deleted
+    * before logger, which isn't owned by it
+    *
+    * @param [in] logger Logger receiving records
+    *
+    * @param [in] bufferSize Quantity of records in buffer of one thread
+    */
+    static ILogger *createThreadSafeLogger(ILogger* const& logger, size_t bufferSize = 256);
+
     /*
     * Logging is supposed to be implemented by receiving RC error code and writing corresponding string to output
     * 
@@ -61,45 +206,105 @@ public:
     virtual RC log(RC code, Level level) = 0;
 
     /*
-    * Same as log() but Level == SEVERE
+    * Same as log() but the record stands for count identical records of the same call site, which were collapsed into
+    * one by rate-limited logger. By default count is ignored
+    */
+    virtual RC logRepeated(RC code, Level level, const char* const& srcfile, const char* const& function, int line,
+                           size_t) {
+        return log(code, level, srcfile, function, line);
+    };
+
+    /*
+    * Same as log() but Level == SEVERE, record is skipped if SEVERE is below threshold
     */
     virtual RC severe(RC code, const char* const& srcfile, const char* const& function, int line) {
-        return log(code, Level::SEVERE, srcfile, function, line);
+        return isEnabled(Level::SEVERE) ? log(code, Level::SEVERE, srcfile, function, line) : RC::SUCCESS;
     };
 
     /*
     * Same as severe() but without information about caller
     */
     virtual RC severe(RC code) {
-        return log(code, Level::SEVERE);
+        return isEnabled(Level::SEVERE) ? log(code, Level::SEVERE) : RC::SUCCESS;
     };
 
     /*
-    * Same as log() but Level == WARNING
+    * Same as log() but Level == WARNING, record is skipped if WARNING is below threshold
     */
     virtual RC warning(RC code, const char* const& srcfile, const char* const& function, int line) {
-        return log(code, Level::WARNING, srcfile, function, line);
+        return isEnabled(Level::WARNING) ? log(code, Level::WARNING, srcfile, function, line) : RC::SUCCESS;
     };
 
     /*
     * Same as warning() but without information about caller
     */
     virtual RC warning(RC code) {
-        return log(code, Level::WARNING);
+        return isEnabled(Level::WARNING) ? log(code, Level::WARNING) : RC::SUCCESS;
     };
 
     /*
-    * Same as log() but Level == INFO
+    * Same as log() but Level == INFO, record is skipped if INFO is below threshold
     */
     virtual RC info(RC code, const char* const& srcfile, const char* const& function, int line) {
-        return log(code, Level::INFO, srcfile, function, line);
+        return isEnabled(Level::INFO) ? log(code, Level::INFO, srcfile, function, line) : RC::SUCCESS;
     };
 
     /*
     * Same as info() but without information about caller
     */
     virtual RC info(RC code) {
-        return log(code, Level::INFO);
+        return isEnabled(Level::INFO) ? log(code, Level::INFO) : RC::SUCCESS;
+    };
+
+    /*
+    * Sets the least important level, which is still logged, INFO by default
+    *
+    * Filter isn't virtual, so Send* macros skip disabled records without calling logger, it may be changed while other
+    * threads log
+    */
+    void setLevel(Level level) {
+        LoggerDetail::store(threshold, (long)level);
+    }
+    Level getLevel() const {
+        return (Level)LoggerDetail::load(threshold);
+    }
+
+    /*
+    * Enables or disables records of module, all modules are enabled by default
+    */
+    void setModuleEnabled(Module module, bool enabled) {
+        if (enabled)
+            LoggerDetail::fetchOr(modules, 1L << (unsigned)module);
+        else
+            LoggerDetail::fetchAnd(modules, ~(1L << (unsigned)module));
+    }
+    bool isModuleEnabled(Module module) const {
+        return (LoggerDetail::load(modules) >> (unsigned)module & 1L) != 0;
+    }
+
+    bool isEnabled(Level level) const {
+        return (long)level <= LoggerDetail::load(threshold);
+    }
+    bool isEnabled(Level level, Module module) const {
+        return isEnabled(level) && isModuleEnabled(module);
+    }
+
+    /*
+    * Logs record of module if logger isn't nullptr and both level and module are enabled, used by Send* macros
+    */
+    static RC send(ILogger* const logger, Module module, RC code, Level level, const char* srcfile,
+                   const char* function, int line) {
+        STATS_COUNT(LOG_CALLS);
+        if (logger == nullptr || !logger->isEnabled(level, module))
+            return RC::SUCCESS;
+        return logger->log(code, level, srcfile, function, line);
+    }
+
+    /*
+    * Waits until all records logged before the call are written to output
+    */
+    virtual RC flush() {
+        return RC::SUCCESS;
     };
 
     virtual ~ILogger() = 0;
@@ -108,6 +313,9 @@ private:
     ILogger(const ILogger &) = delete;
     ILogger &operator=(const ILogger &) = delete;
 
+    long threshold; // Level as number
+    long modules;   // bit per Module
+
 protected:
-    ILogger() = default;
+    ILogger() : threshold((long)Level::INFO), modules((1L << (unsigned)Module::AMOUNT) - 1) {}
 };
\ No newline at end of file
@@ -3,10 +3,45 @@
 #include "ILogger.h"
 #include "IVector.h"
 #include "Interfacedllexport.h"
+#include <cstddef>
 
 class LIB_EXPORT IProblem {
 public:
-    static IProblem * createProblem(ICompact const * const &params, ICompact const * const &args);
+    typedef double (*EvalFunction)(double const *args, size_t argsDim, double const *params, size_t paramsDim, void *context);
+    typedef void (*BatchFunction)(double const *rows, size_t n, size_t argsDim, double const *params, size_t paramsDim, double *out, void *context);
+    typedef void (*GradientFunction)(double const *args, size_t argsDim, double const *params, size_t paramsDim, double *grad, void *context);
+    typedef double (*DerivativeFunction)(double const *args, size_t argsDim, double const *params, size_t paramsDim, size_t const *orders, void *context);
+
+    /*
+    * User function f(args, params) given as plain functions, so that it may come from plugin or another module
+    *
+    * Only eval is required. Missing batch function is replaced with calls of eval per row, missing derivatives (used by
+    * IDiffProblem) with finite differences. Functions may be called from several threads at once with the same context.
+    * ProblemKernel.h builds kernel from C++ callable
+    */
+    struct Kernel {
+        // Value at one point
+        EvalFunction eval;
+        // Values at n args given as row-major block (n rows of argsDim doubles), writes n values to out. Used by
+        // evalByArgsBatch() only, batches of params are evaluated by eval per row
+        BatchFunction evalBatch;
+        // Gradient by args (argsDim values) or by params (paramsDim values) written to grad
+        GradientFunction gradientByArgs;
+        GradientFunction gradientByParams;
+        // Mixed derivative of order orders[i] along axis i of args or params
+        DerivativeFunction derivativeByArgs;
+        DerivativeFunction derivativeByParams;
+        void *context;
+    };
+
+    /*
+    * @param [in] params Domain of params, nullptr if function has no params
+    *
+    * @param [in] args Domain of args
+    *
+    * @param [in] kernel Function, its context must outlive problem and all its clones
+    */
+    static IProblem * createProblem(ICompact const * const &params, ICompact const * const &args, Kernel const &kernel);
     virtual IProblem * clone() const = 0;
 
     static RC setLogger(ILogger * const logger);
@@ -18,9 +53,34 @@ public:
     virtual RC setParams(IVector const * const &params) = 0;
     virtual RC setArgs(IVector const * const &args) = 0;
 
+    virtual size_t getArgsDim() const = 0;
+    // 0 if function has no params
+    virtual size_t getParamsDim() const = 0;
+
+    /*
+    * Value at args with params set by setParams() or at params with args set by setArgs(), NaN on error
+    *
+    * Only dimension is checked, domain membership is checked by isValidArgs() and isValidParams()
+    */
     virtual double evalByArgs(IVector const * const &args) const = 0;
     virtual double evalByParams(IVector const * const &params) const = 0;
 
+    /*
+    * Values at n points given as row-major block (n rows of getArgsDim() or getParamsDim() doubles)
+    *
+    * Rows are split into tiles, large batches are evaluated by several threads. Tiles of args are evaluated by batch
+    * function of kernel, tiles of params by eval per row. Rows aren't checked against domain
+    *
+    * @param [in] out Caller-owned buffer of n doubles
+    */
+    virtual RC evalByArgsBatch(double const * const &rows, size_t n, double * const &out) const = 0;
+    virtual RC evalByParamsBatch(double const * const &rows, size_t n, double * const &out) const = 0;
+
+    /*
+    * Quantity of threads used by batch evaluation, 0 means all hardware threads (default), 1 disables threads
+    */
+    virtual RC setThreads(size_t threads) = 0;
+
     virtual ~IProblem() = 0;
 
 private:
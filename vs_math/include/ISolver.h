@@ -4,26 +4,133 @@
 #include "ISet.h"
 #include "IProblem.h"
 #include "Interfacedllexport.h"
+#include <cstddef>
 
 class LIB_EXPORT ISolver {
+public:
+    enum class Method {
+        GRADIENT_DESCENT, // steepest descent
+        BFGS,             // dense approximation of inverse Hessian, dim^2 doubles of workspace
+        LBFGS             // limited-memory BFGS, keeps the last Options::history steps
+    };
+
+    enum class LineSearch {
+        ARMIJO, // backtracking until sufficient decrease, gradient is evaluated at accepted point only
+        WOLFE   // strong Wolfe conditions, keep curvature of quasi-Newton updates positive
+    };
+
+    /*
+    * Starting points of global mode: local solves run from every seed in parallel, the best distinct minima are
+    * collected. Seeds are generated and solved one by one, so memory doesn't depend on their quantity
+    */
+    enum class Seeds {
+        NONE,  // single local solve from initArg
+        GRID,  // every node of grid of domain
+        HALTON // Options::seedsCount points of Halton sequence in box of domain, for grids too large to visit
+    };
+
+    /*
+    * Settings of gradient solver. Minimization runs until projected gradient is small, until value stops decreasing
+    * or until maxIterations
+    */
+    struct Options {
+        Method method = Method::LBFGS;
+        LineSearch lineSearch = LineSearch::WOLFE;
+        size_t maxIterations = 1000;
+        // Maximal coordinate of projected gradient P(x - g) - x at solution
+        double gradientTolerance = 1e-8;
+        // Relative decrease of value per iteration, below which solver stops
+        double valueTolerance = 1e-15;
+        // Pairs of steps and gradient changes kept by L-BFGS
+        size_t history = 8;
+
+        Seeds seeds = Seeds::NONE;
+        // Quantity of HALTON seeds
+        size_t seedsCount = 64;
+        // Threads of global mode, 0 means all hardware threads
+        size_t threads = 0;
+        // Converged solutions closer than it in Chebyshev norm are the same optimum
+        double optimaTolerance = 1e-6;
+        // The best distinct optima kept by global mode and returned by getOptima()
+        size_t optimaCount = 64;
+    };
+
+    /*
+    * Settings of grid search: every node of domain grid is evaluated, then grid is refined around the best nodes
+    */
+    struct GridOptions {
+        // Best nodes kept by search, refined and returned by getOptima()
+        size_t best = 8;
+        // Refinements: every one evaluates sub-grid with halved step over cells adjacent to each of the best nodes
+        size_t levels = 0;
+        // Threads of evaluation, 0 means all hardware threads
+        size_t threads = 0;
+    };
+
+    // Outcome of the last solve, counters of global mode are sums over all local solves
+    struct Summary {
+        size_t starts;      // local solves
+        size_t iterations;
+        size_t evaluations; // values of function, including line search trials
+        size_t gradients;
+        double value;       // value at solution
+        bool converged;     // gradient or value tolerance was reached before maxIterations or line search failure,
+                            // for global mode: solution is a converged one
+    };
+
+    /*
+    * Gradient solver over IDiffProblem::evalGradientByArgs() (evalGradientByParams()), L-BFGS with default options
+    *
+    * Search is restricted to box of args (params) domain: steps are projected onto it. Workspace is allocated by
+    * setProblem(), iterations don't allocate memory
+    */
     static ISolver* createSolver();
+    static ISolver* createSolver(Options const &options);
+    /*
+    * Grid search over IProblem::evalByArgsBatch() (evalByParamsBatch()), doesn't need derivatives
+    *
+    * Nodes are generated in blocks, blocks are evaluated by several threads, each keeping its own GridOptions::best
+    * nodes: node is compared with the worst kept one and dropped at once unless it's better. Search requires domain,
+    * its grid is the first level. Memory is allocated per solve, not per node
+    *
+    * Summary: iterations are grids searched (1 + levels), evaluations are nodes evaluated. Solve fails with NOT_NUMBER
+    * if no node has finite value. initArg is ignored and may be nullptr, solverParams[0] may be vector {levels}
+    * overriding options
+    */
+    static ISolver* createGridSolver(GridOptions const &options);
     static RC setLogger(ILogger* const pLogger);
     static ILogger* getLogger();
-    
+
     virtual ISolver* clone() const = 0;
 
+    // Problem is cloned, gradient solver requires IDiffProblem (as all problems of IProblem::createProblem() are).
+    // Domains of other dimension are dropped
     virtual RC setProblem(IProblem const* const& pProblem) = 0;
 
     virtual bool isValidArgsDomain(ICompact const* const& args) const = 0;
     virtual bool isValidParamsDomain(ICompact const* const& params) const = 0;
+    // Box of compact bounds search, without domain search is unconstrained
     virtual RC setArgsDomain(ICompact const* const& args) = 0;
     virtual RC setParamsDomain(ICompact const* const& params) = 0;
 
     // initArg - starting point (x0)
     // solverParams - defined by developer of exact Solver, described in his header
+    //
+    // Gradient solver: starting point is projected onto domain. solverParams may be nullptr, otherwise solverParams[0]
+    // (if not nullptr) is vector {maxIterations, gradientTolerance} overriding options for this solve. Params of
+    // problem (args for solveByParams) must be set before setProblem()
+    //
+    // Global mode (Options::seeds) requires domain, initArg is used as one more seed if it isn't nullptr. Solution is
+    // the best converged local solution, or the best one if none of them converged
     virtual RC solveByArgs(IVector const* const& initArg, IVector* const* const& solverParams) = 0;
     virtual RC solveByParams(IVector const* const& initParam, IVector* const* const& solverParams) = 0;
+    // Creates new vector with the last solution, caller owns it
     virtual RC getSolution(IVector*& solution) const = 0;
+    // Creates new set of distinct converged solutions of the last solve in order of increasing value (at most
+    // Options::optimaCount of the best ones), caller owns it.
+    // After local solve the set holds its solution only, after grid search - the best nodes of the last level
+    virtual RC getOptima(ISet*& optima) const = 0;
+    virtual Summary getSummary() const = 0;
 
     virtual ~ISolver() = 0;
 
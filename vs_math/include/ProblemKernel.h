@@ -0,0 +1,89 @@
+#pragma once
+#include "IProblem.h"
+#include <cstddef>
+
+/*
+ * Adapters of C++ callables to IProblem::Kernel
+ *
+ * Kernel functions are instantiated here, in module of caller, so the loop of batch function calls f inline and the
+ * compiler is free to vectorize it. Kernel keeps pointers to callables, they must outlive problem and its clones
+ *
+ * Example:
+ *     auto sphere = [](double const *x, double const *) { return x[0] * x[0] + x[1] * x[1]; };
+ *     IProblem *problem = IProblem::createProblem(nullptr, args, ProblemKernel::make(sphere));
+ *
+ *     auto grad = [](double const *x, double const *, double *g) { g[0] = 2 * x[0]; g[1] = 2 * x[1]; };
+ *     auto fn = ProblemKernel::withGradient(sphere, grad);
+ *     IDiffProblem *diff = IDiffProblem::createDiffProblem(nullptr, args, fn.kernel());
+ */
+namespace ProblemKernel {
+namespace Detail {
+template <class F>
+double eval(double const *args, size_t, double const *params, size_t, void *context) {
+    return (*static_cast<F const *>(context))(args, params);
+}
+
+template <class F>
+void evalBatch(double const *rows, size_t n, size_t argsDim, double const *params, size_t, double *out,
+               void *context) {
+    F const &f = *static_cast<F const *>(context);
+    for (size_t row = 0; row < n; ++row)
+        out[row] = f(rows + row * argsDim, params);
+}
+
+template <class Holder>
+double evalHeld(double const *args, size_t, double const *params, size_t, void *context) {
+    return static_cast<Holder const *>(context)->f(args, params);
+}
+
+template <class Holder>
+void evalBatchHeld(double const *rows, size_t n, size_t argsDim, double const *params, size_t, double *out,
+                   void *context) {
+    Holder const &holder = *static_cast<Holder const *>(context);
+    for (size_t row = 0; row < n; ++row)
+        out[row] = holder.f(rows + row * argsDim, params);
+}
+
+template <class Holder>
+void gradientHeld(double const *args, size_t, double const *params, size_t, double *grad, void *context) {
+    static_cast<Holder const *>(context)->gradient(args, params, grad);
+}
+} // namespace Detail
+
+/*
+ * Kernel of f(args, params) -> double, where args and params are pointers to coordinates
+ */
+template <class F>
+IProblem::Kernel make(F const &f) {
+    IProblem::Kernel kernel = {&Detail::eval<F>, &Detail::evalBatch<F>, nullptr, nullptr, nullptr, nullptr,
+                               const_cast<void *>(static_cast<void const *>(&f))};
+    return kernel;
+}
+// Kernel would keep pointer to temporary
+template <class F>
+IProblem::Kernel make(F const &&) = delete;
+
+/*
+ * Copies of f and of its exact gradient by args: gradient(args, params, grad) writes argsDim values to grad.
+ * Object must outlive problems created with its kernel()
+ */
+template <class F, class G>
+struct WithGradient {
+    F f;
+    G gradient;
+
+    IProblem::Kernel kernel() const & {
+        IProblem::Kernel kernel = {&Detail::evalHeld<WithGradient>, &Detail::evalBatchHeld<WithGradient>,
+                                   &Detail::gradientHeld<WithGradient>, nullptr, nullptr, nullptr,
+                                   const_cast<void *>(static_cast<void const *>(this))};
+        return kernel;
+    }
+    IProblem::Kernel kernel() const && = delete;
+};
+
+template <class F, class G>
+WithGradient<F, G> withGradient(F f, G gradient) {
+    WithGradient<F, G> result = {f, gradient};
+    return result;
+}
+} // namespace ProblemKernel
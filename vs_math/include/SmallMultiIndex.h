@@ -0,0 +1,143 @@
+#pragma once
+#include "IMultiIndex.h"
+#include "RC.h"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+/*
+ * Multi-index with value semantics for hot loops over grids
+ *
+ * Up to INLINE_DIM axes are stored inside the object, so creating and copying it doesn't touch heap, larger
+ * multi-indices fall back to heap storage. Unlike IMultiIndex, axis access and increment are inline non-virtual calls
+ * without bounds logging. Converts from and to IMultiIndex. Object of dimension 0 is empty, it's also the state after
+ * failed allocation (logged with IMultiIndex::getLogger())
+ */
+class SmallMultiIndex {
+  public:
+    static const size_t INLINE_DIM = 8;
+
+    SmallMultiIndex() : dim(0), data(inline_data) {}
+    explicit SmallMultiIndex(size_t dim, size_t value = 0) : dim(0), data(inline_data) {
+        if (resize(dim))
+            for (size_t idx = 0; idx < dim; ++idx)
+                data[idx] = value;
+    }
+    explicit SmallMultiIndex(IMultiIndex const *index) : dim(0), data(inline_data) {
+        if (index != nullptr)
+            setData(index->getDim(), index->getData());
+    }
+    SmallMultiIndex(const SmallMultiIndex &other) : dim(0), data(inline_data) { setData(other.dim, other.data); }
+    SmallMultiIndex(SmallMultiIndex &&other) : dim(0), data(inline_data) { *this = std::move(other); }
+    SmallMultiIndex &operator=(const SmallMultiIndex &other) {
+        if (this != &other)
+            setData(other.dim, other.data);
+        return *this;
+    }
+    SmallMultiIndex &operator=(SmallMultiIndex &&other) {
+        if (this == &other)
+            return *this;
+        if (other.data != other.inline_data) {
+            release();
+            dim = other.dim;
+            data = other.data;
+            other.dim = 0;
+            other.data = other.inline_data;
+            return *this;
+        }
+        setData(other.dim, other.data);
+        return *this;
+    }
+    ~SmallMultiIndex() { release(); }
+
+    // Copy of dim axes of indices, named so that SmallMultiIndex(dim, 0) is never taken for nullptr indices
+    static SmallMultiIndex fromData(size_t dim, size_t const *indices) {
+        SmallMultiIndex index;
+        index.setData(dim, indices);
+        return index;
+    }
+
+    size_t getDim() const { return dim; }
+    bool isEmpty() const { return dim == 0; }
+    const size_t *getData() const { return data; }
+    size_t *getData() { return data; }
+    size_t operator[](size_t axis) const { return data[axis]; }
+    size_t &operator[](size_t axis) { return data[axis]; }
+
+    RC setData(size_t new_dim, size_t const *indices) {
+        if (indices == nullptr && new_dim > 0) {
+            SendSevere(IMultiIndex::getLogger(), ILogger::Module::MULTI_INDEX, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (!resize(new_dim))
+            return RC::ALLOCATION_ERROR;
+        if (new_dim > 0)
+            std::memmove(data, indices, new_dim * sizeof(size_t));
+        return RC::SUCCESS;
+    }
+    // Copies axes to index of the same dimension
+    RC copyTo(IMultiIndex *const &index) const {
+        if (index == nullptr) {
+            SendSevere(IMultiIndex::getLogger(), ILogger::Module::MULTI_INDEX, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        return index->setData(dim, data);
+    }
+    IMultiIndex *toMultiIndex() const { return IMultiIndex::createMultiIndex(dim, data); }
+
+    /*
+     * Odometer step over grid of limits[axis] nodes per axis, bypassOrder[0] is the fastest axis
+     *
+     * Returns quantity of axes (the first ones of bypassOrder) whose positions were changed, or 0 if index was the last
+     * node of the grid, then index is reset to the first node
+     */
+    inline size_t increment(const size_t *bypassOrder, const size_t *limits) {
+        for (size_t idx = 0; idx < dim; ++idx) {
+            size_t axis = bypassOrder[idx];
+            if (++data[axis] < limits[axis])
+                return idx + 1;
+            data[axis] = 0;
+        }
+        return 0;
+    }
+    inline size_t increment(const SmallMultiIndex &bypassOrder, const size_t *limits) {
+        return increment(bypassOrder.data, limits);
+    }
+
+  private:
+    size_t dim;
+    size_t *data; // inline_data or heap buffer
+    size_t inline_data[INLINE_DIM];
+
+    void release() {
+        if (data != inline_data)
+            delete[] data;
+        data = inline_data;
+        dim = 0;
+    }
+    bool resize(size_t new_dim) {
+        if (new_dim == dim)
+            return true;
+        if (new_dim <= INLINE_DIM) {
+            if (data != inline_data && new_dim > 0)
+                std::memcpy(inline_data, data, new_dim * sizeof(size_t));
+            if (data != inline_data)
+                delete[] data;
+            data = inline_data;
+            dim = new_dim;
+            return true;
+        }
+        STATS_COUNT(MULTI_INDEX_ALLOCATIONS);
+        size_t *heap = new (std::nothrow) size_t[new_dim];
+        if (heap == nullptr) {
+            release();
+            SendSevere(IMultiIndex::getLogger(), ILogger::Module::MULTI_INDEX, RC::ALLOCATION_ERROR);
+            return false;
+        }
+        release();
+        data = heap;
+        dim = new_dim;
+        return true;
+    }
+};
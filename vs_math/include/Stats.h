@@ -0,0 +1,140 @@
+#pragma once
+#include "Interfacedllexport.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Counters and timers of hot paths of the library
+ *
+ * They are compiled in only if VS_MATH_STATS is defined (CMake option of the same name), otherwise STATS_* macros
+ * expand to nothing and getStats() reports zeros. Every thread counts into its own block, which is written only by
+ * this thread without atomic read-modify-write, blocks of all threads are summed up on demand
+ */
+#ifdef VS_MATH_STATS
+#define STATS_COUNT(Name) Stats::count(Stats::Counter::Name, 1)
+#define STATS_ADD(Name, Value) Stats::count(Stats::Counter::Name, (Value))
+// Measures time till the end of enclosing scope, one per scope
+#define STATS_TIMER(Name) Stats::ScopeTimer stats_scope_timer(Stats::Timer::Name)
+#else
+#define STATS_COUNT(Name) ((void)0)
+#define STATS_ADD(Name, Value) ((void)0)
+#define STATS_TIMER(Name) ((void)0)
+#endif
+
+class LIB_EXPORT Stats {
+  public:
+    enum class Counter {
+        VECTOR_ALLOCATIONS,      // vectors created, including clones
+        VECTOR_CLONES,
+        VECTOR_EQUALS,           // calls of IVector::equals
+        SET_SCANS,               // linear searches over set
+        SET_SCANNED_VECTORS,     // vectors compared during them
+        COMPACT_ITERATOR_STEPS,
+        COMPACT_SWEEP_NODES,     // nodes produced by block and parallel sweeps
+        COMPACT_ALLOCATIONS,     // heap blocks of compact iterators, traversals and node buffers
+        MULTI_INDEX_ALLOCATIONS, // heap blocks of multi-indices, including small ones too long to be inline
+        LOG_CALLS,               // calls of Send* macros, including filtered ones
+        AMOUNT
+    };
+
+    enum class Timer {
+        SET_MAKE_UNION,
+        SET_MAKE_INTERSECTION,
+        SET_INSERT,
+        COMPACT_SWEEP, // generateNodes, generateRefinementNodes and parallelForEachNode
+        AMOUNT
+    };
+
+    // Block of one thread, fields are atomic only to be read by other threads
+    struct ThreadStats {
+        std::atomic<uint64_t> counters[(size_t)Counter::AMOUNT];
+        std::atomic<uint64_t> timer_calls[(size_t)Timer::AMOUNT];
+        std::atomic<uint64_t> timer_ns[(size_t)Timer::AMOUNT];
+        std::atomic<uint64_t> timer_max_ns[(size_t)Timer::AMOUNT];
+    };
+
+    /*
+     * Sum of counter over all threads
+     */
+    static uint64_t getCounter(Counter counter);
+
+    /*
+     * Quantity of measured calls and their total time in nanoseconds over all threads
+     */
+    static uint64_t getTimerCalls(Timer timer);
+    static uint64_t getTimerNanoseconds(Timer timer);
+
+    /*
+     * Returns JSON object {"enabled": bool, "threads": n, "counters": {name: value}, "timers": {name: {"calls": n,
+     * "total_ns": n, "max_ns": n}}}
+     */
+    static std::string getStats();
+
+    /*
+     * Zeroes counters and timers of all threads, increments done by other threads at the same time may survive
+     */
+    static void reset();
+
+    /*
+     * Block of calling thread, it's created on the first call and reused by another thread after this one exits
+     */
+    static ThreadStats *registerThread();
+
+    static void count(Counter counter, uint64_t value);
+
+    /*
+     * Heap blocks allocated by calling thread through operator new of library modules. They are counted only if
+     * libraries are built with VS_MATH_HEAP_COUNTER (CMake option of the same name, on by default, tests of allocations
+     * need it), independently of VS_MATH_STATS
+     */
+    static bool isHeapCounted();
+    static uint64_t getThreadHeapAllocations();
+    // Called by replaced operator new, mustn't allocate
+    static void countHeapAllocation();
+
+    class ScopeTimer {
+      public:
+        explicit ScopeTimer(Timer timer) : timer(timer), start(std::chrono::steady_clock::now()) {}
+        ~ScopeTimer();
+
+      private:
+        Timer timer;
+        std::chrono::steady_clock::time_point start;
+    };
+
+  private:
+    Stats() = delete;
+};
+
+namespace StatsDetail {
+// Block of calling thread cached in every module, which counts
+inline Stats::ThreadStats *local() {
+    static thread_local Stats::ThreadStats *stats = nullptr;
+    if (stats == nullptr)
+        stats = Stats::registerThread();
+    return stats;
+}
+
+// Increment without read-modify-write instruction, only owner thread writes its block
+inline void add(std::atomic<uint64_t> &value, uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+}; // namespace StatsDetail
+
+inline void Stats::count(Counter counter, uint64_t value) {
+    StatsDetail::add(StatsDetail::local()->counters[(size_t)counter], value);
+}
+
+inline Stats::ScopeTimer::~ScopeTimer() {
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                                  start)
+                      .count();
+    ThreadStats *stats = StatsDetail::local();
+    StatsDetail::add(stats->timer_calls[(size_t)timer], 1);
+    StatsDetail::add(stats->timer_ns[(size_t)timer], ns);
+    if (ns > stats->timer_max_ns[(size_t)timer].load(std::memory_order_relaxed))
+        stats->timer_max_ns[(size_t)timer].store(ns, std::memory_order_relaxed);
+}
@@ -0,0 +1,298 @@
+#include "ILogger.h"
+#include "LoggerMessages.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+const size_t MAX_CAPACITY = (size_t)1 << 24;
+// Longest time background thread sleeps without being woken by producers
+const std::chrono::milliseconds IDLE_WAIT(10);
+const size_t CACHE_LINE = 64;
+
+struct Record {
+    RC code;
+    ILogger::Level level;
+    int line;
+    const char *srcfile; // nullptr if record has no information about caller
+    const char *function;
+    int64_t time;   // nanoseconds since creation of logger
+    size_t repeats; // quantity of records collapsed into this one
+};
+
+/*
+ * Bounded MPSC queue by D. Vyukov: every slot has sequence number, which tells producers and consumer whose turn is to
+ * use it, so producers only race for tail with one compare-and-swap and never wait for each other
+ */
+struct Slot {
+    std::atomic<size_t> sequence;
+    Record record;
+};
+
+class AsyncLoggerImpl : public ILogger {
+  public:
+    static ILogger *createLogger(std::ostream *stream, bool own_stream, size_t capacity, Overflow policy) {
+        size_t slots_count = 2;
+        while (slots_count < capacity && slots_count < MAX_CAPACITY)
+            slots_count <<= 1;
+        Slot *slots = new (std::nothrow) Slot[slots_count];
+        AsyncLoggerImpl *logger = slots == nullptr ? nullptr : new (std::nothrow) AsyncLoggerImpl(slots, slots_count);
+        if (logger == nullptr) {
+            delete[] slots;
+            if (own_stream)
+                delete stream;
+            return nullptr;
+        }
+        logger->stream = stream;
+        logger->own_stream = own_stream;
+        logger->policy = policy;
+        try {
+            logger->worker = std::thread(&AsyncLoggerImpl::run, logger);
+        } catch (const std::system_error &) {
+            delete logger;
+            return nullptr;
+        }
+        return logger;
+    }
+
+    RC log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) override {
+        if (srcfile == nullptr || function == nullptr) {
+            severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return RC::NULLPTR_ERROR;
+        }
+        return push(code, level, srcfile, function, line, 1);
+    }
+    RC log(RC code, Level level) override { return push(code, level, nullptr, nullptr, 0, 1); }
+
+    RC logRepeated(RC code, Level level, const char *const &srcfile, const char *const &function, int line,
+                   size_t count) override {
+        if (srcfile == nullptr || function == nullptr) {
+            severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return RC::NULLPTR_ERROR;
+        }
+        return push(code, level, srcfile, function, line, count);
+    }
+
+    RC flush() override {
+        const size_t target = tail.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> guard(lock);
+        wake.notify_one();
+        while (written.load(std::memory_order_acquire) < target)
+            drained.wait(guard);
+        return stream->good() ? RC::SUCCESS : RC::IO_ERROR;
+    }
+
+    ~AsyncLoggerImpl() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stop.store(true);
+                wake.notify_one();
+            }
+            worker.join();
+        }
+        if (own_stream)
+            delete stream;
+        delete[] slots;
+    }
+
+  private:
+    Slot *slots;
+    size_t mask;
+    Overflow policy;
+    std::ostream *stream;
+    bool own_stream;
+    Clock::time_point start;
+
+    // Producers and consumer positions are kept on separate cache lines
+    char pad0[CACHE_LINE];
+    std::atomic<size_t> tail;
+    char pad1[CACHE_LINE];
+    size_t head; // used only by background thread
+    std::atomic<size_t> written; // quantity of records already written to stream
+    std::atomic<size_t> dropped;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stop;
+    char pad2[CACHE_LINE];
+
+    std::mutex lock;
+    std::condition_variable wake;    // wakes background thread
+    std::condition_variable drained; // wakes flush()
+    std::thread worker;
+
+    AsyncLoggerImpl(Slot *slots, size_t capacity)
+        : slots(slots), mask(capacity - 1), policy(Overflow::DROP), stream(nullptr), own_stream(false),
+          start(Clock::now()), tail(0), head(0), written(0), dropped(0), sleeping(false), stop(false) {
+        for (size_t idx = 0; idx < capacity; ++idx)
+            slots[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+
+    RC push(RC code, Level level, const char *srcfile, const char *function, int line, size_t repeats) {
+        Record record;
+        record.code = code;
+        record.level = level;
+        record.line = line;
+        record.srcfile = srcfile;
+        record.function = function;
+        record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        record.repeats = repeats;
+
+        while (!tryPush(record)) {
+            if (policy == Overflow::DROP) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return RC::SUCCESS;
+            }
+            notify();
+            std::this_thread::yield();
+        }
+        if (sleeping.load())
+            notify();
+        return RC::SUCCESS;
+    }
+
+    bool tryPush(const Record &record) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots[pos & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if ((ptrdiff_t)(sequence - pos) < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(Record &record) {
+        Slot &slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+        record = slot.record;
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    void notify() {
+        std::lock_guard<std::mutex> guard(lock);
+        wake.notify_one();
+    }
+
+    // Appends decimal digits of value, at least min_digits of them
+    static void appendNumber(std::string &out, uint64_t value, size_t min_digits = 1) {
+        char digits[20];
+        size_t count = 0;
+        do {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0 || count < min_digits);
+        while (count > 0)
+            out += digits[--count];
+    }
+
+    // Same text as synchronous logger writes, prefixed with seconds since creation of logger
+    static void format(std::string &out, const Record &record) {
+        out += '[';
+        appendNumber(out, (uint64_t)record.time / 1000000000);
+        out += '.';
+        appendNumber(out, (uint64_t)record.time / 1000 % 1000000, 6);
+        out += "] ";
+        if (record.srcfile != nullptr) {
+            out += '[';
+            out += record.srcfile;
+            out += "] [";
+            out += record.function;
+            out += "] [";
+            if (record.line < 0)
+                out += '-';
+            appendNumber(out, record.line < 0 ? -(int64_t)record.line : record.line);
+            out += "] ";
+        }
+        out += '[';
+        out += LoggerMessages::level(record.level);
+        out += "] ";
+        out += LoggerMessages::message(record.code);
+        if (record.repeats > 1) {
+            out += " (repeated ";
+            appendNumber(out, record.repeats);
+            out += " times)";
+        }
+        out += '\n';
+    }
+
+    // Formats all queued records into one batch, writes it and wakes flush() callers
+    bool drain(std::string &batch) {
+        batch.clear();
+        size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "[%s] %zu records were dropped because log queue was full\n",
+                          LoggerMessages::level(Level::WARNING), lost);
+            batch += buf;
+        }
+        Record record;
+        for (size_t count = 0; count <= mask && tryPop(record); ++count)
+            format(batch, record);
+        if (batch.empty())
+            return false;
+
+        stream->write(batch.data(), batch.size());
+        stream->flush();
+        written.store(head, std::memory_order_release);
+        std::lock_guard<std::mutex> guard(lock);
+        drained.notify_all();
+        return true;
+    }
+
+    void run() {
+        std::string batch;
+        while (true) {
+            if (drain(batch))
+                continue;
+            if (stop.load())
+                break;
+            std::unique_lock<std::mutex> guard(lock);
+            sleeping.store(true);
+            // Record published by producer, which didn't see sleeping flag yet, waits at most IDLE_WAIT
+            if (slots[head & mask].sequence.load(std::memory_order_acquire) != head + 1 && !stop.load())
+                wake.wait_for(guard, IDLE_WAIT);
+            sleeping.store(false);
+        }
+        // Producers may still race with destruction only by misuse, flush what is left
+        while (drain(batch))
+            ;
+    }
+};
+}; // namespace
+
+ILogger *ILogger::createAsyncLogger(size_t capacity, Overflow policy) {
+    return AsyncLoggerImpl::createLogger(&std::cout, false, capacity, policy);
+}
+
+ILogger *ILogger::createAsyncLogger(const char *const &filename, bool overwrite, size_t capacity, Overflow policy) {
+    if (filename == nullptr)
+        return nullptr;
+    std::ofstream *file = new (std::nothrow) std::ofstream(filename, overwrite ? std::ios::out : std::ios::app);
+    if (file == nullptr || !file->is_open()) {
+        delete file;
+        return nullptr;
+    }
+    return AsyncLoggerImpl::createLogger(file, true, capacity, policy);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+ * The best points seen by one worker of solver in increasing order of (value, group, item), where group and item
+ * number the point among all points of search (sub-grid and its node, or 0 and seed). Points closer than given
+ * distances along every axis are the same one, only the first of them in the order is kept. Both the order and the
+ * points kept don't depend on which worker saw which point, so workers merge their results into the same one
+ *
+ * Memory is allocated by reset() only, push() never allocates
+ */
+class BestPoints {
+  public:
+    size_t size;
+    std::vector<double> values, coords;
+    std::vector<size_t> groups, items;
+
+    BestPoints() : size(0), capacity(0), dim(0) {}
+
+    // May throw std::bad_alloc
+    void reset(size_t capacity, size_t dim) {
+        values.resize(capacity);
+        coords.resize(capacity * dim);
+        groups.resize(capacity);
+        items.resize(capacity);
+        this->capacity = capacity;
+        this->dim = dim;
+        size = 0;
+    }
+
+    // Points worse than it are dropped without looking at coordinates
+    double threshold() const { return size < capacity ? std::numeric_limits<double>::infinity() : values[size - 1]; }
+
+    // same - distances along axes, below which points are the same one
+    void push(double value, double const *point, size_t group, size_t item, double const *same) {
+        for (size_t idx = 0; idx < size; ++idx) {
+            if (!isSame(idx, point, same))
+                continue;
+            if (!less(value, group, item, idx))
+                return;
+            erase(idx);
+            break;
+        }
+        size_t pos = size;
+        while (pos > 0 && less(value, group, item, pos - 1))
+            --pos;
+        if (pos == capacity)
+            return;
+        if (size == capacity)
+            --size;
+        for (size_t idx = size; idx > pos; --idx)
+            move(idx - 1, idx);
+        values[pos] = value;
+        std::copy(point, point + dim, coords.data() + pos * dim);
+        groups[pos] = group;
+        items[pos] = item;
+        ++size;
+    }
+
+    // Pushes all points of other, which has the same dimension
+    void merge(BestPoints const &other, double const *same) {
+        for (size_t idx = 0; idx < other.size; ++idx)
+            push(other.values[idx], other.coords.data() + idx * dim, other.groups[idx], other.items[idx], same);
+    }
+
+  private:
+    size_t capacity, dim;
+
+    bool less(double value, size_t group, size_t item, size_t idx) const {
+        if (value != values[idx])
+            return value < values[idx];
+        return group != groups[idx] ? group < groups[idx] : item < items[idx];
+    }
+    bool isSame(size_t idx, double const *point, double const *same) const {
+        double const *kept = coords.data() + idx * dim;
+        for (size_t axis = 0; axis < dim; ++axis)
+            if (std::fabs(kept[axis] - point[axis]) > same[axis])
+                return false;
+        return true;
+    }
+    void move(size_t from, size_t to) {
+        values[to] = values[from];
+        std::copy(coords.data() + from * dim, coords.data() + (from + 1) * dim, coords.data() + to * dim);
+        groups[to] = groups[from];
+        items[to] = items[from];
+    }
+    void erase(size_t idx) {
+        for (; idx + 1 < size; ++idx)
+            move(idx + 1, idx);
+        --size;
+    }
+};
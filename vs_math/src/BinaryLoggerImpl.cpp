@@ -0,0 +1,123 @@
+#include "BinaryLog.h"
+#include "ILogger.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Size of buffer, which is written to file at once
+const size_t BUFFER_SIZE = 1 << 16;
+
+class BinaryLoggerImpl : public ILogger {
+  public:
+    static ILogger *createLogger(const char *const &filename, bool overwrite) {
+        if (filename == nullptr)
+            return nullptr;
+        std::ios_base::openmode mode = std::ios::out | std::ios::binary | (overwrite ? std::ios::trunc : std::ios::app);
+        BinaryLoggerImpl *logger = new (std::nothrow) BinaryLoggerImpl;
+        if (logger == nullptr)
+            return nullptr;
+        // Appended log starts with its own header, strings are interned anew
+        logger->file.open(filename, mode);
+        if (!logger->file.is_open()) {
+            delete logger;
+            return nullptr;
+        }
+        BinaryLog::Header header;
+        header.start_time = steadyTime();
+        header.start_wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count();
+        BinaryLog::putHeader(logger->buffer, header);
+        return logger;
+    }
+
+    RC log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) override {
+        return logRepeated(code, level, srcfile, function, line, 1);
+    }
+    RC log(RC code, Level level) override {
+        std::lock_guard<std::mutex> guard(lock);
+        return append(code, level, 0, 0, 0, 1);
+    }
+    RC logRepeated(RC code, Level level, const char *const &srcfile, const char *const &function, int line,
+                   size_t count) override {
+        if (srcfile == nullptr || function == nullptr) {
+            severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return RC::NULLPTR_ERROR;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        return append(code, level, intern(srcfile), intern(function), line, count);
+    }
+
+    RC flush() override {
+        std::lock_guard<std::mutex> guard(lock);
+        return write();
+    }
+
+    ~BinaryLoggerImpl() { write(); }
+
+  private:
+    std::mutex lock;
+    std::ofstream file;
+    std::vector<char> buffer;
+    // Ids of strings by their text and cache of them by address, which is the same for every call from one place.
+    // Address may be reused by another text after caller frees its buffer, so cached text is compared before use
+    typedef std::unordered_map<std::string, uint32_t> Ids;
+    Ids ids_by_text;
+    std::unordered_map<const char *, Ids::value_type const *> ids_by_address;
+    uint32_t next_id;
+
+    BinaryLoggerImpl() : next_id(1) { buffer.reserve(BUFFER_SIZE); }
+
+    static uint64_t steadyTime() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    uint32_t intern(const char *text) {
+        std::unordered_map<const char *, Ids::value_type const *>::const_iterator cached = ids_by_address.find(text);
+        if (cached != ids_by_address.end() && cached->second->first == text)
+            return cached->second->second;
+        std::string key(text);
+        Ids::const_iterator known = ids_by_text.find(key);
+        if (known == ids_by_text.end()) {
+            BinaryLog::putString(buffer, next_id, text, key.size());
+            known = ids_by_text.insert({key, next_id++}).first;
+        }
+        // Elements of unordered_map keep their addresses on rehash
+        ids_by_address[text] = &*known;
+        return known->second;
+    }
+
+    RC append(RC code, Level level, uint32_t srcfile, uint32_t function, int line, size_t count) {
+        BinaryLog::Record record;
+        record.time = steadyTime();
+        record.repeats = count;
+        record.srcfile = srcfile;
+        record.function = function;
+        record.line = line;
+        record.code = code;
+        record.level = level;
+        BinaryLog::putRecord(buffer, record);
+        return buffer.size() >= BUFFER_SIZE ? write() : RC::SUCCESS;
+    }
+
+    RC write() {
+        if (!buffer.empty())
+            file.write(buffer.data(), buffer.size());
+        buffer.clear();
+        file.flush();
+        return file.good() ? RC::SUCCESS : RC::IO_ERROR;
+    }
+};
+}; // namespace
+
+ILogger *ILogger::createBinaryLogger(const char *const &filename, bool overwrite) {
+    return BinaryLoggerImpl::createLogger(filename, overwrite);
+}
@@ -1,14 +1,54 @@
 #include "CompactImpl.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 
-ILogger *CompactImpl::logger = nullptr;
+std::atomic<ILogger *> CompactImpl::logger(nullptr);
 
-CompactImpl::CompactImpl(const IVector *left, const IVector *right, const IMultiIndex *nodes) {
-    left_boundary = left->clone();
-    right_boundary = right->clone();
-    grid = nodes->clone();
+CompactImpl::CompactImpl(IVector *left, IVector *right, IMultiIndex *nodes, double *table) {
+    left_boundary = left;
+    right_boundary = right;
+    grid = nodes;
     dim = left_boundary->getDim();
+    left_coords = left_boundary->getData();
+    right_coords = right_boundary->getData();
+    grid_nodes = grid->getData();
+
+    steps = new double[dim];
+    nodes_count = 1;
+    size_t table_size = 0;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        steps[idx] = grid_nodes[idx] > 1 ? (right_coords[idx] - left_coords[idx]) / (grid_nodes[idx] - 1) : 0.0;
+        nodes_count *= grid_nodes[idx];
+        table_size += grid_nodes[idx];
+    }
+
+    uniform = table == nullptr;
+    coord_table = table;
+    table_offset = nullptr;
+    if (!uniform || table_size <= COORD_TABLE_LIMIT) {
+        if (uniform)
+            coord_table = new (std::nothrow) double[table_size];
+        table_offset = new (std::nothrow) size_t[dim];
+    }
+    if (coord_table != nullptr && table_offset != nullptr) {
+        size_t offset = 0;
+        for (size_t idx = 0; idx < dim; ++idx) {
+            table_offset[idx] = offset;
+            if (uniform)
+                for (size_t pos = 0; pos < grid_nodes[idx]; ++pos)
+                    coord_table[offset + pos] = calcNodeCoord(idx, pos);
+            offset += grid_nodes[idx];
+        }
+    } else {
+        // table is only an optimization for uniform grid, compact works without it
+        delete[] coord_table;
+        delete[] table_offset;
+        coord_table = nullptr;
+        table_offset = nullptr;
+    }
+
     control_block = new CompactImplControlBlock(this);
 }
 
@@ -16,20 +56,124 @@ CompactImpl::~CompactImpl() {
     delete left_boundary;
     delete right_boundary;
     delete grid;
+    delete[] steps;
+    delete[] coord_table;
+    delete[] table_offset;
     delete control_block;
 }
 
 ICompact *CompactImpl::createCompact(IVector const *vec1, IVector const *vec2, IMultiIndex const *nodeQuantities) {
     if (vec1 == nullptr || vec2 == nullptr || nodeQuantities == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return nullptr;
     }
     if (vec1->getDim() != vec2->getDim() || vec2->getDim() != nodeQuantities->getDim()) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return nullptr;
+    }
+
+    return createCompact(vec1->getDim(), vec1->getData(), vec2->getData(), nodeQuantities->getData());
+}
+
+ICompact *CompactImpl::createCompact(IVector const *vec1, IVector const *vec2, IGridSpec const *gridSpec) {
+    if (vec1 == nullptr || vec2 == nullptr || gridSpec == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return nullptr;
+    }
+    const size_t dim = vec1->getDim();
+    if (dim != vec2->getDim() || dim != gridSpec->getDim()) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return nullptr;
+    }
+
+    size_t *nodes = new (std::nothrow) size_t[dim];
+    if (nodes == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    size_t table_size = 0;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        nodes[idx] = gridSpec->getNodes(idx);
+        table_size += nodes[idx];
+    }
+    if (gridSpec->isUniform()) {
+        ICompact *compact = createCompact(dim, vec1->getData(), vec2->getData(), nodes);
+        delete[] nodes;
+        return compact;
+    }
+
+    // Relative positions of nodes are mapped onto axes, last node is placed exactly on right boundary
+    double *table = new (std::nothrow) double[table_size];
+    if (table == nullptr) {
+        delete[] nodes;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
         return nullptr;
     }
+    const double *left = vec1->getData();
+    const double *right = vec2->getData();
+    double *axis_table = table;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        const double *positions = gridSpec->getAxisNodes(idx);
+        const double length = right[idx] - left[idx];
+        for (size_t pos = 0; pos < nodes[idx]; ++pos)
+            axis_table[pos] = positions[pos] == 1.0 ? right[idx] : left[idx] + positions[pos] * length;
+        axis_table += nodes[idx];
+    }
 
-    return new (std::nothrow) CompactImpl(vec1, vec2, nodeQuantities);
+    ICompact *compact = createCompact(dim, left, right, nodes, table);
+    delete[] nodes;
+    delete[] table;
+    return compact;
+}
+
+ICompact *CompactImpl::createCompact(size_t dim, double const *left, double const *right, size_t const *nodes,
+                                     double const *table) {
+    size_t nodes_count = 1;
+    size_t table_size = 0;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        if (nodes[idx] == 0) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+            return nullptr;
+        }
+        if (nodes_count > SIZE_MAX / nodes[idx]) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INFINITY_OVERFLOW);
+            return nullptr;
+        }
+        nodes_count *= nodes[idx];
+        table_size += nodes[idx];
+    }
+
+    IVector *left_copy = IVector::createVector(dim, left);
+    IVector *right_copy = IVector::createVector(dim, right);
+    IMultiIndex *grid_copy = IMultiIndex::createMultiIndex(dim, nodes);
+    double *table_copy = table != nullptr ? new (std::nothrow) double[table_size] : nullptr;
+    if (left_copy == nullptr || right_copy == nullptr || grid_copy == nullptr ||
+        (table != nullptr && table_copy == nullptr)) {
+        delete left_copy;
+        delete right_copy;
+        delete grid_copy;
+        delete[] table_copy;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    if (table != nullptr)
+        std::copy(table, table + table_size, table_copy);
+
+    CompactImpl *compact = new (std::nothrow) CompactImpl(left_copy, right_copy, grid_copy, table_copy);
+    if (compact == nullptr) {
+        delete left_copy;
+        delete right_copy;
+        delete grid_copy;
+        delete[] table_copy;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    if (compact->table_offset == nullptr && table != nullptr) {
+        delete compact;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    return compact;
 }
 
 RC CompactImpl::setLogger(ILogger *const pLogger) {
@@ -42,20 +186,22 @@ RC CompactImpl::setLogger(ILogger *const pLogger) {
 
 ILogger *CompactImpl::getLogger() { return logger; }
 
-ICompact *CompactImpl::clone() const { return createCompact(left_boundary, right_boundary, grid); }
+ICompact *CompactImpl::clone() const {
+    return createCompact(dim, left_coords, right_coords, grid_nodes, uniform ? nullptr : coord_table);
+}
 
 bool CompactImpl::isInside(IVector const *const &vec) const {
     if (vec == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return false;
     }
     if (vec->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return false;
     }
 
-    const double *left_data = left_boundary->getData();
-    const double *right_data = right_boundary->getData();
+    const double *left_data = left_coords;
+    const double *right_data = right_coords;
     const double *vec_data = vec->getData();
 
     for (size_t idx = 0; idx < dim; ++idx)
@@ -64,11 +210,93 @@ bool CompactImpl::isInside(IVector const *const &vec) const {
     return true;
 }
 
+RC CompactImpl::isInsideBatch(double const *const &rows, size_t count, uint8_t *const &mask) const {
+    if (rows == nullptr || mask == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+
+    const double *left_data = left_coords;
+    const double *right_data = right_coords;
+    // Points are processed in chunks: flags of a chunk are narrowed axis by axis with branch-free comparisons, so the
+    // inner loops are vectorizable, and then packed into mask bytes
+    const size_t CHUNK = 256;
+    uint8_t inside[CHUNK];
+    for (size_t first = 0; first < count; first += CHUNK) {
+        size_t chunk = std::min(CHUNK, count - first);
+        const double *chunk_rows = rows + first * dim;
+        std::fill_n(inside, chunk, (uint8_t)1);
+        for (size_t idx = 0; idx < dim; ++idx) {
+            const double left = left_data[idx], right = right_data[idx];
+            for (size_t point = 0; point < chunk; ++point) {
+                double val = chunk_rows[point * dim + idx];
+                inside[point] &= (uint8_t)((val >= left) & (val <= right));
+            }
+        }
+        for (size_t point = 0; point < chunk; point += 8) {
+            uint8_t bits = 0;
+            for (size_t bit = 0; bit < 8 && point + bit < chunk; ++bit)
+                bits |= (uint8_t)(inside[point + bit] << bit);
+            mask[(first + point) / 8] = bits;
+        }
+    }
+    return RC::SUCCESS;
+}
+
+RC CompactImpl::isInsideBatch(double const *const &rows, size_t count, uint8_t *const &mask,
+                              IMultiIndex const *const &bypassOrder, size_t *const &nodes) const {
+    if (nodes == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    RC err = checkNodeArgs(0, bypassOrder);
+    if (err != RC::SUCCESS)
+        return err;
+    err = isInsideBatch(rows, count, mask);
+    if (err != RC::SUCCESS)
+        return err;
+
+    const size_t *order_data = bypassOrder->getData();
+    const size_t *grid_data = grid_nodes;
+    for (size_t point = 0; point < count; ++point) {
+        if (!(mask[point / 8] & (1u << (point % 8)))) {
+            nodes[point] = nodes_count;
+            continue;
+        }
+        const double *row = rows + point * dim;
+        size_t linear = 0;
+        for (size_t idx = dim; idx-- > 0;) {
+            size_t axis = order_data[idx];
+            linear = linear * grid_data[axis] + nearestNode(axis, row[axis]);
+        }
+        nodes[point] = linear;
+    }
+    return RC::SUCCESS;
+}
+
+size_t CompactImpl::nearestNode(size_t axis, double x) const {
+    if (grid_nodes[axis] == 1)
+        return 0;
+    if (uniform) {
+        if (steps[axis] <= 0)
+            return 0;
+        size_t pos = (size_t)((x - left_coords[axis]) / steps[axis] + 0.5);
+        return std::min(pos, grid_nodes[axis] - 1);
+    }
+    const double *axis_table = coord_table + table_offset[axis];
+    size_t pos = std::lower_bound(axis_table, axis_table + grid_nodes[axis], x) - axis_table;
+    if (pos == grid_nodes[axis])
+        return pos - 1;
+    if (pos > 0 && x - axis_table[pos - 1] <= axis_table[pos] - x)
+        return pos - 1;
+    return pos;
+}
+
 RC CompactImpl::getLeftBoundary(IVector *&vec) const {
     IVector *copy = left_boundary->clone();
     vec = copy;
     if (copy == nullptr) {
-        logger->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     return RC::SUCCESS;
@@ -77,7 +305,7 @@ RC CompactImpl::getRightBoundary(IVector *&vec) const {
     IVector *copy = right_boundary->clone();
     vec = copy;
     if (copy == nullptr) {
-        logger->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     return RC::SUCCESS;
@@ -85,22 +313,306 @@ RC CompactImpl::getRightBoundary(IVector *&vec) const {
 
 size_t CompactImpl::getDim() const { return dim; }
 
+double const *CompactImpl::getLeftBoundaryData() const { return left_coords; }
+
+double const *CompactImpl::getRightBoundaryData() const { return right_coords; }
+
 IMultiIndex *CompactImpl::getGrid() const { return grid->clone(); }
 
+size_t const *CompactImpl::getGridData() const { return grid_nodes; }
+
+size_t CompactImpl::getNodesCount() const { return nodes_count; }
+
+bool CompactImpl::isValidOrder(IMultiIndex const *const &bypassOrder) const {
+    const size_t *order_data = bypassOrder->getData();
+    for (size_t idx = 0; idx < dim; ++idx) {
+        if (order_data[idx] >= dim)
+            return false;
+        for (size_t prev = 0; prev < idx; ++prev)
+            if (order_data[prev] == order_data[idx])
+                return false;
+    }
+    return true;
+}
+
+RC CompactImpl::checkNodeArgs(size_t nodeIndex, IMultiIndex const *const &bypassOrder) const {
+    if (bypassOrder == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (bypassOrder->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (nodeIndex >= nodes_count) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    return RC::SUCCESS;
+}
+
+RC CompactImpl::toLinear(IMultiIndex const *const &index, IMultiIndex const *const &bypassOrder,
+                         size_t &nodeIndex) const {
+    if (index == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (index->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    RC err = checkNodeArgs(0, bypassOrder);
+    if (err != RC::SUCCESS)
+        return err;
+
+    const size_t *index_data = index->getData();
+    const size_t *order_data = bypassOrder->getData();
+    const size_t *grid_data = grid_nodes;
+    size_t linear = 0;
+    for (size_t idx = dim; idx-- > 0;) {
+        size_t axis = order_data[idx];
+        if (index_data[axis] >= grid_data[axis]) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return RC::INDEX_OUT_OF_BOUND;
+        }
+        linear = linear * grid_data[axis] + index_data[axis];
+    }
+    nodeIndex = linear;
+    return RC::SUCCESS;
+}
+
+RC CompactImpl::fromLinear(size_t nodeIndex, IMultiIndex const *const &bypassOrder, IMultiIndex *const &index) const {
+    if (index == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (index->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    RC err = checkNodeArgs(nodeIndex, bypassOrder);
+    if (err != RC::SUCCESS)
+        return err;
+
+    const size_t *order_data = bypassOrder->getData();
+    const size_t *grid_data = grid_nodes;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        size_t axis = order_data[idx];
+        index->setAxisIndex(axis, nodeIndex % grid_data[axis]);
+        nodeIndex /= grid_data[axis];
+    }
+    return RC::SUCCESS;
+}
+
+RC CompactImpl::getNode(size_t nodeIndex, IMultiIndex const *const &bypassOrder, double *const &coords) const {
+    if (coords == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    RC err = checkNodeArgs(nodeIndex, bypassOrder);
+    if (err != RC::SUCCESS)
+        return err;
+
+    const size_t *order_data = bypassOrder->getData();
+    const size_t *grid_data = grid_nodes;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        size_t axis = order_data[idx];
+        coords[axis] = nodeCoord(axis, nodeIndex % grid_data[axis]);
+        nodeIndex /= grid_data[axis];
+    }
+    return RC::SUCCESS;
+}
+
+RC CompactImpl::generateNodes(size_t startIndex, size_t count, IMultiIndex const *const &bypassOrder,
+                              double *const &out) const {
+    if (bypassOrder == nullptr || out == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (bypassOrder->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    if (startIndex > nodes_count || count > nodes_count - startIndex) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (count == 0)
+        return RC::SUCCESS;
+    STATS_TIMER(COMPACT_SWEEP);
+    STATS_ADD(COMPACT_SWEEP_NODES, count);
+
+    SmallMultiIndex position(dim);
+    if (position.getDim() != dim)
+        return RC::ALLOCATION_ERROR;
+    size_t *pos = position.getData();
+    const size_t *grid_data = grid_nodes;
+    const size_t *order_data = bypassOrder->getData();
+    double *row = out;
+    seekNode(startIndex, order_data, pos, row);
+
+    const size_t fast = order_data[0];
+    const size_t fast_nodes = grid_data[fast];
+    const double fast_left = left_coords[fast];
+    const double fast_step = steps[fast];
+    const double *fast_table = coord_table != nullptr ? coord_table + table_offset[fast] : nullptr;
+
+    size_t done = 0;
+    while (true) {
+        // Run along the fastest axis: slow coordinates stay the same, fast one is an arithmetic progression
+        size_t run = std::min(fast_nodes - pos[fast], count - done);
+        for (size_t r = 1; r < run; ++r)
+            for (size_t axis = 0; axis < dim; ++axis)
+                row[r * dim + axis] = row[axis];
+        if (fast_table != nullptr) {
+            for (size_t r = 0; r < run; ++r)
+                row[r * dim + fast] = fast_table[pos[fast] + r];
+        } else {
+            for (size_t r = 0; r < run; ++r)
+                row[r * dim + fast] = fast_left + (pos[fast] + r) * fast_step;
+            if (pos[fast] + run == fast_nodes)
+                row[(run - 1) * dim + fast] = calcNodeCoord(fast, fast_nodes - 1);
+        }
+
+        done += run;
+        if (done == count)
+            break;
+
+        // Carry into slower axes, only their changed coordinates are recalculated
+        double *next_row = row + run * dim;
+        for (size_t axis = 0; axis < dim; ++axis)
+            next_row[axis] = row[axis];
+        pos[fast] = fast_nodes - 1;
+        stepNode(order_data, pos, next_row);
+        row = next_row;
+    }
+    return RC::SUCCESS;
+}
+
+bool CompactImpl::isUniform() const { return uniform; }
+
+ICompact *CompactImpl::createRefinement(IMultiIndex const *const &first, IMultiIndex const *const &last) const {
+    if (first == nullptr || last == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return nullptr;
+    }
+    if (first->getDim() != dim || last->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return nullptr;
+    }
+    const size_t *first_data = first->getData();
+    const size_t *last_data = last->getData();
+    size_t table_size = 0;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        if (first_data[idx] > last_data[idx] || last_data[idx] >= grid_nodes[idx]) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return nullptr;
+        }
+        table_size += 2 * (last_data[idx] - first_data[idx]) + 1;
+    }
+
+    double *left = new (std::nothrow) double[dim];
+    double *right = new (std::nothrow) double[dim];
+    size_t *nodes = new (std::nothrow) size_t[dim];
+    // Midpoints of uniform grid form uniform grid, so table is needed only for non-uniform one
+    double *table = uniform ? nullptr : new (std::nothrow) double[table_size];
+    if (left == nullptr || right == nullptr || nodes == nullptr || (!uniform && table == nullptr)) {
+        delete[] left;
+        delete[] right;
+        delete[] nodes;
+        delete[] table;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+
+    double *axis_table = table;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        left[idx] = nodeCoord(idx, first_data[idx]);
+        right[idx] = nodeCoord(idx, last_data[idx]);
+        nodes[idx] = 2 * (last_data[idx] - first_data[idx]) + 1;
+        if (uniform)
+            continue;
+        for (size_t pos = first_data[idx]; pos < last_data[idx]; ++pos) {
+            *axis_table++ = nodeCoord(idx, pos);
+            *axis_table++ = 0.5 * (nodeCoord(idx, pos) + nodeCoord(idx, pos + 1));
+        }
+        *axis_table++ = right[idx];
+    }
+
+    ICompact *refinement = createCompact(dim, left, right, nodes, table);
+    delete[] left;
+    delete[] right;
+    delete[] nodes;
+    delete[] table;
+    return refinement;
+}
+
+RC CompactImpl::generateRefinementNodes(IMultiIndex const *const &bypassOrder, double *const &out, size_t capacity,
+                                        size_t &count) const {
+    if (out == nullptr && capacity > 0) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    RC err = checkNodeArgs(0, bypassOrder);
+    if (err != RC::SUCCESS)
+        return err;
+
+    // Nodes with even positions along all axes form the coarse grid
+    size_t coarse_count = 1;
+    for (size_t idx = 0; idx < dim; ++idx)
+        coarse_count *= (grid_nodes[idx] + 1) / 2;
+    count = nodes_count - coarse_count;
+    if (capacity == 0 || count == 0)
+        return RC::SUCCESS;
+    STATS_TIMER(COMPACT_SWEEP);
+
+    SmallMultiIndex position(dim);
+    STATS_COUNT(COMPACT_ALLOCATIONS);
+    double *coords = new (std::nothrow) double[dim];
+    if (position.getDim() != dim || coords == nullptr) {
+        delete[] coords;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return RC::ALLOCATION_ERROR;
+    }
+    size_t *pos = position.getData();
+    const size_t *order_data = bypassOrder->getData();
+    seekNode(0, order_data, pos, coords);
+    size_t written = 0;
+    do {
+        bool coarse = true;
+        for (size_t idx = 0; idx < dim; ++idx)
+            coarse &= pos[idx] % 2 == 0;
+        if (!coarse)
+            std::copy(coords, coords + dim, out + dim * written++);
+    } while (written < capacity && written < count && stepNode(order_data, pos, coords));
+    STATS_ADD(COMPACT_SWEEP_NODES, written);
+
+    delete[] coords;
+    return RC::SUCCESS;
+}
+
 RC CompactImpl::getVectorCopy(IMultiIndex const *index, IVector *&val) const {
     double *empty_data = new double[dim];
     IVector *tmp = IVector::createVector(dim, empty_data);
     delete[] empty_data;
 
     if (tmp == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         val = nullptr;
         return RC::NULLPTR_ERROR;
     }
 
     RC err = getVectorCoords(index, tmp);
     if (err != RC::SUCCESS) {
-        logger->severe(err, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, err);
         val = nullptr;
         delete tmp;
         return err;
@@ -111,29 +623,25 @@ RC CompactImpl::getVectorCopy(IMultiIndex const *index, IVector *&val) const {
 }
 
 RC CompactImpl::getVectorCoords(IMultiIndex const *index, IVector *const &val) const {
-    if (index == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+    if (index == nullptr || val == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     if (index->getDim() != dim || val->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
     const size_t *index_data = index->getData();
-    const size_t *grid_data = grid->getData();
+    const size_t *grid_data = grid_nodes;
     for (size_t idx = 0; idx < dim; ++idx)
-        if (index_data[idx] > grid_data[idx]) {
-            logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        if (index_data[idx] >= grid_data[idx]) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
             return RC::INDEX_OUT_OF_BOUND;
         }
 
-    const double *left_data = left_boundary->getData();
-    const double *right_data = right_boundary->getData();
-    for (size_t idx = 0; idx < dim; ++idx) {
-        double lambda = (double)(index_data[idx]) / (grid_data[idx] - 1);
-        val->setCord(idx, (1.0 - lambda) * left_data[idx] + lambda * right_data[idx]);
-    }
+    for (size_t idx = 0; idx < dim; ++idx)
+        val->setCord(idx, nodeCoord(idx, index_data[idx]));
 
     return RC::SUCCESS;
 }
@@ -142,283 +650,228 @@ ICompact *ICompact::createCompact(IVector const *vec1, IVector const *vec2, IMul
     return CompactImpl::createCompact(vec1, vec2, nodeQuantities);
 }
 
+ICompact *ICompact::createCompact(IVector const *vec1, IVector const *vec2, IGridSpec const *gridSpec) {
+    return CompactImpl::createCompact(vec1, vec2, gridSpec);
+}
+
 RC ICompact::setLogger(ILogger *const logger) { return CompactImpl::setLogger(logger); }
 
 ILogger *ICompact::getLogger() { return CompactImpl::getLogger(); }
 
-static bool checkIntersection(const double arr1[], const double arr2[], double& resLeft, double& resRight)
-{
-    if (arr1[1] < arr2[0] || arr2[1] < arr1[0])
-    {
-        resLeft = 0;
-        resRight = 0;
-        return false;
-    }
-    if (arr2[0] < arr1[0] && arr1[1] < arr2[1])
-    {
-        resLeft = arr1[0];
-        resRight = arr1[1];
-        return true;
-    }
-    if (arr1[0] < arr2[0] && arr2[1] < arr1[1])
-    {
-        resLeft = arr2[0];
-        resRight = arr2[1];
-        return true;
-    }
-    if (arr1[0] < arr2[0] && arr2[0] < arr1[1] && arr1[1] < arr2[1])
-    {
-        resLeft = arr2[0];
-        resRight = arr1[1];
-        return true;
-    }
-    if (arr2[0] < arr1[0] && arr1[0] < arr2[1] && arr2[1] < arr1[1])
-    {
-        resLeft = arr1[0];
-        resRight = arr2[1];
-        return true;
-    }
-    else 
-        return false;
-}
+namespace {
+// Array of n elements, that is placed on stack when n is small enough
+template <class T, size_t N = 16>
+class LocalBuffer {
+  public:
+    explicit LocalBuffer(size_t n) : heap(n > N ? allocate(n) : nullptr), ptr(n > N ? heap : local) {}
+    ~LocalBuffer() { delete[] heap; }
+    T *data() { return ptr; }
 
+  private:
+    T local[N];
+    T *heap;
+    T *ptr;
 
-ICompact *ICompact::createIntersection(ICompact const *op1, ICompact const *op2, IMultiIndex const *const grid, double tol)
-{
-    if (op1 == nullptr || op2 == nullptr || grid == nullptr) {
-        getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    if (std::isnan(tol) || std::isinf(tol)) {
-        getLogger()->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
-        return nullptr;
+    static T *allocate(size_t n) {
+        STATS_COUNT(COMPACT_ALLOCATIONS);
+        return new (std::nothrow) T[n];
     }
-    if (op1->getDim() != op2->getDim() || op1->getDim() != grid->getDim()) {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-/*
-    const size_t projection = 2;
-    size_t dim = op1->getDim();
-    IVector *com1_left_bound, *com1_right_bound, *com2_left_bound, *com2_right_bound;
 
-    RC err = op1->getLeftBoundary(com1_left_bound);
-    if (err != RC::SUCCESS) {
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    err = op1->getRightBoundary(com1_right_bound);
-    if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    err = op2->getLeftBoundary(com2_left_bound);
-    if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    err = op2->getRightBoundary(com2_right_bound);
-    if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    IMultiIndex *grid_copy = grid->clone();
-    if (grid_copy == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-
-    double left_data1, right_data1, left_data2, right_data2, res_left[dim], res_right[dim];
+    LocalBuffer(const LocalBuffer &) = delete;
+    LocalBuffer &operator=(const LocalBuffer &) = delete;
+};
 
+/*
+ * Intersection of axis-aligned boxes [l1, r1] and [l2, r2], returns false if it's empty
+ *
+ * Boxes separated by less than tol are considered touching. Axes of intersection shorter than tol degenerate to a single
+ * node, other axes get node quantities from grid
+ */
+bool intersectBoxes(size_t dim, const double *l1, const double *r1, const double *l2, const double *r2,
+                    const size_t *grid, double tol, double *left, double *right, size_t *nodes) {
+    bool empty = false;
     for (size_t idx = 0; idx < dim; ++idx) {
-        left_data1 = com1_left_bound->getData()[idx];
-        right_data1 = com1_right_bound->getData()[idx];
-        left_data2 = com2_left_bound->getData()[idx];
-        right_data2 = com2_right_bound->getData()[idx];
-        if (!intersectionPossible(left_data1, right_data1, left_data2, right_data2, res_left[idx], res_right[idx])) {
-            delete com1_left_bound;
-            delete com1_right_bound;
-            delete com2_left_bound;
-            delete com2_right_bound;
-            delete grid_copy;
-            return nullptr;
-        }
-
-        double tmp_data[projection] = {res_left[idx], res_right[idx]};
-        IVector *tmp_inter = IVector::createVector(projection, tmp_data);
-        if (tmp_inter == nullptr) {
-            delete com1_left_bound;
-            delete com1_right_bound;
-            delete com2_left_bound;
-            delete com2_right_bound;
-            delete grid_copy;
-            getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-            return nullptr;
-        }
-        if (tmp_inter->norm(IVector::NORM::FIRST) < tol) {
-            grid_copy->setAxisIndex(idx, 1);
-        }
-        delete tmp_inter;
-    }
-
-    IVector *new_left = IVector::createVector(dim, res_left);
-    if (new_left == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        delete grid_copy;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+        left[idx] = std::max(l1[idx], l2[idx]);
+        right[idx] = std::min(r1[idx], r2[idx]);
+        empty |= right[idx] < left[idx] - tol;
     }
+    if (empty)
+        return false;
 
-    IVector *new_right = IVector::createVector(dim, res_right);
-    if (new_right == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        delete grid_copy;
-        delete new_left;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        bool degenerate = right[idx] - left[idx] < tol;
+        right[idx] = degenerate ? left[idx] : right[idx];
+        nodes[idx] = degenerate ? 1 : grid[idx];
     }
+    return true;
+}
 
-    ICompact *inter = ICompact::createCompact(new_left, new_right, grid_copy);
-    if (inter == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        delete grid_copy;
-        delete new_left;
-        delete new_right;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+// Smallest axis-aligned box containing [l1, r1] and [l2, r2]
+void spanBoxes(size_t dim, const double *l1, const double *r1, const double *l2, const double *r2, double *left,
+               double *right) {
+    for (size_t idx = 0; idx < dim; ++idx) {
+        left[idx] = std::min(l1[idx], l2[idx]);
+        right[idx] = std::max(r1[idx], r2[idx]);
     }
+}
 
-    delete com1_left_bound;
-    delete com1_right_bound;
-    delete com2_left_bound;
-    delete com2_right_bound;
-    delete grid_copy;
-    delete new_left;
-    delete new_right;
-
-    return inter;*/        return nullptr;
-
+RC checkTolerance(double tol) {
+    if (std::isnan(tol) || std::isinf(tol))
+        return RC::NOT_NUMBER;
+    if (tol < 0)
+        return RC::INVALID_ARGUMENT;
+    return RC::SUCCESS;
 }
 
-ICompact *ICompact::createCompactSpan(ICompact const *op1, ICompact const *op2, IMultiIndex const *const grid)
-{/*
-    if (op1 == nullptr || op2 == nullptr || grid == nullptr) {
-        getLogger()->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    if (op1->getDim() != op2->getDim()) {
-        getLogger()->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return nullptr;
+// Grid, which createCompact() accepts: no axis without nodes and quantity of nodes fits size_t
+RC checkGrid(size_t dim, const size_t *grid) {
+    size_t nodes_count = 1;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        if (grid[idx] == 0)
+            return RC::INVALID_ARGUMENT;
+        if (nodes_count > SIZE_MAX / grid[idx])
+            return RC::INFINITY_OVERFLOW;
+        nodes_count *= grid[idx];
     }
+    return RC::SUCCESS;
+}
+} // namespace
 
-    auto checkUnion = [](const double *arr, double &resLeft, double &resRight) -> void {
-        resLeft = arr[0];
-        resRight = arr[0];
-        for (size_t i = 1; i < 4; ++i) {
-            if (arr[i] < resLeft) {
-                resLeft = arr[i];
-            }
-            if (arr[i] > resRight) {
-                resRight = arr[i];
-            }
-        }
-    };
-
-    const size_t projection = 2;
-    size_t dim = op1->getDim();
-    IVector *com1_left_bound, *com1_right_bound, *com2_left_bound, *com2_right_bound;
-
-    RC err = op1->getLeftBoundary(com1_left_bound);
+ICompact *ICompact::createIntersection(ICompact const *op1, ICompact const *op2, IMultiIndex const *const grid,
+                                       double tol) {
+    ICompact *inter = nullptr;
+    RC err = createIntersections(op1, &op2, 1, grid, tol, &inter);
     if (err != RC::SUCCESS) {
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::COMPACT, err);
         return nullptr;
     }
-    err = op1->getRightBoundary(com1_right_bound);
+    return inter;
+}
+
+ICompact *ICompact::createCompactSpan(ICompact const *op1, ICompact const *op2, IMultiIndex const *const grid) {
+    ICompact *span = nullptr;
+    RC err = createCompactSpans(op1, &op2, 1, grid, &span);
     if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::COMPACT, err);
         return nullptr;
     }
-    err = op2->getLeftBoundary(com2_left_bound);
+    return span;
+}
+
+RC ICompact::createIntersections(ICompact const *op, ICompact const *const *others, size_t count,
+                                 IMultiIndex const *const grid, double tol, ICompact **results) {
+    if (op == nullptr || others == nullptr || grid == nullptr || results == nullptr) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    RC err = checkTolerance(tol);
     if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
+        SendSevere(getLogger(), ILogger::Module::COMPACT, err);
+        return err;
+    }
+    const size_t dim = op->getDim();
+    if (grid->getDim() != dim) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
     }
-    err = op2->getRightBoundary(com2_right_bound);
+    // Then createCompact() fails only without memory
+    err = checkGrid(dim, grid->getData());
     if (err != RC::SUCCESS) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
+        SendSevere(getLogger(), ILogger::Module::COMPACT, err);
+        return err;
     }
+    std::fill_n(results, count, nullptr);
+
+    LocalBuffer<double> bounds(2 * dim);
+    LocalBuffer<size_t> nodes(dim);
+    if (bounds.data() == nullptr || nodes.data() == nullptr) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return RC::ALLOCATION_ERROR;
+    }
+    double *left = bounds.data();
+    double *right = bounds.data() + dim;
+    const double *op_left = op->getLeftBoundaryData();
+    const double *op_right = op->getRightBoundaryData();
+
+    for (size_t idx = 0; idx < count; ++idx) {
+        err = RC::SUCCESS;
+        if (others[idx] == nullptr)
+            err = RC::NULLPTR_ERROR;
+        else if (others[idx]->getDim() != dim)
+            err = RC::MISMATCHING_DIMENSIONS;
+        else if (intersectBoxes(dim, op_left, op_right, others[idx]->getLeftBoundaryData(),
+                                others[idx]->getRightBoundaryData(), grid->getData(), tol, left, right,
+                                nodes.data())) {
+            results[idx] = CompactImpl::createCompact(dim, left, right, nodes.data());
+            if (results[idx] == nullptr)
+                err = RC::ALLOCATION_ERROR;
+        }
 
-    double res_left[dim], res_right[dim];
-    for (size_t idx = 0; idx < dim; ++idx) {
-        double tmp[] = {com1_left_bound->getData()[idx], com1_right_bound->getData()[idx],
-                        com1_left_bound->getData()[idx], com2_right_bound->getData()[idx]};
-        checkUnion(tmp, res_left[idx], res_right[idx]);
-    }
-    IVector *new_left = IVector::createVector(dim, res_left);
-    if (new_left == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+        if (err != RC::SUCCESS) {
+            for (size_t created = 0; created < idx; ++created) {
+                delete results[created];
+                results[created] = nullptr;
+            }
+            SendSevere(getLogger(), ILogger::Module::COMPACT, err);
+            return err;
+        }
     }
-    IVector *new_right = IVector::createVector(dim, res_right);
-    if (new_right == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        delete new_left;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+    return RC::SUCCESS;
+}
+
+RC ICompact::createCompactSpans(ICompact const *op, ICompact const *const *others, size_t count,
+                                IMultiIndex const *const grid, ICompact **results) {
+    if (op == nullptr || others == nullptr || grid == nullptr || results == nullptr) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
     }
-    ICompact *union_res = ICompact::createCompact(new_left, new_right, grid);
-    if (union_res == nullptr) {
-        delete com1_left_bound;
-        delete com1_right_bound;
-        delete com2_left_bound;
-        delete com2_right_bound;
-        delete new_left;
-        delete new_right;
-        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+    const size_t dim = op->getDim();
+    if (grid->getDim() != dim) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
     }
-    delete com1_left_bound;
-    delete com1_right_bound;
-    delete com2_left_bound;
-    delete com2_right_bound;
-    delete new_left;
-    delete new_right;
-
-    return union_res;*/        return nullptr;
+    // Then createCompact() fails only without memory
+    RC err = checkGrid(dim, grid->getData());
+    if (err != RC::SUCCESS) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, err);
+        return err;
+    }
+    std::fill_n(results, count, nullptr);
+
+    LocalBuffer<double> bounds(2 * dim);
+    if (bounds.data() == nullptr) {
+        SendSevere(getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return RC::ALLOCATION_ERROR;
+    }
+    double *left = bounds.data();
+    double *right = bounds.data() + dim;
+    const double *op_left = op->getLeftBoundaryData();
+    const double *op_right = op->getRightBoundaryData();
+
+    for (size_t idx = 0; idx < count; ++idx) {
+        err = RC::SUCCESS;
+        if (others[idx] == nullptr)
+            err = RC::NULLPTR_ERROR;
+        else if (others[idx]->getDim() != dim)
+            err = RC::MISMATCHING_DIMENSIONS;
+        else {
+            spanBoxes(dim, op_left, op_right, others[idx]->getLeftBoundaryData(), others[idx]->getRightBoundaryData(),
+                      left, right);
+            results[idx] = CompactImpl::createCompact(dim, left, right, grid->getData());
+            if (results[idx] == nullptr)
+                err = RC::ALLOCATION_ERROR;
+        }
 
+        if (err != RC::SUCCESS) {
+            for (size_t created = 0; created < idx; ++created) {
+                delete results[created];
+                results[created] = nullptr;
+            }
+            SendSevere(getLogger(), ILogger::Module::COMPACT, err);
+            return err;
+        }
+    }
+    return RC::SUCCESS;
 }
 
 ICompact::~ICompact() = default;
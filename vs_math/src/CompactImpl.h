@@ -1,10 +1,18 @@
 #pragma once
 #include "CompactImplControlBlock.h"
+#include "CompactTraversal.h"
 #include "ICompact.h"
+#include "SmallMultiIndex.h"
+#include <atomic>
 
 class LIB_EXPORT CompactImpl : public ICompact {
   public:
     static ICompact *createCompact(IVector const *vec1, IVector const *vec2, IMultiIndex const *nodeQuantities);
+    static ICompact *createCompact(IVector const *vec1, IVector const *vec2, IGridSpec const *gridSpec);
+    // Same as createCompact(), but boundaries and node quantities are given as raw arrays of dim elements. Non-uniform
+    // grid is given by table of node coordinates of all axes one after another, nullptr means uniform grid
+    static ICompact *createCompact(size_t dim, double const *left, double const *right, size_t const *nodes,
+                                   double const *table = nullptr);
 
     ICompact *clone() const override;
 
@@ -12,17 +20,41 @@ class LIB_EXPORT CompactImpl : public ICompact {
     static ILogger *getLogger();
 
     bool isInside(IVector const *const &vec) const override;
+    RC isInsideBatch(double const *const &rows, size_t count, uint8_t *const &mask) const override;
+    RC isInsideBatch(double const *const &rows, size_t count, uint8_t *const &mask,
+                     IMultiIndex const *const &bypassOrder, size_t *const &nodes) const override;
     RC getVectorCopy(IMultiIndex const *index, IVector *&val) const override;
     RC getVectorCoords(IMultiIndex const *index, IVector *const &val) const override;
 
     RC getLeftBoundary(IVector *&vec) const override;
     RC getRightBoundary(IVector *&vec) const override;
+    double const *getLeftBoundaryData() const override;
+    double const *getRightBoundaryData() const override;
     size_t getDim() const override;
     IMultiIndex *getGrid() const override;
+    size_t const *getGridData() const override;
+    size_t getNodesCount() const override;
+
+    RC toLinear(IMultiIndex const *const &index, IMultiIndex const *const &bypassOrder,
+                size_t &nodeIndex) const override;
+    RC fromLinear(size_t nodeIndex, IMultiIndex const *const &bypassOrder, IMultiIndex *const &index) const override;
+    RC getNode(size_t nodeIndex, IMultiIndex const *const &bypassOrder, double *const &coords) const override;
+
+    RC generateNodes(size_t startIndex, size_t count, IMultiIndex const *const &bypassOrder,
+                     double *const &out) const override;
+    RC parallelForEachNode(IMultiIndex const *const &bypassOrder, const std::function<void(size_t, double const *)> &fn,
+                           size_t threads = 0) const override;
+
+    bool isUniform() const override;
+    ICompact *createRefinement(IMultiIndex const *const &first, IMultiIndex const *const &last) const override;
+    RC generateRefinementNodes(IMultiIndex const *const &bypassOrder, double *const &out, size_t capacity,
+                               size_t &count) const override;
 
     class IteratorImpl : public IIterator {
       public:
-        IteratorImpl(IVector *vec, IMultiIndex *idx, IMultiIndex *bypass_order, CompactImplControlBlock *cb);
+        // Iterator takes ownership of coords and traversal (nullptr for lexicographic bypass)
+        IteratorImpl(double *coords, SmallMultiIndex &&idx, SmallMultiIndex &&bypass_order, CompactImplControlBlock *cb,
+                     CompactTraversal *traversal = nullptr);
         ~IteratorImpl();
 
         IIterator *getNext() override;
@@ -37,29 +69,99 @@ class LIB_EXPORT CompactImpl : public ICompact {
 
         RC getVectorCopy(IVector *&val) const override;
         RC getVectorCoords(IVector *const &val) const override;
+        RC getVectorCoords(double *const &buf, size_t dim) const override;
 
       private:
         bool valid;
-        IVector *vector;
-        IMultiIndex *index;
-        IMultiIndex *order;
+        size_t dim;
+        double *coords; // coordinates of current node, updated incrementally by control block
+        SmallMultiIndex index;
+        SmallMultiIndex order;
         CompactImplControlBlock *control_block;
-        static ILogger *logger;
+        CompactTraversal *traversal;
+        static std::atomic<ILogger *> logger;
     };
 
     IIterator *getIterator(IMultiIndex const *const &index, IMultiIndex const *const &bypassOrder) const override;
     IIterator *getBegin(IMultiIndex const *const &bypassOrder) const override;
     IIterator *getEnd(IMultiIndex const *const &bypassOrder) const override;
+    IIterator *getBegin(IMultiIndex const *const &bypassOrder, TRAVERSAL traversal,
+                        IMultiIndex const *const &tileSizes = nullptr) const override;
 
     ~CompactImpl();
 
   private:
-    static ILogger *logger;
+    friend class CompactImplControlBlock;
+
+    static std::atomic<ILogger *> logger;
     const IVector *left_boundary;
     const IVector *right_boundary;
     const IMultiIndex *grid;
     size_t dim;
+    size_t nodes_count;
+    // Raw data of boundaries and grid, cached to avoid virtual getData() calls on hot paths
+    const double *left_coords;
+    const double *right_coords;
+    const size_t *grid_nodes;
+    double *steps; // distance between neighbour nodes along each axis, meaningful only for uniform grid
+    bool uniform;
+    // Coordinates of all nodes of each axis, node pos of axis is coord_table[table_offset[axis] + pos]. Uniform grid
+    // builds it only if total quantity of nodes over axes doesn't exceed COORD_TABLE_LIMIT, nullptr otherwise.
+    // Non-uniform grid always has it
+    static const size_t COORD_TABLE_LIMIT = 1 << 16;
+    double *coord_table;
+    size_t *table_offset;
     CompactImplControlBlock *control_block;
 
-    CompactImpl(const IVector *left, const IVector *right, const IMultiIndex *nodes);
+    // Coordinate of node with position pos along axis, last node lies exactly on right boundary
+    inline double nodeCoord(size_t axis, size_t pos) const {
+        if (coord_table != nullptr)
+            return coord_table[table_offset[axis] + pos];
+        return calcNodeCoord(axis, pos);
+    }
+    inline double calcNodeCoord(size_t axis, size_t pos) const {
+        if (pos + 1 >= grid_nodes[axis])
+            return grid_nodes[axis] > 1 ? right_coords[axis] : left_coords[axis];
+        return left_coords[axis] + pos * steps[axis];
+    }
+    // Fills position and coordinates of node with number nodeIndex in bypass order
+    inline void seekNode(size_t nodeIndex, const size_t *order, size_t *pos, double *coords) const {
+        const size_t *grid_data = grid_nodes;
+        for (size_t idx = 0; idx < dim; ++idx) {
+            size_t axis = order[idx];
+            pos[axis] = nodeIndex % grid_data[axis];
+            nodeIndex /= grid_data[axis];
+            coords[axis] = nodeCoord(axis, pos[axis]);
+        }
+    }
+    // Moves position one node forward in bypass order, rewriting only coordinates of changed axes
+    inline bool stepNode(const size_t *order, size_t *pos, double *coords) const {
+        const size_t *grid_data = grid_nodes;
+        for (size_t idx = 0; idx < dim; ++idx) {
+            size_t axis = order[idx];
+            if (++pos[axis] < grid_data[axis]) {
+                coords[axis] = nodeCoord(axis, pos[axis]);
+                return true;
+            }
+            pos[axis] = 0;
+            coords[axis] = nodeCoord(axis, 0);
+        }
+        return false;
+    }
+    // Checks that bypass order contains every axis exactly once
+    bool isValidOrder(IMultiIndex const *const &bypassOrder) const;
+    // Common argument checks of methods receiving node number and bypass order
+    RC checkNodeArgs(size_t nodeIndex, IMultiIndex const *const &bypassOrder) const;
+
+    // Iterator over nodes starting from index, takes ownership of traversal
+    IIterator *createIterator(SmallMultiIndex &&index, SmallMultiIndex &&bypassOrder,
+                              CompactTraversal *traversal) const;
+    // getIterator() for already valid index
+    IIterator *getIterator(SmallMultiIndex &index, IMultiIndex const *const &bypassOrder) const;
+
+    // Position of node nearest to coordinate x lying between boundaries of axis
+    size_t nearestNode(size_t axis, double x) const;
+
+    // Compact takes ownership of left, right, nodes and table (node coordinates of non-uniform grid, may be nullptr)
+    CompactImpl(IVector *left, IVector *right, IMultiIndex *nodes, double *table = nullptr);
 };
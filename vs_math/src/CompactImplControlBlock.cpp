@@ -1,74 +1,115 @@
 #include "CompactImplControlBlock.h"
 #include "CompactImpl.h"
+#include "CompactTraversal.h"
 
 CompactImplControlBlock::CompactImplControlBlock(CompactImpl *com) : compact(com) {}
 
 RC CompactImplControlBlock::get(IMultiIndex *const &currentIndex, IMultiIndex const *const &bypassOrder) const {
     if (currentIndex == nullptr || bypassOrder == nullptr) {
-        ICompact::getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
-    if (currentIndex->getDim() != bypassOrder->getDim()) {
-        ICompact::getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+    if (currentIndex->getDim() != compact->dim || bypassOrder->getDim() != compact->dim) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
-    IMultiIndex *compact_grid = compact->getGrid();
-    if (compact_grid == nullptr) {
-        ICompact::getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return RC::ALLOCATION_ERROR;
-    }
-    const size_t *compact_grid_data = compact_grid->getData();
+    const size_t *compact_grid_data = compact->getGridData();
     const size_t *order_data = bypassOrder->getData();
     const size_t *index_data = currentIndex->getData();
 
-    for (size_t idx = 0; idx < bypassOrder->getDim(); ++idx) {
+    for (size_t idx = 0; idx < compact->dim; ++idx) {
         size_t odidx = order_data[idx];
-        if (index_data[odidx] == compact_grid_data[odidx]) {
-            currentIndex->setAxisIndex(odidx, 1);
-        } else if (index_data[odidx] < compact_grid_data[odidx]) {
+        if (index_data[odidx] + 1 == compact_grid_data[odidx]) {
+            currentIndex->setAxisIndex(odidx, 0);
+        } else if (index_data[odidx] + 1 < compact_grid_data[odidx]) {
             currentIndex->incAxisIndex(odidx, 1);
-            delete compact_grid;
             return RC::SUCCESS;
         }
     }
-    ICompact::getLogger()->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
-    delete compact_grid;
+    SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
     return RC::INDEX_OUT_OF_BOUND;
 }
 
 RC CompactImplControlBlock::get(IMultiIndex const *const &currentIndex, IVector *const &val) const {
     if (currentIndex == nullptr || val == nullptr) {
-        ICompact::getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
-    IMultiIndex *compact_grid = compact->getGrid();
-    if (compact_grid == nullptr) {
-        ICompact::getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return RC::ALLOCATION_ERROR;
+    // Coordinates are written straight into val, without temporary vector
+    return compact->getVectorCoords(currentIndex, val);
+}
+
+RC CompactImplControlBlock::get(IMultiIndex *const &currentIndex, IMultiIndex const *const &bypassOrder,
+                                double *const &coords) const {
+    if (currentIndex == nullptr || bypassOrder == nullptr || coords == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
     }
-    if (currentIndex->getDim() != compact_grid->getDim()) {
-        ICompact::getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        delete compact_grid;
+    if (currentIndex->getDim() != compact->dim || bypassOrder->getDim() != compact->dim) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
-    for (size_t idx = 0; idx < compact->getDim(); ++idx)
-        if (currentIndex->getData()[idx] > compact_grid->getData()[idx]) {
-            ICompact::getLogger()->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
-            delete compact_grid;
-            return RC::INDEX_OUT_OF_BOUND;
+
+    const size_t *compact_grid_data = compact->getGridData();
+    const size_t *order_data = bypassOrder->getData();
+    const size_t *index_data = currentIndex->getData();
+
+    // Odometer: axes that overflow are reset to the first node, the first one that doesn't is moved one step forward.
+    // Only coordinates of these axes are touched.
+    for (size_t idx = 0; idx < compact->dim; ++idx) {
+        size_t odidx = order_data[idx];
+        if (index_data[odidx] + 1 < compact_grid_data[odidx]) {
+            currentIndex->incAxisIndex(odidx, 1);
+            coords[odidx] = compact->nodeCoord(odidx, index_data[odidx]);
+            return RC::SUCCESS;
         }
-    delete compact_grid;
+        currentIndex->setAxisIndex(odidx, 0);
+        coords[odidx] = compact->nodeCoord(odidx, 0);
+    }
+    return RC::INDEX_OUT_OF_BOUND;
+}
 
-    IVector *vec;
-    RC err = compact->getVectorCopy(currentIndex, vec);
-    if (err != RC::SUCCESS) {
-        ICompact::getLogger()->severe(err, __FILE__, __func__, __LINE__);
-        return err;
+RC CompactImplControlBlock::get(SmallMultiIndex &currentIndex, CompactTraversal &traversal,
+                                double *const &coords) const {
+    if (coords == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (currentIndex.getDim() != compact->dim) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
     }
-    val->setData(currentIndex->getDim(), vec->getData());
-    delete vec;
+    if (!traversal.step())
+        return RC::INDEX_OUT_OF_BOUND;
+
+    const size_t *pos = traversal.getPosition();
+    for (size_t axis = 0; axis < compact->dim; ++axis)
+        if (pos[axis] != currentIndex[axis]) {
+            currentIndex[axis] = pos[axis];
+            coords[axis] = compact->nodeCoord(axis, pos[axis]);
+        }
     return RC::SUCCESS;
 }
 
+RC CompactImplControlBlock::get(SmallMultiIndex &currentIndex, SmallMultiIndex const &bypassOrder,
+                                double *const &coords) const {
+    if (coords == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (currentIndex.getDim() != compact->dim || bypassOrder.getDim() != compact->dim) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    const size_t changed = currentIndex.increment(bypassOrder, compact->getGridData());
+    // The first changed axes were reset to the first node, the last one moved forward
+    for (size_t idx = 0; idx < (changed == 0 ? compact->dim : changed); ++idx) {
+        size_t axis = bypassOrder[idx];
+        coords[axis] = compact->nodeCoord(axis, currentIndex[axis]);
+    }
+    return changed == 0 ? RC::INDEX_OUT_OF_BOUND : RC::SUCCESS;
+}
+
 ICompactControlBlock::~ICompactControlBlock() = default;
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include "ICompactControlBlock.h"
+#include "SmallMultiIndex.h"
 
 class CompactImpl;
+class CompactTraversal;
 
 class CompactImplControlBlock : public ICompactControlBlock {
   public:
@@ -23,6 +25,33 @@ class CompactImplControlBlock : public ICompactControlBlock {
      * @param [in] val Buffer for vector data
      */
     RC get(IMultiIndex const *const &currentIndex, IVector *const &val) const override;
+    /*
+     * Control block moves iterator forward like get(currentIndex, bypassOrder) and updates only coordinates of axes,
+     * whose position was changed
+     *
+     * @param [in] currentIndex Multi-index of current iterator position
+     *
+     * @param [in] bypassOrder Multi-index, that defining bypass orred of axis
+     *
+     * @param [in] coords Caller-owned buffer of getDim() doubles holding coordinates of currentIndex
+     */
+    RC get(IMultiIndex *const &currentIndex, IMultiIndex const *const &bypassOrder,
+           double *const &coords) const override;
+    /*
+     * Control block moves iterator to the next node of traversal and updates coordinates of axes, whose position was
+     * changed
+     *
+     * @param [in] currentIndex Multi-index of current iterator position, the same as position of traversal
+     *
+     * @param [in] traversal Tiled or curve bypass state
+     *
+     * @param [in] coords Caller-owned buffer of getDim() doubles holding coordinates of currentIndex
+     */
+    RC get(SmallMultiIndex &currentIndex, CompactTraversal &traversal, double *const &coords) const;
+    /*
+     * Same as get(currentIndex, bypassOrder, coords) for value multi-indices, doesn't make virtual calls
+     */
+    RC get(SmallMultiIndex &currentIndex, SmallMultiIndex const &bypassOrder, double *const &coords) const;
 
   private:
     CompactImpl *compact;
@@ -1,20 +1,22 @@
 #include "CompactImpl.h"
+#include <cstring>
+#include <utility>
 
-ILogger *CompactImpl::IteratorImpl::logger = nullptr;
+std::atomic<ILogger *> CompactImpl::IteratorImpl::logger(nullptr);
 
-CompactImpl::IteratorImpl::IteratorImpl(IVector *vec, IMultiIndex *idx, IMultiIndex *bypass_order,
-                                        CompactImplControlBlock *cb) {
-    vector = vec;
-    index = idx;
-    order = bypass_order;
+CompactImpl::IteratorImpl::IteratorImpl(double *coords, SmallMultiIndex &&idx, SmallMultiIndex &&bypass_order,
+                                        CompactImplControlBlock *cb, CompactTraversal *traversal)
+    : index(std::move(idx)), order(std::move(bypass_order)) {
+    this->coords = coords;
+    dim = index.getDim();
     control_block = cb;
+    this->traversal = traversal;
     valid = true;
 }
 
 CompactImpl::IteratorImpl::~IteratorImpl() {
-    delete vector;
-    delete index;
-    delete order;
+    delete[] coords;
+    delete traversal;
 }
 
 ILogger *CompactImpl::IteratorImpl::getLogger() { return logger; }
@@ -30,12 +32,13 @@ RC CompactImpl::IteratorImpl::setLogger(ILogger *const pLogger) {
 ICompact::IIterator *CompactImpl::IteratorImpl::getNext() {
     IIterator *copy = clone();
     if (copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
         return nullptr;
     }
     RC err = copy->next();
     if (err != RC::SUCCESS) {
-        logger->severe(err, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, err);
+        delete copy;
         return nullptr;
     }
 
@@ -43,53 +46,57 @@ ICompact::IIterator *CompactImpl::IteratorImpl::getNext() {
 }
 
 ICompact::IIterator *CompactImpl::IteratorImpl::clone() const {
-    IVector *vec_copy = vector->clone();
-    if (vec_copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    SmallMultiIndex index_copy(index), order_copy(order);
+    STATS_ADD(COMPACT_ALLOCATIONS, 2);
+    double *vec_copy = new (std::nothrow) double[dim];
+    if (vec_copy == nullptr || index_copy.getDim() != dim || order_copy.getDim() != dim) {
+        delete[] vec_copy;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
         return nullptr;
     }
-    IMultiIndex *index_copy = index->clone();
-    if (index_copy == nullptr) {
-        delete vec_copy;
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    IMultiIndex *order_copy = order->clone();
-    if (order_copy == nullptr) {
-        delete vec_copy;
-        delete index_copy;
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+    std::memcpy(vec_copy, coords, dim * sizeof(double));
+
+    CompactTraversal *traversal_copy = nullptr;
+    if (traversal != nullptr) {
+        traversal_copy = traversal->clone();
+        if (traversal_copy == nullptr) {
+            delete[] vec_copy;
+            SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+            return nullptr;
+        }
     }
 
-    IIterator *iter_copy = new (std::nothrow) IteratorImpl(vec_copy, index_copy, order_copy, control_block);
+    IteratorImpl *iter_copy = new (std::nothrow)
+        IteratorImpl(vec_copy, std::move(index_copy), std::move(order_copy), control_block, traversal_copy);
     if (iter_copy == nullptr) {
-        delete vec_copy;
-        delete index_copy;
-        delete order_copy;
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        delete[] vec_copy;
+        delete traversal_copy;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
         return nullptr;
     }
+    iter_copy->valid = valid;
 
     return iter_copy;
 }
 
 RC CompactImpl::IteratorImpl::next() {
-    RC err = control_block->get(index, order);
-    if (err != RC::SUCCESS) {
-        if (err == RC::INDEX_OUT_OF_BOUND)
-            valid = false;
-        return err;
-    }
-    return control_block->get(index, vector);
+    if (!valid)
+        return RC::INDEX_OUT_OF_BOUND;
+    STATS_COUNT(COMPACT_ITERATOR_STEPS);
+
+    RC err = traversal != nullptr ? control_block->get(index, *traversal, coords)
+                                  : control_block->get(index, order, coords);
+    if (err == RC::INDEX_OUT_OF_BOUND)
+        valid = false;
+    return err;
 }
 
 bool CompactImpl::IteratorImpl::isValid() const { return valid; }
 
 RC CompactImpl::IteratorImpl::getVectorCopy(IVector *&val) const {
-    val = vector->clone();
+    val = IVector::createVector(dim, coords);
     if (val == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
         return RC::ALLOCATION_ERROR;
     }
     return RC::SUCCESS;
@@ -97,52 +104,48 @@ RC CompactImpl::IteratorImpl::getVectorCopy(IVector *&val) const {
 
 RC CompactImpl::IteratorImpl::getVectorCoords(IVector *const &val) const {
     if (val == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
-    if (val->getDim() != vector->getDim()) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+    if (val->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
-    return val->setData(vector->getDim(), vector->getData());
+    return val->setData(dim, coords);
 }
 
-ICompact::IIterator *CompactImpl::getIterator(IMultiIndex const *const &index,
-                                              IMultiIndex const *const &bypassOrder) const {
-    if (index == nullptr || bypassOrder == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
-        return nullptr;
+RC CompactImpl::IteratorImpl::getVectorCoords(double *const &buf, size_t dim) const {
+    if (buf == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
     }
-    if (index->getDim() != bypassOrder->getDim()) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+    if (dim != this->dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
     }
+    std::memcpy(buf, coords, dim * sizeof(double));
+    return RC::SUCCESS;
+}
 
-    IVector *vec_copy = nullptr;
-    RC err = getVectorCopy(index, vec_copy);
-    if (err != RC::SUCCESS) {
-        logger->severe(err, __FILE__, __func__, __LINE__);
-        return nullptr;
-    }
-    IMultiIndex *index_copy = index->clone();
-    if (index_copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        delete vec_copy;
-        return nullptr;
-    }
-    IMultiIndex *order_copy = bypassOrder->clone();
-    if (order_copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        delete vec_copy;
-        delete index_copy;
+ICompact::IIterator *CompactImpl::createIterator(SmallMultiIndex &&index, SmallMultiIndex &&bypassOrder,
+                                                 CompactTraversal *traversal) const {
+    STATS_ADD(COMPACT_ALLOCATIONS, 2);
+    double *vec_copy = new (std::nothrow) double[dim];
+    if (vec_copy == nullptr || index.getDim() != dim || bypassOrder.getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        delete[] vec_copy;
+        delete traversal;
         return nullptr;
     }
+    for (size_t idx = 0; idx < dim; ++idx)
+        vec_copy[idx] = nodeCoord(idx, index[idx]);
 
-    IteratorImpl *new_iter = new (std::nothrow) IteratorImpl(vec_copy, index_copy, order_copy, control_block);
+    IteratorImpl *new_iter = new (std::nothrow)
+        IteratorImpl(vec_copy, std::move(index), std::move(bypassOrder), control_block, traversal);
     if (new_iter == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
-        delete vec_copy;
-        delete index_copy;
-        delete order_copy;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        delete[] vec_copy;
+        delete traversal;
         return nullptr;
     }
     IteratorImpl::setLogger(logger);
@@ -150,44 +153,81 @@ ICompact::IIterator *CompactImpl::getIterator(IMultiIndex const *const &index,
     return new_iter;
 }
 
-ICompact::IIterator *CompactImpl::getBegin(IMultiIndex const *const &bypassOrder) const {
-    size_t *data = new (std::nothrow) size_t[dim];
-    if (data == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+ICompact::IIterator *CompactImpl::getIterator(IMultiIndex const *const &index,
+                                              IMultiIndex const *const &bypassOrder) const {
+    if (index == nullptr || bypassOrder == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return nullptr;
     }
-    std::fill_n(data, dim, 1);
-    IMultiIndex *index = IMultiIndex::createMultiIndex(dim, data);
-    delete[] data;
-
-    if (index == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    if (index->getDim() != dim || bypassOrder->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
-    IIterator *new_iter = getIterator(index, bypassOrder);
-    delete index;
-    return new_iter;
+    const size_t *index_data = index->getData();
+    for (size_t idx = 0; idx < dim; ++idx)
+        if (index_data[idx] >= grid_nodes[idx]) {
+            SendSevere(logger, ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return nullptr;
+        }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return nullptr;
+    }
+
+    return createIterator(SmallMultiIndex(index), SmallMultiIndex(bypassOrder), nullptr);
+}
+
+ICompact::IIterator *CompactImpl::getBegin(IMultiIndex const *const &bypassOrder) const {
+    SmallMultiIndex index(dim);
+    return getIterator(index, bypassOrder);
 }
 
 ICompact::IIterator *CompactImpl::getEnd(IMultiIndex const *const &bypassOrder) const {
-    size_t *data = new (std::nothrow) size_t[dim];
-    if (data == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    SmallMultiIndex index = SmallMultiIndex::fromData(dim, grid_nodes);
+    for (size_t idx = 0; idx < index.getDim(); ++idx)
+        --index[idx];
+    return getIterator(index, bypassOrder);
+}
+
+ICompact::IIterator *CompactImpl::getIterator(SmallMultiIndex &index, IMultiIndex const *const &bypassOrder) const {
+    if (bypassOrder == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return nullptr;
+    }
+    if (bypassOrder->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return nullptr;
+    }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
         return nullptr;
     }
-    const size_t *grid_data = grid->getData();
-    for (size_t idx = 0; idx < dim; ++idx)
-        data[idx] = grid_data[idx];
-    IMultiIndex *index = IMultiIndex::createMultiIndex(dim, data);
-    delete[] data;
 
-    if (index == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    return createIterator(std::move(index), SmallMultiIndex(bypassOrder), nullptr);
+}
+
+ICompact::IIterator *CompactImpl::getBegin(IMultiIndex const *const &bypassOrder, TRAVERSAL traversal,
+                                           IMultiIndex const *const &tileSizes) const {
+    if (traversal == TRAVERSAL::LEXICOGRAPHIC)
+        return getBegin(bypassOrder);
+    if (bypassOrder == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
         return nullptr;
     }
-    IIterator *new_iter = getIterator(index, bypassOrder);
-    delete index;
-    return new_iter;
+    if (bypassOrder->getDim() != dim || (tileSizes != nullptr && tileSizes->getDim() != dim)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return nullptr;
+    }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return nullptr;
+    }
+
+    CompactTraversal *bypass = CompactTraversal::create(traversal, dim, grid_nodes, bypassOrder->getData(),
+                                                        tileSizes != nullptr ? tileSizes->getData() : nullptr);
+    if (bypass == nullptr)
+        return nullptr;
+    return createIterator(SmallMultiIndex::fromData(dim, bypass->getPosition()), SmallMultiIndex(bypassOrder), bypass);
 }
 
 ILogger *ICompact::IIterator::getLogger() { return CompactImpl::IteratorImpl::getLogger(); }
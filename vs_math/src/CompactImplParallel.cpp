@@ -0,0 +1,77 @@
+#include "CompactImpl.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+// Tiles per thread, more tiles give better balance when fn cost varies over the grid
+const size_t TILES_PER_THREAD = 16;
+} // namespace
+
+RC CompactImpl::parallelForEachNode(IMultiIndex const *const &bypassOrder,
+                                    const std::function<void(size_t, double const *)> &fn, size_t threads) const {
+    if (bypassOrder == nullptr) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+    if (!fn) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return RC::INVALID_ARGUMENT;
+    }
+    if (bypassOrder->getDim() != dim) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+    if (!isValidOrder(bypassOrder)) {
+        SendSevere(logger, ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    STATS_TIMER(COMPACT_SWEEP);
+    STATS_ADD(COMPACT_SWEEP_NODES, nodes_count);
+    if (threads == 0)
+        threads = WorkStealingPool::defaultThreads();
+    const size_t *order_data = bypassOrder->getData();
+
+    // Tile is a range of consecutive nodes in bypass order. Whenever possible it consists of whole runs along the
+    // fastest axis, so each tile covers a box of the grid
+    const size_t fast_nodes = grid_nodes[order_data[0]];
+    size_t tile = std::max<size_t>(1, nodes_count / (threads * TILES_PER_THREAD));
+    if (tile > fast_nodes)
+        tile -= tile % fast_nodes;
+    const size_t tiles = (nodes_count + tile - 1) / tile;
+
+    // Every worker owns its position and coordinates, that are stepped incrementally inside a tile
+    size_t workers = std::min(threads, tiles);
+    size_t *pos = new (std::nothrow) size_t[workers * dim];
+    double *coords = new (std::nothrow) double[workers * dim];
+    if (pos == nullptr || coords == nullptr) {
+        delete[] pos;
+        delete[] coords;
+        SendSevere(logger, ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    // Exception of fn is passed to caller once all workers stopped
+    try {
+        WorkStealingPool::run(tiles, workers, [&](size_t task, size_t worker) {
+            size_t *worker_pos = pos + worker * dim;
+            double *worker_coords = coords + worker * dim;
+            size_t begin = task * tile;
+            size_t end = std::min(begin + tile, nodes_count);
+
+            seekNode(begin, order_data, worker_pos, worker_coords);
+            for (size_t node = begin; node < end; ++node) {
+                fn(node, worker_coords);
+                stepNode(order_data, worker_pos, worker_coords);
+            }
+        });
+    } catch (...) {
+        delete[] pos;
+        delete[] coords;
+        throw;
+    }
+
+    delete[] pos;
+    delete[] coords;
+    return RC::SUCCESS;
+}
@@ -0,0 +1,256 @@
+#include "CompactIndexImpl.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+
+namespace {
+// Quantity of points in one task of batch queries
+const size_t POINTS_PER_TASK = 1024;
+} // namespace
+
+CompactIndexImpl::CompactIndexImpl(size_t dim, size_t size) : dim(dim), size(size), nodes_used(1) {
+    box_left = new (std::nothrow) double[size * dim];
+    box_right = new (std::nothrow) double[size * dim];
+    items = new (std::nothrow) size_t[size];
+    nodes = new (std::nothrow) Node[2 * size];
+    node_left = new (std::nothrow) double[2 * size * dim];
+    node_right = new (std::nothrow) double[2 * size * dim];
+}
+
+CompactIndexImpl::~CompactIndexImpl() {
+    delete[] box_left;
+    delete[] box_right;
+    delete[] items;
+    delete[] nodes;
+    delete[] node_left;
+    delete[] node_right;
+}
+
+ICompactIndex *CompactIndexImpl::createCompactIndex(ICompact const *const *compacts, size_t count, size_t threads) {
+    if (compacts == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return nullptr;
+    }
+    if (count == 0) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return nullptr;
+    }
+    for (size_t idx = 0; idx < count; ++idx)
+        if (compacts[idx] == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+            return nullptr;
+        }
+    const size_t dim = compacts[0]->getDim();
+    for (size_t idx = 1; idx < count; ++idx)
+        if (compacts[idx]->getDim() != dim) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::MISMATCHING_DIMENSIONS);
+            return nullptr;
+        }
+
+    CompactIndexImpl *index = new (std::nothrow) CompactIndexImpl(dim, count);
+    double *centers = new (std::nothrow) double[count * dim];
+    if (index == nullptr || centers == nullptr || index->box_left == nullptr || index->box_right == nullptr ||
+        index->items == nullptr || index->nodes == nullptr || index->node_left == nullptr ||
+        index->node_right == nullptr) {
+        delete index;
+        delete[] centers;
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+
+    for (size_t item = 0; item < count; ++item) {
+        const double *left = compacts[item]->getLeftBoundaryData();
+        const double *right = compacts[item]->getRightBoundaryData();
+        std::memcpy(index->box_left + item * dim, left, dim * sizeof(double));
+        std::memcpy(index->box_right + item * dim, right, dim * sizeof(double));
+        for (size_t idx = 0; idx < dim; ++idx)
+            centers[item * dim + idx] = 0.5 * (left[idx] + right[idx]);
+        index->items[item] = item;
+    }
+
+    if (threads == 0)
+        threads = WorkStealingPool::defaultThreads();
+    index->build(0, 0, count, centers, threads);
+    delete[] centers;
+
+    // Boxes are stored in leaf order, so leaf scans read contiguous memory
+    double *leaf_left = new (std::nothrow) double[count * dim];
+    double *leaf_right = new (std::nothrow) double[count * dim];
+    if (leaf_left == nullptr || leaf_right == nullptr) {
+        delete[] leaf_left;
+        delete[] leaf_right;
+        delete index;
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    for (size_t pos = 0; pos < count; ++pos) {
+        std::memcpy(leaf_left + pos * dim, index->box_left + index->items[pos] * dim, dim * sizeof(double));
+        std::memcpy(leaf_right + pos * dim, index->box_right + index->items[pos] * dim, dim * sizeof(double));
+    }
+    delete[] index->box_left;
+    delete[] index->box_right;
+    index->box_left = leaf_left;
+    index->box_right = leaf_right;
+
+    return index;
+}
+
+void CompactIndexImpl::build(size_t node, size_t first, size_t count, double *centers, size_t threads) {
+    double *left = node_left + node * dim;
+    double *right = node_right + node * dim;
+    std::memcpy(left, box_left + items[first] * dim, dim * sizeof(double));
+    std::memcpy(right, box_right + items[first] * dim, dim * sizeof(double));
+    for (size_t pos = first + 1; pos < first + count; ++pos)
+        for (size_t idx = 0; idx < dim; ++idx) {
+            left[idx] = std::min(left[idx], box_left[items[pos] * dim + idx]);
+            right[idx] = std::max(right[idx], box_right[items[pos] * dim + idx]);
+        }
+
+    if (count <= LEAF_SIZE) {
+        nodes[node].first = first;
+        nodes[node].count = count;
+        return;
+    }
+
+    // Split by median of box centers along axis of the largest centers spread
+    size_t axis = 0;
+    double widest = -1;
+    for (size_t idx = 0; idx < dim; ++idx) {
+        double lo = centers[items[first] * dim + idx], hi = lo;
+        for (size_t pos = first + 1; pos < first + count; ++pos) {
+            lo = std::min(lo, centers[items[pos] * dim + idx]);
+            hi = std::max(hi, centers[items[pos] * dim + idx]);
+        }
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            axis = idx;
+        }
+    }
+    size_t half = count / 2;
+    std::nth_element(items + first, items + first + half, items + first + count,
+                     [centers, axis, this](size_t a, size_t b) {
+                         return centers[a * dim + axis] < centers[b * dim + axis];
+                     });
+
+    size_t children = nodes_used.fetch_add(2);
+    nodes[node].first = children;
+    nodes[node].count = 0;
+
+    std::thread worker;
+    if (threads > 1) {
+        try {
+            worker = std::thread(&CompactIndexImpl::build, this, children, first, half, centers, threads / 2);
+        } catch (std::system_error const &) {
+            // No thread for the left subtree, the calling thread builds both of them
+            threads = 1;
+        }
+    }
+    if (worker.joinable()) {
+        build(children + 1, first + half, count - half, centers, threads - threads / 2);
+        worker.join();
+    } else {
+        build(children, first, half, centers, 1);
+        build(children + 1, first + half, count - half, centers, 1);
+    }
+}
+
+template <class Hit, class Report>
+void CompactIndexImpl::traverse(Hit hit, Report report) const {
+    size_t stack[MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const size_t node = stack[--top];
+        if (!hit(node_left + node * dim, node_right + node * dim))
+            continue;
+        if (nodes[node].count == 0) {
+            stack[top++] = nodes[node].first + 1;
+            stack[top++] = nodes[node].first;
+            continue;
+        }
+        for (size_t pos = nodes[node].first; pos < nodes[node].first + nodes[node].count; ++pos)
+            if (hit(box_left + pos * dim, box_right + pos * dim))
+                report(items[pos]);
+    }
+}
+
+size_t CompactIndexImpl::getDim() const { return dim; }
+
+size_t CompactIndexImpl::getSize() const { return size; }
+
+RC CompactIndexImpl::findContaining(double const *const &point, size_t *const &found, size_t capacity,
+                                    size_t &count) const {
+    if (point == nullptr || (found == nullptr && capacity > 0)) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+
+    size_t total = 0;
+    traverse([this, point](const double *left, const double *right) { return containsPoint(left, right, point); },
+             [&total, found, capacity](size_t item) {
+                 if (total < capacity)
+                     found[total] = item;
+                 ++total;
+             });
+    count = total;
+    return RC::SUCCESS;
+}
+
+RC CompactIndexImpl::findOverlapping(double const *const &left, double const *const &right, size_t *const &found,
+                                     size_t capacity, size_t &count) const {
+    if (left == nullptr || right == nullptr || (found == nullptr && capacity > 0)) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+
+    size_t total = 0;
+    traverse([this, left, right](const double *node_left,
+                                 const double *node_right) { return overlaps(node_left, node_right, left, right); },
+             [&total, found, capacity](size_t item) {
+                 if (total < capacity)
+                     found[total] = item;
+                 ++total;
+             });
+    count = total;
+    return RC::SUCCESS;
+}
+
+RC CompactIndexImpl::findContainingBatch(double const *const &rows, size_t count, size_t *const &offsets,
+                                         size_t *const &found, size_t capacity, size_t threads) const {
+    if (rows == nullptr || offsets == nullptr || (found == nullptr && capacity > 0)) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+        return RC::NULLPTR_ERROR;
+    }
+
+    // First pass counts hits of every point, prefix sums give offsets, second pass writes hits in place
+    const size_t tasks = (count + POINTS_PER_TASK - 1) / POINTS_PER_TASK;
+    size_t *const counts = offsets + 1;
+    WorkStealingPool::run(tasks, threads, [&](size_t task, size_t) {
+        size_t end = std::min(count, (task + 1) * POINTS_PER_TASK);
+        for (size_t point = task * POINTS_PER_TASK; point < end; ++point)
+            findContaining(rows + point * dim, nullptr, 0, counts[point]);
+    });
+    offsets[0] = 0;
+    for (size_t point = 0; point < count; ++point)
+        offsets[point + 1] += offsets[point];
+    if (offsets[count] > capacity)
+        return RC::INDEX_OUT_OF_BOUND;
+
+    WorkStealingPool::run(tasks, threads, [&](size_t task, size_t) {
+        size_t end = std::min(count, (task + 1) * POINTS_PER_TASK);
+        for (size_t point = task * POINTS_PER_TASK; point < end; ++point) {
+            size_t written = 0;
+            findContaining(rows + point * dim, found + offsets[point], offsets[point + 1] - offsets[point], written);
+        }
+    });
+    return RC::SUCCESS;
+}
+
+ICompactIndex *ICompactIndex::createCompactIndex(ICompact const *const *compacts, size_t count, size_t threads) {
+    return CompactIndexImpl::createCompactIndex(compacts, count, threads);
+}
+
+ICompactIndex::~ICompactIndex() = default;
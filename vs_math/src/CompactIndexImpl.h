@@ -0,0 +1,63 @@
+#pragma once
+#include "ICompactIndex.h"
+#include <atomic>
+
+class LIB_EXPORT CompactIndexImpl : public ICompactIndex {
+  public:
+    static ICompactIndex *createCompactIndex(ICompact const *const *compacts, size_t count, size_t threads = 0);
+
+    size_t getDim() const override;
+    size_t getSize() const override;
+
+    RC findContaining(double const *const &point, size_t *const &found, size_t capacity,
+                      size_t &count) const override;
+    RC findOverlapping(double const *const &left, double const *const &right, size_t *const &found, size_t capacity,
+                       size_t &count) const override;
+    RC findContainingBatch(double const *const &rows, size_t count, size_t *const &offsets, size_t *const &found,
+                           size_t capacity, size_t threads = 0) const override;
+
+    ~CompactIndexImpl();
+
+  private:
+    // Leaves hold up to LEAF_SIZE boxes
+    static const size_t LEAF_SIZE = 4;
+    // Median split keeps depth below bits of size_t, so traversal stack fits into fixed array
+    static const size_t MAX_DEPTH = 2 * sizeof(size_t) * 8;
+
+    struct Node {
+        size_t first; // first child for inner node, first position in items for leaf
+        size_t count; // 0 for inner node (children are first and first + 1), quantity of boxes for leaf
+    };
+
+    size_t dim;
+    size_t size;
+    double *box_left;   // boundaries of boxes, size * dim, in order of items
+    double *box_right;
+    size_t *items;      // numbers of compacts in leaf order
+    Node *nodes;
+    double *node_left;  // bounding boxes of nodes, max nodes * dim
+    double *node_right;
+    std::atomic<size_t> nodes_used;
+
+    CompactIndexImpl(size_t dim, size_t size);
+
+    // Builds subtree over items [first, first + count) into node, spawning threads while threads > 1
+    void build(size_t node, size_t first, size_t count, double *centers, size_t threads);
+
+    inline bool containsPoint(const double *left, const double *right, const double *point) const {
+        bool inside = true;
+        for (size_t idx = 0; idx < dim; ++idx)
+            inside &= (point[idx] >= left[idx]) & (point[idx] <= right[idx]);
+        return inside;
+    }
+    inline bool overlaps(const double *left1, const double *right1, const double *left2, const double *right2) const {
+        bool overlap = true;
+        for (size_t idx = 0; idx < dim; ++idx)
+            overlap &= (left1[idx] <= right2[idx]) & (left2[idx] <= right1[idx]);
+        return overlap;
+    }
+
+    // Visits tree calling report(item) for every box satisfying hit(left, right), hit is also used to prune nodes
+    template <class Hit, class Report>
+    void traverse(Hit hit, Report report) const;
+};
@@ -0,0 +1,186 @@
+#include "CompactTraversal.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+// Quantity of arrays of dim elements in traversal buffer: pos, order, tile, origin, axes
+const size_t ARRAYS = 5;
+} // namespace
+
+CompactTraversal::CompactTraversal(ICompact::TRAVERSAL kind, size_t dim, const size_t *grid, size_t *buffer)
+    : kind(kind), dim(dim), grid(grid), buffer(buffer), bits(0), code(0), code_end(1) {
+    pos = buffer;
+    order = buffer + dim;
+    tile = buffer + 2 * dim;
+    origin = buffer + 3 * dim;
+    axes = buffer + 4 * dim;
+}
+
+CompactTraversal::~CompactTraversal() { delete[] buffer; }
+
+CompactTraversal *CompactTraversal::create(ICompact::TRAVERSAL kind, size_t dim, const size_t *grid,
+                                           const size_t *order, const size_t *tile) {
+    if (kind == ICompact::TRAVERSAL::TILED) {
+        if (tile == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+            return nullptr;
+        }
+        for (size_t idx = 0; idx < dim; ++idx)
+            if (tile[idx] == 0) {
+                SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+                return nullptr;
+            }
+    }
+
+    // Curves are built over cube of 2^bits nodes per axis, its codes must fit into 64 bits
+    size_t bits = 0;
+    for (size_t idx = 0; idx < dim; ++idx)
+        while (bits < 64 && ((uint64_t)1 << bits) < grid[idx])
+            ++bits;
+    const bool curve = kind == ICompact::TRAVERSAL::MORTON || kind == ICompact::TRAVERSAL::HILBERT;
+    if (curve && bits * dim >= 64) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+        return nullptr;
+    }
+
+    STATS_ADD(COMPACT_ALLOCATIONS, 2);
+    size_t *buffer = new (std::nothrow) size_t[ARRAYS * dim];
+    if (buffer == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    CompactTraversal *traversal = new (std::nothrow) CompactTraversal(kind, dim, grid, buffer);
+    if (traversal == nullptr) {
+        delete[] buffer;
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    std::memcpy(traversal->order, order, dim * sizeof(size_t));
+    if (tile != nullptr)
+        std::memcpy(traversal->tile, tile, dim * sizeof(size_t));
+    if (curve) {
+        traversal->bits = bits;
+        traversal->code_end = (uint64_t)1 << (bits * dim);
+    }
+    traversal->first();
+    return traversal;
+}
+
+CompactTraversal *CompactTraversal::clone() const {
+    STATS_ADD(COMPACT_ALLOCATIONS, 2);
+    size_t *buffer_copy = new (std::nothrow) size_t[ARRAYS * dim];
+    if (buffer_copy == nullptr) {
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    CompactTraversal *copy = new (std::nothrow) CompactTraversal(kind, dim, grid, buffer_copy);
+    if (copy == nullptr) {
+        delete[] buffer_copy;
+        SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+        return nullptr;
+    }
+    std::memcpy(buffer_copy, buffer, ARRAYS * dim * sizeof(size_t));
+    copy->bits = bits;
+    copy->code = code;
+    copy->code_end = code_end;
+    return copy;
+}
+
+void CompactTraversal::first() {
+    std::fill_n(pos, dim, 0);
+    std::fill_n(origin, dim, 0);
+    code = 0;
+}
+
+bool CompactTraversal::step() {
+    if (kind == ICompact::TRAVERSAL::TILED)
+        return stepTile();
+    return stepCurve();
+}
+
+bool CompactTraversal::stepTile() {
+    // Odometer inside current tile, tiles on the far side of the grid may be cut
+    for (size_t idx = 0; idx < dim; ++idx) {
+        size_t axis = order[idx];
+        size_t end = grid[axis] - origin[axis] > tile[axis] ? origin[axis] + tile[axis] : grid[axis];
+        if (++pos[axis] < end)
+            return true;
+        pos[axis] = origin[axis];
+    }
+    // Odometer over tiles
+    for (size_t idx = 0; idx < dim; ++idx) {
+        size_t axis = order[idx];
+        if (grid[axis] - origin[axis] > tile[axis]) {
+            origin[axis] += tile[axis];
+            std::memcpy(pos, origin, dim * sizeof(size_t));
+            return true;
+        }
+        origin[axis] = 0;
+    }
+    return false;
+}
+
+bool CompactTraversal::stepCurve() {
+    while (++code < code_end) {
+        decode(code);
+        // Aligned block of 2^(level * dim) codes fills a cube of 2^level nodes per axis, whose first node is the point
+        // with lower level bits cleared. If that node is outside, the whole block is skipped
+        size_t level = 0;
+        bool inside = true;
+        for (size_t idx = 0; idx < dim; ++idx) {
+            size_t axis = order[idx];
+            if (axes[idx] < grid[axis])
+                continue;
+            inside = false;
+            size_t axis_level = 0;
+            while (axis_level < bits && ((axes[idx] >> (axis_level + 1)) << (axis_level + 1)) >= grid[axis])
+                ++axis_level;
+            level = std::max(level, axis_level);
+        }
+        if (inside) {
+            for (size_t idx = 0; idx < dim; ++idx)
+                pos[order[idx]] = axes[idx];
+            return true;
+        }
+        const size_t shift = level * dim;
+        code = (((code >> shift) + 1) << shift) - 1;
+    }
+    return false;
+}
+
+void CompactTraversal::decode(uint64_t curve_code) {
+    std::fill_n(axes, dim, 0);
+    if (kind == ICompact::TRAVERSAL::MORTON) {
+        // Bits of code are interleaved over axes, the least significant one belongs to the fastest axis
+        for (size_t level = 0; level < bits; ++level)
+            for (size_t idx = 0; idx < dim; ++idx, curve_code >>= 1)
+                axes[idx] |= (size_t)(curve_code & 1) << level;
+        return;
+    }
+    if (bits == 0)
+        return;
+
+    // Hilbert curve by J. Skilling, "Programming the Hilbert curve": code is split into transposed form, then Gray
+    // decoded and untwisted into axes
+    for (size_t level = 0; level < bits; ++level)
+        for (size_t idx = dim; idx-- > 0; curve_code >>= 1)
+            axes[idx] |= (size_t)(curve_code & 1) << level;
+    size_t t = axes[dim - 1] >> 1;
+    for (size_t idx = dim - 1; idx > 0; --idx)
+        axes[idx] ^= axes[idx - 1];
+    axes[0] ^= t;
+    const size_t side = (size_t)1 << bits;
+    for (size_t q = 2; q != side; q <<= 1) {
+        size_t p = q - 1;
+        for (size_t idx = dim; idx-- > 0;) {
+            if (axes[idx] & q) {
+                axes[0] ^= p;
+            } else {
+                t = (axes[0] ^ axes[idx]) & p;
+                axes[0] ^= t;
+                axes[idx] ^= t;
+            }
+        }
+    }
+}
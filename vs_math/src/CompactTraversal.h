@@ -0,0 +1,54 @@
+#pragma once
+#include "ICompact.h"
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * State of non-lexicographic bypass of compact grid (see ICompact::TRAVERSAL)
+ *
+ * TILED walks nodes of a tile lexicographically, then moves to the next tile. MORTON and HILBERT enumerate codes of the
+ * curve over the smallest cube of 2^bits nodes per axis covering the grid, aligned blocks of codes mapped outside the
+ * grid are skipped at once, so cost of a step doesn't depend on how much of the cube lies outside
+ */
+class CompactTraversal {
+  public:
+    /*
+     * @param [in] grid Node quantities of dim axes, array must outlive traversal
+     *
+     * @param [in] order Bypass order of axes, the first one is the fastest one
+     *
+     * @param [in] tile Tile sizes along axes for TILED, ignored otherwise
+     */
+    static CompactTraversal *create(ICompact::TRAVERSAL kind, size_t dim, const size_t *grid, const size_t *order,
+                                    const size_t *tile);
+    CompactTraversal *clone() const;
+    ~CompactTraversal();
+
+    // Moves to the first node of traversal
+    void first();
+    // Moves to the next node of traversal, returns false if current node is the last one
+    bool step();
+    // Position of current node along each axis
+    const size_t *getPosition() const { return pos; }
+
+  private:
+    ICompact::TRAVERSAL kind;
+    size_t dim;
+    const size_t *grid;
+    size_t *buffer; // holds arrays below
+    size_t *pos;
+    size_t *order;
+    size_t *tile;
+    size_t *origin; // first node of current tile
+    size_t *axes;   // curve coordinates before mapping onto grid axes
+    size_t bits;    // bits per axis of curve code
+    uint64_t code;
+    uint64_t code_end;
+
+    CompactTraversal(ICompact::TRAVERSAL kind, size_t dim, const size_t *grid, size_t *buffer);
+
+    bool stepTile();
+    bool stepCurve();
+    // Writes curve point with given code to axes
+    void decode(uint64_t curve_code);
+};
@@ -0,0 +1,397 @@
+#include "BestPoints.h"
+#include "ISolver.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace {
+// Nodes generated and evaluated at once by one task
+const size_t BLOCK = 512;
+// Nodes of overlapping sub-grids closer than it (part of domain size) along every axis are the same node
+const double SAME_NODE = 1e-9;
+const double NOT_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+// Buffers of one thread of search
+struct Worker {
+    std::vector<double> rows, values;
+    BestPoints best;
+    size_t evaluations;
+    RC err;
+};
+
+class GridSolverImpl : public ISolver {
+  public:
+    static GridSolverImpl *createSolver(GridOptions const &options) {
+        if (options.best == 0) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+            return nullptr;
+        }
+        GridSolverImpl *solver = new (std::nothrow) GridSolverImpl(options);
+        if (solver == nullptr)
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+        return solver;
+    }
+
+    GridSolverImpl *clone() const override {
+        GridSolverImpl *copy = createSolver(options);
+        if (copy == nullptr)
+            return nullptr;
+        if ((problem != nullptr && copy->setProblem(problem) != RC::SUCCESS) ||
+            (args_domain != nullptr && copy->setArgsDomain(args_domain) != RC::SUCCESS) ||
+            (params_domain != nullptr && copy->setParamsDomain(params_domain) != RC::SUCCESS)) {
+            delete copy;
+            return nullptr;
+        }
+        std::copy(solution, solution + solution_dim, copy->solution);
+        copy->solution_dim = solution_dim;
+        copy->summary = summary;
+        if (optima != nullptr && (copy->optima = optima->clone()) == nullptr) {
+            delete copy;
+            return nullptr;
+        }
+        return copy;
+    }
+
+    RC setProblem(IProblem const *const &pProblem) override {
+        if (pProblem == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        IProblem *copy = pProblem->clone();
+        const size_t args_dim = pProblem->getArgsDim(), params_dim = pProblem->getParamsDim();
+        double *memory = new (std::nothrow) double[std::max(args_dim, params_dim)]();
+        // Search runs its own threads over blocks
+        if (copy == nullptr || memory == nullptr || copy->setThreads(1) != RC::SUCCESS) {
+            delete[] memory;
+            delete copy;
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+
+        delete problem;
+        delete[] solution;
+        problem = copy;
+        solution = memory;
+        if (args_domain != nullptr && args_domain->getDim() != args_dim) {
+            delete args_domain;
+            args_domain = nullptr;
+        }
+        if (params_domain != nullptr && params_domain->getDim() != params_dim) {
+            delete params_domain;
+            params_domain = nullptr;
+        }
+        solution_dim = 0;
+        delete optima;
+        optima = nullptr;
+        return RC::SUCCESS;
+    }
+
+    bool isValidArgsDomain(ICompact const *const &domain) const override {
+        return domain != nullptr && (problem == nullptr || domain->getDim() == problem->getArgsDim());
+    }
+    bool isValidParamsDomain(ICompact const *const &domain) const override {
+        return domain != nullptr && (problem == nullptr || domain->getDim() == problem->getParamsDim());
+    }
+    RC setArgsDomain(ICompact const *const &domain) override {
+        return setDomain(args_domain, domain, isValidArgsDomain(domain));
+    }
+    RC setParamsDomain(ICompact const *const &domain) override {
+        return setDomain(params_domain, domain, isValidParamsDomain(domain));
+    }
+
+    RC solveByArgs(IVector const *const &, IVector *const *const &solverParams) override {
+        return solve(true, solverParams);
+    }
+    RC solveByParams(IVector const *const &, IVector *const *const &solverParams) override {
+        return solve(false, solverParams);
+    }
+
+    RC getSolution(IVector *&result) const override {
+        if (solution_dim == 0) {
+            SendWarning(ISolver::getLogger(), ILogger::Module::SOLVER, RC::NO_ARGS_SET);
+            return RC::NO_ARGS_SET;
+        }
+        result = IVector::createVector(solution_dim, solution);
+        if (result == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        return RC::SUCCESS;
+    }
+    RC getOptima(ISet *&result) const override {
+        if (solution_dim == 0) {
+            SendWarning(ISolver::getLogger(), ILogger::Module::SOLVER, RC::NO_ARGS_SET);
+            return RC::NO_ARGS_SET;
+        }
+        result = optima->clone();
+        if (result == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        return RC::SUCCESS;
+    }
+    Summary getSummary() const override { return summary; }
+
+    ~GridSolverImpl() override {
+        delete args_domain;
+        delete params_domain;
+        delete optima;
+        delete problem;
+        delete[] solution;
+    }
+
+  private:
+    GridOptions options;
+    IProblem *problem;
+    ICompact *args_domain, *params_domain;
+    // Buffer of max(args, params) dimension, solution_dim is 0 until the first successful solve
+    double *solution;
+    size_t solution_dim;
+    Summary summary;
+    // The best nodes of the last solve
+    ISet *optima;
+
+    explicit GridSolverImpl(GridOptions const &options)
+        : options(options), problem(nullptr), args_domain(nullptr), params_domain(nullptr), solution(nullptr),
+          solution_dim(0), summary(), optima(nullptr) {}
+
+    RC setDomain(ICompact *&side, ICompact const *domain, bool valid) {
+        if (domain == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (!valid) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        ICompact *copy = domain->clone();
+        if (copy == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        delete side;
+        side = copy;
+        return RC::SUCCESS;
+    }
+
+    RC solve(bool by_args, IVector *const *solverParams) {
+        if (problem == nullptr) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::NO_PROBLEM_SET);
+            return RC::NO_PROBLEM_SET;
+        }
+        ICompact const *domain = by_args ? args_domain : params_domain;
+        const size_t dim = by_args ? problem->getArgsDim() : problem->getParamsDim();
+        if (domain == nullptr || dim == 0) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+        size_t levels = options.levels;
+        if (solverParams != nullptr && solverParams[0] != nullptr) {
+            double const level_data = solverParams[0]->getData()[0];
+            if (!(level_data >= 0)) {
+                SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+                return RC::INVALID_ARGUMENT;
+            }
+            levels = (size_t)level_data;
+        }
+        solution_dim = 0;
+        delete optima;
+        optima = nullptr;
+
+        std::vector<size_t> axes;
+        std::vector<double> same;
+        std::vector<Worker> workers;
+        // Sub-grids of the current level, the first level is domain itself. There are at most options.best of them,
+        // so the levels don't allocate them
+        std::vector<ICompact const *> cells;
+        std::vector<ICompact *> refined, next;
+        BestPoints merged;
+        try {
+            axes.resize(dim);
+            same.resize(dim);
+            workers.resize(options.threads == 0 ? WorkStealingPool::defaultThreads() : options.threads);
+            for (size_t worker = 0; worker < workers.size(); ++worker) {
+                workers[worker].rows.resize(BLOCK * dim);
+                workers[worker].values.resize(BLOCK);
+            }
+            cells.reserve(options.best);
+            refined.reserve(options.best);
+            next.reserve(options.best);
+        } catch (std::bad_alloc const &) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        for (size_t axis = 0; axis < dim; ++axis) {
+            axes[axis] = axis;
+            same[axis] = SAME_NODE * (domain->getRightBoundaryData()[axis] - domain->getLeftBoundaryData()[axis]);
+        }
+        cells.push_back(domain);
+        IMultiIndex *bypass = IMultiIndex::createMultiIndex(dim, axes.data());
+        IMultiIndex *position = IMultiIndex::createMultiIndex(dim, axes.data());
+        IMultiIndex *first = IMultiIndex::createMultiIndex(dim, axes.data());
+        IMultiIndex *last = IMultiIndex::createMultiIndex(dim, axes.data());
+        Summary result = {1, 0, 0, 0, NOT_NUMBER, false};
+        summary = result;
+        RC err = bypass == nullptr || position == nullptr || first == nullptr || last == nullptr
+                     ? RC::ALLOCATION_ERROR
+                     : RC::SUCCESS;
+        for (size_t level = 0; level <= levels && err == RC::SUCCESS; ++level) {
+            err = searchCells(by_args, dim, cells, bypass, same.data(), workers, merged);
+            ++summary.iterations;
+            if (err != RC::SUCCESS || level == levels || merged.size == 0)
+                break;
+
+            // Sub-grids over cells adjacent to the best nodes replace grids of this level
+            err = refine(dim, cells, merged, bypass, position, first, last, next);
+            for (size_t idx = 0; idx < refined.size(); ++idx)
+                delete refined[idx];
+            refined.swap(next);
+            next.clear();
+            cells.assign(refined.begin(), refined.end());
+        }
+        for (size_t idx = 0; idx < refined.size(); ++idx)
+            delete refined[idx];
+        delete last;
+        delete first;
+        delete position;
+        delete bypass;
+        if (err == RC::SUCCESS && merged.size == 0)
+            err = RC::NOT_NUMBER;
+        if (err == RC::SUCCESS)
+            err = collectOptima(dim, merged);
+        if (err != RC::SUCCESS) {
+            SendSevere(ISolver::getLogger(), ILogger::Module::SOLVER, err);
+            return err;
+        }
+        std::copy(merged.coords.data(), merged.coords.data() + dim, solution);
+        solution_dim = dim;
+        summary.value = merged.values[0];
+        summary.converged = true;
+        return RC::SUCCESS;
+    }
+
+    /*
+     * Evaluates all nodes of cells by blocks, merged gets the best of them. The first block goes before the others (see
+     * WorkStealingPool.h)
+     */
+    RC searchCells(bool by_args, size_t dim, std::vector<ICompact const *> const &cells, IMultiIndex const *bypass,
+                   double const *same, std::vector<Worker> &workers, BestPoints &merged) {
+        // Blocks of cell c are tasks first_task[c]...first_task[c + 1] - 1
+        std::vector<size_t> first_task;
+        try {
+            first_task.resize(cells.size() + 1);
+            for (size_t worker = 0; worker < workers.size(); ++worker)
+                workers[worker].best.reset(options.best, dim);
+            merged.reset(options.best, dim);
+        } catch (std::bad_alloc const &) {
+            return RC::ALLOCATION_ERROR;
+        }
+        for (size_t cell = 0; cell < cells.size(); ++cell)
+            first_task[cell + 1] = first_task[cell] + (cells[cell]->getNodesCount() + BLOCK - 1) / BLOCK;
+        for (size_t worker = 0; worker < workers.size(); ++worker) {
+            workers[worker].evaluations = 0;
+            workers[worker].err = RC::SUCCESS;
+        }
+
+        auto searchBlock = [&](size_t task, size_t worker_idx) {
+            Worker &worker = workers[worker_idx];
+            if (worker.err != RC::SUCCESS)
+                return;
+            const size_t cell = (size_t)(std::upper_bound(first_task.begin(), first_task.end(), task) -
+                                         first_task.begin()) -
+                                1;
+            const size_t start = (task - first_task[cell]) * BLOCK;
+            const size_t count = std::min(BLOCK, cells[cell]->getNodesCount() - start);
+            double *rows = worker.rows.data(), *values = worker.values.data();
+            worker.err = cells[cell]->generateNodes(start, count, bypass, rows);
+            if (worker.err == RC::SUCCESS)
+                worker.err = by_args ? problem->evalByArgsBatch(rows, count, values)
+                                     : problem->evalByParamsBatch(rows, count, values);
+            if (worker.err != RC::SUCCESS)
+                return;
+            worker.evaluations += count;
+            double threshold = worker.best.threshold();
+            for (size_t row = 0; row < count; ++row) {
+                if (values[row] <= threshold && std::isfinite(values[row])) {
+                    worker.best.push(values[row], rows + row * dim, cell, start + row, same);
+                    threshold = worker.best.threshold();
+                }
+            }
+        };
+        const size_t tasks = first_task.back();
+        if (tasks > 0) {
+            searchBlock(0, 0);
+            if (workers[0].err == RC::SUCCESS)
+                WorkStealingPool::run(tasks - 1, workers.size(),
+                                      [&](size_t task, size_t worker) { searchBlock(task + 1, worker); });
+        }
+
+        for (size_t worker = 0; worker < workers.size(); ++worker) {
+            if (workers[worker].err != RC::SUCCESS)
+                return workers[worker].err;
+            summary.evaluations += workers[worker].evaluations;
+            merged.merge(workers[worker].best, same);
+        }
+        return RC::SUCCESS;
+    }
+
+    /*
+     * Creates refinement of cell of every node of merged between its neighbour nodes, next gets even partial result.
+     * next must have capacity for merged.size sub-grids, so that pushing them doesn't throw
+     */
+    RC refine(size_t dim, std::vector<ICompact const *> const &cells, BestPoints const &merged, IMultiIndex const *bypass,
+              IMultiIndex *position, IMultiIndex *first, IMultiIndex *last, std::vector<ICompact *> &next) {
+        std::vector<size_t> low, high;
+        try {
+            low.resize(dim);
+            high.resize(dim);
+        } catch (std::bad_alloc const &) {
+            return RC::ALLOCATION_ERROR;
+        }
+        for (size_t idx = 0; idx < merged.size; ++idx) {
+            ICompact const *cell = cells[merged.groups[idx]];
+            RC err = cell->fromLinear(merged.items[idx], bypass, position);
+            if (err != RC::SUCCESS)
+                return err;
+            for (size_t axis = 0; axis < dim; ++axis) {
+                const size_t node = position->getData()[axis];
+                low[axis] = node > 0 ? node - 1 : 0;
+                high[axis] = std::min(node + 1, cell->getGridData()[axis] - 1);
+            }
+            err = first->setData(dim, low.data());
+            if (err == RC::SUCCESS)
+                err = last->setData(dim, high.data());
+            if (err != RC::SUCCESS)
+                return err;
+            ICompact *sub = cell->createRefinement(first, last);
+            if (sub == nullptr)
+                return RC::ALLOCATION_ERROR;
+            next.push_back(sub);
+        }
+        return RC::SUCCESS;
+    }
+
+    RC collectOptima(size_t dim, BestPoints const &merged) {
+        ISet *set = ISet::createSet();
+        IVector *point = IVector::createVector(dim, merged.coords.data());
+        RC err = set == nullptr || point == nullptr ? RC::ALLOCATION_ERROR : RC::SUCCESS;
+        for (size_t idx = 0; idx < merged.size && err == RC::SUCCESS; ++idx) {
+            err = point->setData(dim, merged.coords.data() + idx * dim);
+            if (err == RC::SUCCESS)
+                err = set->insert(point, IVector::NORM::CHEBYSHEV, 0);
+        }
+        delete point;
+        if (err != RC::SUCCESS) {
+            delete set;
+            return err;
+        }
+        optima = set;
+        return RC::SUCCESS;
+    }
+};
+}; // namespace
+
+ISolver *ISolver::createGridSolver(GridOptions const &options) { return GridSolverImpl::createSolver(options); }
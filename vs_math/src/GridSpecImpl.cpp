@@ -0,0 +1,149 @@
+#include "ICompact.h"
+#include "IGridSpec.h"
+#include <cmath>
+#include <new>
+#include <vector>
+
+namespace {
+class GridSpecImpl : public IGridSpec {
+  public:
+    static IGridSpec *createGridSpec(IMultiIndex const *const &nodeQuantities) {
+        if (nodeQuantities == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+            return nullptr;
+        }
+        GridSpecImpl *spec = new (std::nothrow) GridSpecImpl(nodeQuantities->getDim());
+        if (spec == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+            return nullptr;
+        }
+        for (size_t axis = 0; axis < nodeQuantities->getDim(); ++axis) {
+            RC err = spec->setAxis(axis, SPACING::UNIFORM, nodeQuantities->getData()[axis], 1);
+            if (err != RC::SUCCESS) {
+                delete spec;
+                return nullptr;
+            }
+        }
+        return spec;
+    }
+
+    IGridSpec *clone() const override {
+        GridSpecImpl *spec = new (std::nothrow) GridSpecImpl(getDim());
+        if (spec == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::ALLOCATION_ERROR);
+            return nullptr;
+        }
+        spec->positions = positions;
+        spec->spacings = spacings;
+        return spec;
+    }
+
+    size_t getDim() const override { return positions.size(); }
+
+    size_t getNodes(size_t axis) const override {
+        if (axis >= getDim()) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return 0;
+        }
+        return positions[axis].size();
+    }
+
+    SPACING getSpacing(size_t axis) const override {
+        if (axis >= getDim()) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return SPACING::UNIFORM;
+        }
+        return spacings[axis];
+    }
+
+    double const *getAxisNodes(size_t axis) const override {
+        if (axis >= getDim()) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return nullptr;
+        }
+        return positions[axis].data();
+    }
+
+    bool isUniform() const override {
+        for (size_t axis = 0; axis < getDim(); ++axis)
+            if (spacings[axis] != SPACING::UNIFORM)
+                return false;
+        return true;
+    }
+
+    RC setAxis(size_t axis, SPACING spacing, size_t nodes, double ratio) override {
+        if (axis >= getDim()) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return RC::INDEX_OUT_OF_BOUND;
+        }
+        if (nodes == 0 || spacing == SPACING::CUSTOM) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+        if (spacing == SPACING::GEOMETRIC && (std::isnan(ratio) || std::isinf(ratio) || ratio <= 0)) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+
+        const double pi = std::acos(-1.0);
+        std::vector<double> axis_nodes(nodes, 0.0);
+        for (size_t pos = 1; pos < nodes; ++pos) {
+            double share = (double)pos / (nodes - 1);
+            switch (spacing) {
+            case SPACING::CHEBYSHEV:
+                axis_nodes[pos] = 0.5 * (1.0 - std::cos(pi * share));
+                break;
+            case SPACING::GEOMETRIC:
+                // (q^k - 1) / (q^(n-1) - 1), ratio close to 1 degenerates to uniform spacing
+                if (std::fabs(ratio - 1.0) < 1e-12)
+                    axis_nodes[pos] = share;
+                else
+                    axis_nodes[pos] = (std::pow(ratio, (double)pos) - 1.0) / (std::pow(ratio, (double)(nodes - 1)) - 1.0);
+                break;
+            default:
+                axis_nodes[pos] = share;
+            }
+        }
+        if (nodes > 1)
+            axis_nodes[nodes - 1] = 1.0;
+
+        positions[axis].swap(axis_nodes);
+        spacings[axis] = spacing;
+        return RC::SUCCESS;
+    }
+
+    RC setAxisNodes(size_t axis, size_t nodes, double const *const &axisPositions) override {
+        if (axis >= getDim()) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INDEX_OUT_OF_BOUND);
+            return RC::INDEX_OUT_OF_BOUND;
+        }
+        if (axisPositions == nullptr) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        bool valid = nodes > 0 && axisPositions[0] == 0.0 && (nodes == 1 || axisPositions[nodes - 1] == 1.0);
+        for (size_t pos = 1; valid && pos < nodes; ++pos)
+            valid = axisPositions[pos] > axisPositions[pos - 1];
+        if (!valid) {
+            SendSevere(ICompact::getLogger(), ILogger::Module::COMPACT, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+
+        positions[axis].assign(axisPositions, axisPositions + nodes);
+        spacings[axis] = SPACING::CUSTOM;
+        return RC::SUCCESS;
+    }
+
+  private:
+    std::vector<std::vector<double>> positions;
+    std::vector<SPACING> spacings;
+
+    GridSpecImpl(size_t dim) : positions(dim), spacings(dim, SPACING::UNIFORM) {}
+};
+}; // namespace
+
+IGridSpec *IGridSpec::createGridSpec(IMultiIndex const *const &nodeQuantities) {
+    return GridSpecImpl::createGridSpec(nodeQuantities);
+}
+
+IGridSpec::~IGridSpec() = default;
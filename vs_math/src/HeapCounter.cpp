@@ -0,0 +1,38 @@
+#include "Stats.h"
+#include <cstdlib>
+#include <new>
+
+/*
+ * Replacements of global allocation functions, which count heap blocks of calling thread with
+ * Stats::countHeapAllocation(). Every library carries the file: on Windows operator new is resolved inside each module,
+ * on other systems the first definition serves the whole process
+ */
+#ifdef VS_MATH_HEAP_COUNTER
+namespace {
+void *allocate(size_t size) {
+    Stats::countHeapAllocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocateOrThrow(size_t size) {
+    void *block = allocate(size);
+    while (block == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+        block = std::malloc(size == 0 ? 1 : size);
+    }
+    return block;
+}
+}; // namespace
+
+void *operator new(size_t size) { return allocateOrThrow(size); }
+void *operator new[](size_t size) { return allocateOrThrow(size); }
+void *operator new(size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void *operator new[](size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete[](void *block) noexcept { std::free(block); }
+void operator delete(void *block, std::nothrow_t const &) noexcept { std::free(block); }
+void operator delete[](void *block, std::nothrow_t const &) noexcept { std::free(block); }
+#endif
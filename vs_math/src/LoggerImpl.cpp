@@ -1,7 +1,7 @@
 #include "ILogger.h"
+#include "LoggerMessages.h"
 #include <fstream>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -26,20 +26,36 @@ class LoggerImpl : public ILogger {
         return log(code, level);
     }
     RC log(RC code, Level level) override {
-        *logstream << "[" << levelToStrMap[level] << "] " << errMsgMap[code] << std::endl;
+        *logstream << "[" << LoggerMessages::level(level) << "] " << LoggerMessages::message(code) << std::endl;
         return RC::SUCCESS;
     }
 
+    RC logRepeated(RC code, Level level, const char *const &srcfile, const char *const &function, int line,
+                   size_t count) override {
+        if (count <= 1)
+            return log(code, level, srcfile, function, line);
+        if (srcfile == nullptr || function == nullptr) {
+            severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return RC::NULLPTR_ERROR;
+        }
+
+        *logstream << "[" << srcfile << "] "
+                   << "[" << function << "] "
+                   << "[" << line << "] "
+                   << "[" << LoggerMessages::level(level) << "] " << LoggerMessages::message(code) << " (repeated "
+                   << count << " times)" << std::endl;
+        return RC::SUCCESS;
+    }
+
+    RC flush() override {
+        logstream->flush();
+        return logstream->good() ? RC::SUCCESS : RC::IO_ERROR;
+    }
+
   private:
     std::ostream *logstream;
-    std::map<RC, std::string> errMsgMap;
-    std::map<Level, std::string> levelToStrMap;
 
-    LoggerImpl() {
-        logstream = &std::cout;
-        InitLevelToStrMap();
-        InitErrMsgMap();
-    }
+    LoggerImpl() { logstream = &std::cout; }
 
     LoggerImpl(const std::string &filename, bool overwrite = true) {
         std::ios_base::openmode writeMode;
@@ -49,38 +65,6 @@ class LoggerImpl : public ILogger {
             writeMode = std::ios::app;
 
         logstream = new std::ofstream(filename, writeMode);
-
-        InitLevelToStrMap();
-        InitErrMsgMap();
-    }
-
-    void InitErrMsgMap() {
-        errMsgMap.insert({RC::UNKNOWN, "Unknown error occured"});
-        errMsgMap.insert({RC::SUCCESS, "Successful"});
-        errMsgMap.insert({RC::INVALID_ARGUMENT, "Received invalid argument"});
-        errMsgMap.insert({RC::MISMATCHING_DIMENSIONS, "Cannot operate on two vectors with different dimensions"});
-        errMsgMap.insert({RC::INDEX_OUT_OF_BOUND, "Index out of bound"});
-        errMsgMap.insert({RC::INFINITY_OVERFLOW, "Received number greater than infinity"});
-        errMsgMap.insert({RC::NOT_NUMBER, "Argument declared a number but turned out not to be one"});
-        errMsgMap.insert({RC::ALLOCATION_ERROR, "Couldn't allocate more memory"});
-        errMsgMap.insert({RC::NULLPTR_ERROR, "Received nullptr instead of a valid pointer"});
-        errMsgMap.insert({RC::FILE_NOT_FOUND, "Couldn't open file, maybe it doesn't exist"});
-        errMsgMap.insert({RC::VECTOR_NOT_FOUND, "Couldn't find matching IVector instance"});
-        errMsgMap.insert({RC::IO_ERROR, "Input or output stream is unavailable"});
-        errMsgMap.insert({RC::MEMORY_INTERSECTION, "Found intersecting memory parts"});
-        errMsgMap.insert({RC::SOURCE_SET_DESTROYED, "Iterator trying to work with dead set"});
-        errMsgMap.insert({RC::SOURCE_COMPACT_DESTROYED, "Iterator trying to work with dead compact"});
-        errMsgMap.insert({RC::SOURCE_SET_EMPTY, "Iterator trying to move to the begin/end of empty set"});
-        errMsgMap.insert({RC::VECTOR_ALREADY_EXIST, "Given vector already exists in current set"});
-        errMsgMap.insert({RC::SET_INDEX_OVERFLOW, "Set index too big"});
-        errMsgMap.insert({RC::NO_ARGS_SET, "No arguments set for problem to evaluate or for solver to solve"});
-        errMsgMap.insert({RC::NO_PARAMS_SET, "No params set for problem to evaluate or for solver to solve"});
-        errMsgMap.insert({RC::NO_PROBLEM_SET, "No problem set for solver to solve"});
-    }
-    void InitLevelToStrMap() {
-        levelToStrMap.insert({Level::SEVERE, "SEVERE"});
-        levelToStrMap.insert({ILogger::Level::WARNING, "WARNING"});
-        levelToStrMap.insert({Level::INFO, "INFO"});
     }
 
     ~LoggerImpl() {
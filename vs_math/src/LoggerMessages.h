@@ -0,0 +1,51 @@
+#pragma once
+#include "ILogger.h"
+#include "RC.h"
+
+/*
+ * Text of error codes and levels shared by logger implementations
+ *
+ * Lookup is indexing of static arrays, so it's cheap enough to be done for every record
+ */
+namespace LoggerMessages {
+inline const char *message(RC code) {
+    static const char *const messages[] = {
+        "Unknown error occured",
+        "Successful",
+        "Received invalid argument",
+        "Cannot operate on two vectors with different dimensions",
+        "Index out of bound",
+        "Received number greater than infinity",
+        "Argument declared a number but turned out not to be one",
+        "Couldn't allocate more memory",
+        "Received nullptr instead of a valid pointer",
+        "Couldn't open file, maybe it doesn't exist",
+        "Couldn't find matching IVector instance",
+        "Input or output stream is unavailable",
+        "Found intersecting memory parts",
+        "Iterator trying to work with dead set",
+        "Iterator trying to work with dead compact",
+        "Iterator trying to move to the begin/end of empty set",
+        "Given vector already exists in current set",
+        "Set index too big",
+        "No arguments set for problem to evaluate or for solver to solve",
+        "No params set for problem to evaluate or for solver to solve",
+        "No problem set for solver to solve",
+    };
+    static_assert(sizeof(messages) / sizeof(messages[0]) == (size_t)RC::AMOUNT, "Every RC must have a message");
+    size_t idx = (size_t)code;
+    return idx < (size_t)RC::AMOUNT ? messages[idx] : messages[0];
+}
+
+inline const char *level(ILogger::Level level) {
+    switch (level) {
+    case ILogger::Level::SEVERE:
+        return "SEVERE";
+    case ILogger::Level::WARNING:
+        return "WARNING";
+    case ILogger::Level::INFO:
+        return "INFO";
+    }
+    return "UNKNOWN";
+}
+}; // namespace LoggerMessages
@@ -5,7 +5,7 @@
 #include <cstdint>
 
 
-__declspec(dllexport) ILogger *MultiIndexImpl::logger = nullptr;
+__declspec(dllexport) std::atomic<ILogger *> MultiIndexImpl::logger(nullptr);
 
 RC MultiIndexImpl::setLogger(ILogger *const pLogger) {
     if (pLogger == nullptr)
@@ -20,17 +20,18 @@ MultiIndexImpl::MultiIndexImpl(size_t dim) : dim(dim) {}
 
 IMultiIndex *MultiIndexImpl::createMultiIndex(size_t dim, const size_t *indices) {
     if (dim == 0) {
-        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::INVALID_ARGUMENT);
         return nullptr;
     }
     if (indices == nullptr) {
-        logger->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::MULTI_INDEX, RC::NULLPTR_ERROR);
         return nullptr;
     }
 
+    STATS_COUNT(MULTI_INDEX_ALLOCATIONS);
     uint8_t *ptr = new (std::nothrow) uint8_t[sizeof(MultiIndexImpl) + dim * sizeof(size_t)];
     if (ptr == nullptr) {
-        logger->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::MULTI_INDEX, RC::ALLOCATION_ERROR);
         return nullptr;
     }
     IMultiIndex *multi_ind = new (ptr) MultiIndexImpl(dim);
@@ -47,16 +48,16 @@ size_t MultiIndexImpl::getDim() const { return dim; }
 
 RC MultiIndexImpl::setData(size_t dim, size_t const *const &ptr_data) {
     if (this->dim != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (ptr_data == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     for (size_t idx = 0; idx < dim; ++idx)
         if (std::isnan((double)ptr_data[idx]) || std::isinf((double)ptr_data[idx])) {
-            logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+            SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::NOT_NUMBER);
             return RC::NOT_NUMBER;
         }
 
@@ -67,7 +68,7 @@ RC MultiIndexImpl::setData(size_t dim, size_t const *const &ptr_data) {
 
 RC MultiIndexImpl::getAxisIndex(size_t index, size_t &val) const {
     if (index >= dim) {
-        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
 
@@ -77,7 +78,7 @@ RC MultiIndexImpl::getAxisIndex(size_t index, size_t &val) const {
 
 RC MultiIndexImpl::setAxisIndex(size_t index, size_t val) {
     if (index >= dim) {
-        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
 
@@ -87,7 +88,7 @@ RC MultiIndexImpl::setAxisIndex(size_t index, size_t val) {
 
 RC MultiIndexImpl::incAxisIndex(size_t index, __int64 val) {
     if (index >= dim) {
-        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::MULTI_INDEX, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "IMultiIndex.h"
+#include <atomic>
 
 #define PTR_DATA (size_t *)((uint8_t *)(this) + sizeof(MultiIndexImpl))
 
@@ -25,7 +26,7 @@ class LIB_EXPORT MultiIndexImpl : public IMultiIndex {
 
   private:
     size_t dim;
-    static ILogger *logger;
+    static std::atomic<ILogger *> logger;
 
   protected:
     MultiIndexImpl(size_t dim);
@@ -0,0 +1,398 @@
+#include "IDiffProblem.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace {
+// Rows evaluated by one call of batch function of kernel
+const size_t TILE_ROWS = 1024;
+// Smaller batches are evaluated by calling thread only, starting threads would cost more than evaluation
+const size_t PARALLEL_MIN_ROWS = 16 * TILE_ROWS;
+// Finite differences of higher total order lose all precision to rounding
+const size_t MAX_DIFFERENCE_ORDER = 4;
+const double NOT_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+// Buffer of calling thread for shifted points and gradients, it grows to the largest dimension once
+template <class T>
+T *scratch(size_t size) {
+    static thread_local std::vector<T> buffer;
+    if (buffer.size() < size)
+        buffer.resize(size);
+    return buffer.data();
+}
+
+size_t binomial(size_t n, size_t k) {
+    size_t result = 1;
+    for (size_t idx = 1; idx <= k; ++idx)
+        result = result * (n - k + idx) / idx;
+    return result;
+}
+
+class ProblemImpl : public IDiffProblem {
+  public:
+    static RC setLogger(ILogger *const pLogger, bool diff) {
+        if (pLogger == nullptr)
+            return RC::NULLPTR_ERROR;
+        (diff ? diff_logger : logger) = pLogger;
+        return RC::SUCCESS;
+    }
+    static ILogger *getLogger(bool diff) { return diff ? diff_logger : logger; }
+
+    static ProblemImpl *createProblem(ICompact const *params, ICompact const *args, Kernel const &kernel) {
+        if (args == nullptr || kernel.eval == nullptr) {
+            SendSevere(logger, ILogger::Module::PROBLEM, RC::NULLPTR_ERROR);
+            return nullptr;
+        }
+        ICompact *args_domain = args->clone();
+        ICompact *params_domain = params == nullptr ? nullptr : params->clone();
+        ProblemImpl *problem = nullptr;
+        if (args_domain != nullptr && (params == nullptr || params_domain != nullptr))
+            problem = new (std::nothrow) ProblemImpl(params_domain, args_domain, kernel);
+        if (problem == nullptr || problem->args_data == nullptr || problem->params_data == nullptr) {
+            if (problem != nullptr)
+                delete problem;
+            else {
+                delete args_domain;
+                delete params_domain;
+            }
+            SendSevere(logger, ILogger::Module::PROBLEM, RC::ALLOCATION_ERROR);
+            return nullptr;
+        }
+        return problem;
+    }
+
+    ProblemImpl *clone() const override {
+        ProblemImpl *copy = createProblem(params_domain, args_domain, kernel);
+        if (copy == nullptr)
+            return nullptr;
+        std::copy(args_data, args_data + args_dim, copy->args_data);
+        std::copy(params_data, params_data + params_dim, copy->params_data);
+        copy->args_set = args_set;
+        copy->params_set = params_set;
+        copy->threads = threads;
+        return copy;
+    }
+
+    bool isValidParams(IVector const *const &params) const override {
+        return params != nullptr && params_domain != nullptr && params->getDim() == params_dim &&
+               params_domain->isInside(params);
+    }
+    bool isValidArgs(IVector const *const &args) const override {
+        return args != nullptr && args->getDim() == args_dim && args_domain->isInside(args);
+    }
+
+    RC setParams(IVector const *const &params) override {
+        RC err = checkPoint(params, params_domain == nullptr ? 0 : params_dim, logger);
+        if (err != RC::SUCCESS)
+            return err;
+        if (!params_domain->isInside(params)) {
+            SendWarning(logger, ILogger::Module::PROBLEM, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+        std::memcpy(params_data, params->getData(), params_dim * sizeof(double));
+        params_set = true;
+        return RC::SUCCESS;
+    }
+    RC setArgs(IVector const *const &args) override {
+        RC err = checkPoint(args, args_dim, logger);
+        if (err != RC::SUCCESS)
+            return err;
+        if (!args_domain->isInside(args)) {
+            SendWarning(logger, ILogger::Module::PROBLEM, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+        std::memcpy(args_data, args->getData(), args_dim * sizeof(double));
+        args_set = true;
+        return RC::SUCCESS;
+    }
+
+    size_t getArgsDim() const override { return args_dim; }
+    size_t getParamsDim() const override { return params_dim; }
+
+    double evalByArgs(IVector const *const &args) const override {
+        if (checkEval(true, args, logger) != RC::SUCCESS)
+            return NOT_NUMBER;
+        return kernel.eval(args->getData(), args_dim, params_data, params_dim, kernel.context);
+    }
+    double evalByParams(IVector const *const &params) const override {
+        if (checkEval(false, params, logger) != RC::SUCCESS)
+            return NOT_NUMBER;
+        return kernel.eval(args_data, args_dim, params->getData(), params_dim, kernel.context);
+    }
+
+    RC evalByArgsBatch(double const *const &rows, size_t n, double *const &out) const override {
+        RC err = checkBatch(true, rows, n, out);
+        if (err != RC::SUCCESS || n == 0)
+            return err;
+        forTiles(n, [&](size_t begin, size_t count) {
+            double const *tile = rows + begin * args_dim;
+            if (kernel.evalBatch != nullptr) {
+                kernel.evalBatch(tile, count, args_dim, params_data, params_dim, out + begin, kernel.context);
+                return;
+            }
+            for (size_t row = 0; row < count; ++row)
+                out[begin + row] =
+                    kernel.eval(tile + row * args_dim, args_dim, params_data, params_dim, kernel.context);
+        });
+        return RC::SUCCESS;
+    }
+    RC evalByParamsBatch(double const *const &rows, size_t n, double *const &out) const override {
+        RC err = checkBatch(false, rows, n, out);
+        if (err != RC::SUCCESS || n == 0)
+            return err;
+        forTiles(n, [&](size_t begin, size_t count) {
+            double const *tile = rows + begin * params_dim;
+            for (size_t row = 0; row < count; ++row)
+                out[begin + row] =
+                    kernel.eval(args_data, args_dim, tile + row * params_dim, params_dim, kernel.context);
+        });
+        return RC::SUCCESS;
+    }
+
+    RC setThreads(size_t threads) override {
+        this->threads = threads;
+        return RC::SUCCESS;
+    }
+
+    double evalDerivativeByArgs(IVector const *const &args, IMultiIndex const *const &index) const override {
+        if (checkEval(true, args, diff_logger) != RC::SUCCESS || checkOrders(index, args_dim) != RC::SUCCESS)
+            return NOT_NUMBER;
+        return derivative(true, args->getData(), index->getData());
+    }
+    double evalDerivativeByParams(IVector const *const &params, IMultiIndex const *const &index) const override {
+        if (checkEval(false, params, diff_logger) != RC::SUCCESS || checkOrders(index, params_dim) != RC::SUCCESS)
+            return NOT_NUMBER;
+        return derivative(false, params->getData(), index->getData());
+    }
+
+    RC evalGradientByArgs(IVector const *const &args, IVector *const &val) const override {
+        return evalGradient(true, args, val);
+    }
+    RC evalGradientByParams(IVector const *const &params, IVector *const &val) const override {
+        return evalGradient(false, params, val);
+    }
+
+    ~ProblemImpl() override {
+        delete[] args_data;
+        delete[] params_data;
+        delete args_domain;
+        delete params_domain;
+    }
+
+  private:
+    static std::atomic<ILogger *> logger;
+    static std::atomic<ILogger *> diff_logger;
+
+    ICompact *params_domain; // nullptr if function has no params
+    ICompact *args_domain;
+    Kernel kernel;
+    size_t params_dim, args_dim;
+    // Values fixed by setParams() and setArgs()
+    double *params_data, *args_data;
+    bool params_set, args_set;
+    size_t threads;
+
+    ProblemImpl(ICompact *params_domain, ICompact *args_domain, Kernel const &kernel)
+        : params_domain(params_domain), args_domain(args_domain), kernel(kernel),
+          params_dim(params_domain == nullptr ? 0 : params_domain->getDim()), args_dim(args_domain->getDim()),
+          params_data(new (std::nothrow) double[params_dim + 1]), args_data(new (std::nothrow) double[args_dim]),
+          params_set(params_domain == nullptr), args_set(false), threads(0) {}
+
+    static RC checkPoint(IVector const *point, size_t dim, ILogger *log) {
+        if (point == nullptr) {
+            SendSevere(log, ILogger::Module::PROBLEM, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (point->getDim() != dim) {
+            SendSevere(log, ILogger::Module::PROBLEM, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        return RC::SUCCESS;
+    }
+
+    // Point must match side being varied, the other side must be set
+    RC checkEval(bool by_args, IVector const *point, ILogger *log) const {
+        RC err = checkPoint(point, by_args ? args_dim : (params_domain == nullptr ? 0 : params_dim), log);
+        if (err != RC::SUCCESS)
+            return err;
+        if (by_args ? !params_set : !args_set) {
+            err = by_args ? RC::NO_PARAMS_SET : RC::NO_ARGS_SET;
+            SendSevere(log, ILogger::Module::PROBLEM, err);
+        }
+        return err;
+    }
+
+    RC checkBatch(bool by_args, double const *rows, size_t n, double *out) const {
+        if (n > 0 && (rows == nullptr || out == nullptr)) {
+            SendSevere(logger, ILogger::Module::PROBLEM, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (!by_args && params_domain == nullptr) {
+            SendSevere(logger, ILogger::Module::PROBLEM, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        if (by_args ? !params_set : !args_set) {
+            RC err = by_args ? RC::NO_PARAMS_SET : RC::NO_ARGS_SET;
+            SendSevere(logger, ILogger::Module::PROBLEM, err);
+            return err;
+        }
+        return RC::SUCCESS;
+    }
+
+    RC checkOrders(IMultiIndex const *index, size_t dim) const {
+        if (index == nullptr) {
+            SendSevere(diff_logger, ILogger::Module::PROBLEM, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (index->getDim() != dim) {
+            SendSevere(diff_logger, ILogger::Module::PROBLEM, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        return RC::SUCCESS;
+    }
+
+    // Calls fn(begin, count) for tiles of rows, large batches are split between threads
+    template <class Fn>
+    void forTiles(size_t n, Fn fn) const {
+        const size_t tiles = (n + TILE_ROWS - 1) / TILE_ROWS;
+        const size_t workers = n < PARALLEL_MIN_ROWS ? 1 : threads;
+        WorkStealingPool::run(tiles, workers, [&](size_t tile, size_t) {
+            size_t begin = tile * TILE_ROWS;
+            fn(begin, std::min(TILE_ROWS, n - begin));
+        });
+    }
+
+    // Value of function, where point replaces args (by_args) or params
+    double evalAt(bool by_args, double const *point) const {
+        return by_args ? kernel.eval(point, args_dim, params_data, params_dim, kernel.context)
+                       : kernel.eval(args_data, args_dim, point, params_dim, kernel.context);
+    }
+
+    // Step of central difference of total order along axis with coordinate x, balances truncation and rounding errors
+    static double step(double x, size_t order) {
+        return std::pow(DBL_EPSILON, 1.0 / (double)(order + 2)) * std::max(1.0, std::fabs(x));
+    }
+
+    // Writes gradient to grad, shifted is scratch of dim doubles
+    void gradient(bool by_args, double const *point, double *shifted, double *grad) const {
+        GradientFunction exact = by_args ? kernel.gradientByArgs : kernel.gradientByParams;
+        if (exact != nullptr) {
+            if (by_args)
+                exact(point, args_dim, params_data, params_dim, grad, kernel.context);
+            else
+                exact(args_data, args_dim, point, params_dim, grad, kernel.context);
+            return;
+        }
+        const size_t dim = by_args ? args_dim : params_dim;
+        std::copy(point, point + dim, shifted);
+        for (size_t axis = 0; axis < dim; ++axis) {
+            const double h = step(point[axis], 1);
+            const double up = point[axis] + h, down = point[axis] - h;
+            shifted[axis] = up;
+            const double f_up = evalAt(by_args, shifted);
+            shifted[axis] = down;
+            const double f_down = evalAt(by_args, shifted);
+            shifted[axis] = point[axis];
+            grad[axis] = (f_up - f_down) / (up - down);
+        }
+    }
+
+    RC evalGradient(bool by_args, IVector const *point, IVector *val) const {
+        RC err = checkEval(by_args, point, diff_logger);
+        if (err != RC::SUCCESS)
+            return err;
+        const size_t dim = by_args ? args_dim : params_dim;
+        if (val == nullptr) {
+            SendSevere(diff_logger, ILogger::Module::PROBLEM, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (val->getDim() != dim) {
+            SendSevere(diff_logger, ILogger::Module::PROBLEM, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        double *buffer = scratch<double>(2 * dim);
+        gradient(by_args, point->getData(), buffer, buffer + dim);
+        return val->setData(dim, buffer + dim);
+    }
+
+    double derivative(bool by_args, double const *point, size_t const *orders) const {
+        const size_t dim = by_args ? args_dim : params_dim;
+        size_t total = 0;
+        for (size_t axis = 0; axis < dim; ++axis)
+            total += orders[axis];
+        if (total == 0)
+            return evalAt(by_args, point);
+
+        DerivativeFunction exact = by_args ? kernel.derivativeByArgs : kernel.derivativeByParams;
+        if (exact != nullptr)
+            return by_args ? exact(point, args_dim, params_data, params_dim, orders, kernel.context)
+                           : exact(args_data, args_dim, point, params_dim, orders, kernel.context);
+        if (total == 1 && (by_args ? kernel.gradientByArgs : kernel.gradientByParams) != nullptr) {
+            double *buffer = scratch<double>(2 * dim);
+            gradient(by_args, point, buffer, buffer + dim);
+            return buffer[dim + (size_t)(std::find(orders, orders + dim, (size_t)1) - orders)];
+        }
+        if (total > MAX_DIFFERENCE_ORDER) {
+            SendSevere(diff_logger, ILogger::Module::PROBLEM, RC::INVALID_ARGUMENT);
+            return NOT_NUMBER;
+        }
+
+        /*
+         * Tensor product of central differences: sum over offsets 0 <= shift[i] <= orders[i] of
+         * prod((-1)^shift[i] * C(orders[i], shift[i])) * f(x + (orders[i] / 2 - shift[i]) * h[i]), divided by
+         * prod(h[i]^orders[i])
+         */
+        double *buffer = scratch<double>(2 * dim);
+        double *shifted = buffer, *steps = buffer + dim;
+        size_t *shift = scratch<size_t>(dim);
+        double scale = 1;
+        for (size_t axis = 0; axis < dim; ++axis) {
+            steps[axis] = step(point[axis], total);
+            shift[axis] = 0;
+            for (size_t power = 0; power < orders[axis]; ++power)
+                scale *= steps[axis];
+        }
+        double sum = 0;
+        while (true) {
+            double weight = 1;
+            for (size_t axis = 0; axis < dim; ++axis) {
+                shifted[axis] = point[axis] + (0.5 * (double)orders[axis] - (double)shift[axis]) * steps[axis];
+                weight *= (shift[axis] % 2 == 0 ? 1.0 : -1.0) * (double)binomial(orders[axis], shift[axis]);
+            }
+            sum += weight * evalAt(by_args, shifted);
+
+            size_t axis = 0;
+            while (axis < dim && shift[axis] == orders[axis])
+                shift[axis++] = 0;
+            if (axis == dim)
+                break;
+            ++shift[axis];
+        }
+        return sum / scale;
+    }
+};
+
+std::atomic<ILogger *> ProblemImpl::logger(nullptr);
+std::atomic<ILogger *> ProblemImpl::diff_logger(nullptr);
+}; // namespace
+
+RC IProblem::setLogger(ILogger *const logger) { return ProblemImpl::setLogger(logger, false); }
+ILogger *IProblem::getLogger() { return ProblemImpl::getLogger(false); }
+IProblem *IProblem::createProblem(ICompact const *const &params, ICompact const *const &args, Kernel const &kernel) {
+    return ProblemImpl::createProblem(params, args, kernel);
+}
+IProblem::~IProblem() = default;
+
+RC IDiffProblem::setLogger(ILogger *const logger) { return ProblemImpl::setLogger(logger, true); }
+ILogger *IDiffProblem::getLogger() { return ProblemImpl::getLogger(true); }
+IDiffProblem *IDiffProblem::createDiffProblem(ICompact const *const &params, ICompact const *const &args,
+                                              Kernel const &kernel) {
+    return ProblemImpl::createProblem(params, args, kernel);
+}
+IDiffProblem::~IDiffProblem() = default;
@@ -0,0 +1,165 @@
+#include "ILogger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Quantity of call sites tracked by decorator, power of two
+const size_t SITES = 1024;
+// Quantity of slots checked for call site before it's considered untracked
+const size_t MAX_PROBES = 16;
+
+enum SiteState { EMPTY, CLAIMED, READY };
+
+/*
+ * Counters of one call site, key fields are written once by thread, which claimed the slot, and are read only after
+ * state becomes READY
+ */
+struct Site {
+    std::atomic<int> state;
+    RC code;
+    ILogger::Level level;
+    int line;
+    const char *srcfile;
+    const char *function;
+    std::atomic<int64_t> next_time; // nanoseconds since creation of decorator, when next record may be passed
+    std::atomic<size_t> pending;    // records counted since the last passed one
+};
+
+class RateLimitedLoggerImpl : public ILogger {
+  public:
+    static ILogger *createLogger(ILogger *const &logger, double interval) {
+        // Interval is kept in nanoseconds
+        if (logger == nullptr || !(interval >= 0) || interval > (double)INT64_MAX / 1e9)
+            return nullptr;
+        Site *sites = new (std::nothrow) Site[SITES];
+        if (sites == nullptr)
+            return nullptr;
+        RateLimitedLoggerImpl *limited = new (std::nothrow) RateLimitedLoggerImpl(logger, interval, sites);
+        if (limited == nullptr)
+            delete[] sites;
+        return limited;
+    }
+
+    RC log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) override {
+        return logRepeated(code, level, srcfile, function, line, 1);
+    }
+    RC log(RC code, Level level) override { return logger->log(code, level); }
+
+    RC logRepeated(RC code, Level level, const char *const &srcfile, const char *const &function, int line,
+                   size_t count) override {
+        if (srcfile == nullptr || function == nullptr)
+            return logger->log(code, level, srcfile, function, line);
+        Site *site = find(code, level, srcfile, function, line);
+        if (site == nullptr)
+            return count == 1 ? logger->log(code, level, srcfile, function, line)
+                              : logger->logRepeated(code, level, srcfile, function, line, count);
+
+        // Only the thread, which moves next_time forward, passes record, the others count theirs into pending
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        RC result = RC::SUCCESS;
+        if (!claim(*site, now))
+            site->pending.fetch_add(count, std::memory_order_relaxed);
+        else
+            result = pass(*site, count + site->pending.exchange(0, std::memory_order_relaxed));
+
+        // Call sites, which went silent after a burst, are summarized by records of the others once per interval
+        int64_t sweep = next_sweep.load(std::memory_order_relaxed);
+        if (now >= sweep && next_sweep.compare_exchange_strong(sweep, now + interval, std::memory_order_relaxed)) {
+            for (size_t idx = 0; idx < SITES; ++idx) {
+                Site &other = sites[idx];
+                if (&other == site || other.state.load(std::memory_order_acquire) != READY ||
+                    other.pending.load(std::memory_order_relaxed) == 0 || !claim(other, now))
+                    continue;
+                size_t pending = other.pending.exchange(0, std::memory_order_relaxed);
+                if (pending > 0 && pass(other, pending) != RC::SUCCESS)
+                    result = RC::IO_ERROR;
+            }
+        }
+        return result;
+    }
+
+    RC flush() override {
+        RC result = RC::SUCCESS;
+        for (size_t idx = 0; idx < SITES; ++idx) {
+            if (sites[idx].state.load(std::memory_order_acquire) != READY)
+                continue;
+            size_t count = sites[idx].pending.exchange(0, std::memory_order_relaxed);
+            if (count > 0 && pass(sites[idx], count) != RC::SUCCESS)
+                result = RC::IO_ERROR;
+        }
+        RC err = logger->flush();
+        return result == RC::SUCCESS ? err : result;
+    }
+
+    ~RateLimitedLoggerImpl() {
+        flush();
+        delete[] sites;
+    }
+
+  private:
+    ILogger *logger;
+    int64_t interval; // nanoseconds
+    Site *sites;
+    Clock::time_point start;
+    std::atomic<int64_t> next_sweep; // nanoseconds since creation, when pending counts of all sites are checked
+
+    RateLimitedLoggerImpl(ILogger *logger, double interval, Site *sites)
+        : logger(logger), interval((int64_t)(interval * 1e9)), sites(sites), start(Clock::now()),
+          next_sweep(this->interval) {
+        for (size_t idx = 0; idx < SITES; ++idx) {
+            sites[idx].state.store(EMPTY, std::memory_order_relaxed);
+            sites[idx].next_time.store(0, std::memory_order_relaxed);
+            sites[idx].pending.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // True if record of site may be passed at now, then the next one may be passed after interval
+    bool claim(Site &site, int64_t now) {
+        int64_t next = site.next_time.load(std::memory_order_relaxed);
+        return now >= next && site.next_time.compare_exchange_strong(next, now + interval, std::memory_order_relaxed);
+    }
+
+    RC pass(const Site &site, size_t count) {
+        if (count == 1)
+            return logger->log(site.code, site.level, site.srcfile, site.function, site.line);
+        return logger->logRepeated(site.code, site.level, site.srcfile, site.function, site.line, count);
+    }
+
+    // Finds counters of call site with linear probing, claims empty slot for new one
+    Site *find(RC code, Level level, const char *srcfile, const char *function, int line) {
+        uint64_t hash = (uint64_t)(uintptr_t)srcfile * 0x9E3779B97F4A7C15ull;
+        hash ^= ((uint64_t)line << 16 | (uint64_t)code << 4 | (uint64_t)level) * 0xC2B2AE3D27D4EB4Full;
+        hash ^= hash >> 29;
+        for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+            Site &site = sites[(hash + probe) & (SITES - 1)];
+            int state = site.state.load(std::memory_order_acquire);
+            if (state == EMPTY && site.state.compare_exchange_strong(state, CLAIMED, std::memory_order_acquire)) {
+                site.code = code;
+                site.level = level;
+                site.line = line;
+                site.srcfile = srcfile;
+                site.function = function;
+                site.state.store(READY, std::memory_order_release);
+                return &site;
+            }
+            // Slot is being claimed by another thread, key is written in a few instructions
+            while (state == CLAIMED) {
+                std::this_thread::yield();
+                state = site.state.load(std::memory_order_acquire);
+            }
+            if (site.line == line && site.srcfile == srcfile && site.code == code && site.level == level)
+                return &site;
+        }
+        return nullptr;
+    }
+};
+}; // namespace
+
+ILogger *ILogger::createRateLimitedLogger(ILogger *const &logger, double interval) {
+    return RateLimitedLoggerImpl::createLogger(logger, interval);
+}
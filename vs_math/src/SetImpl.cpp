@@ -4,8 +4,8 @@
 #include <map>
 #include <vector>
 
-ILogger *SetImpl::logger = nullptr;
-ILogger *SetImpl::IteratorImpl::logger = nullptr;
+std::atomic<ILogger *> SetImpl::logger(nullptr);
+std::atomic<ILogger *> SetImpl::IteratorImpl::logger(nullptr);
 
 RC SetImpl::setLogger(ILogger *const pLogger) {
     if (pLogger == nullptr)
@@ -26,11 +26,11 @@ size_t SetImpl::getSize() const { return size; }
 
 RC SetImpl::getCopy(size_t index, IVector *&val) const {
     if (size == 0) {
-        logger->warning(RC::SOURCE_SET_EMPTY, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::SOURCE_SET_EMPTY);
         return RC::SOURCE_SET_EMPTY;
     }
     if (index > size - 1) {
-        logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
 
@@ -44,27 +44,29 @@ RC SetImpl::getCopy(size_t index, IVector *&val) const {
 }
 RC SetImpl::findFirst(IVector const *const &pat, IVector::NORM n, double tol) const {
     if (pat == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     if (pat->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (n == IVector::NORM::AMOUNT || tol < 0) {
-        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INVALID_ARGUMENT);
         return RC::INVALID_ARGUMENT;
     }
     if (std::isnan(tol)) {
-        logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NOT_NUMBER);
         return RC::NOT_NUMBER;
     }
     if (std::isinf(tol)) {
-        logger->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INFINITY_OVERFLOW);
         return RC::INFINITY_OVERFLOW;
     }
 
+    STATS_COUNT(SET_SCANS);
     for (size_t vec_idx = 0; vec_idx < size; ++vec_idx) {
+        STATS_COUNT(SET_SCANNED_VECTORS);
         bool found = false;
         double *cur_data = new double[dim];
 
@@ -84,27 +86,29 @@ RC SetImpl::findFirst(IVector const *const &pat, IVector::NORM n, double tol) co
 }
 RC SetImpl::findFirstAndCopy(IVector const *const &pat, IVector::NORM n, double tol, IVector *&val) const {
     if (pat == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     if (pat->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (n == IVector::NORM::AMOUNT || tol < 0) {
-        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INVALID_ARGUMENT);
         return RC::INVALID_ARGUMENT;
     }
     if (std::isnan(tol)) {
-        logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NOT_NUMBER);
         return RC::NOT_NUMBER;
     }
     if (std::isinf(tol)) {
-        logger->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INFINITY_OVERFLOW);
         return RC::INFINITY_OVERFLOW;
     }
 
+    STATS_COUNT(SET_SCANS);
     for (size_t vec_idx = 0; vec_idx < size; ++vec_idx) {
+        STATS_COUNT(SET_SCANNED_VECTORS);
         bool found = false;
         double *cur_data = new double[dim];
 
@@ -128,15 +132,15 @@ RC SetImpl::findFirstAndCopy(IVector const *const &pat, IVector::NORM n, double
 
 RC SetImpl::getCoords(size_t index, IVector *const &val) const {
     if (size == 0) {
-        logger->warning(RC::SOURCE_SET_EMPTY, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::SOURCE_SET_EMPTY);
         return RC::SOURCE_SET_EMPTY;
     }
     if (index > size - 1) {
-        logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
     if (val == nullptr) {
-        logger->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
 
@@ -150,27 +154,29 @@ RC SetImpl::getCoords(size_t index, IVector *const &val) const {
 }
 RC SetImpl::findFirstAndCopyCoords(IVector const *const &pat, IVector::NORM n, double tol, IVector *const &val) const {
     if (pat == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     if (pat->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (n == IVector::NORM::AMOUNT || tol < 0) {
-        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INVALID_ARGUMENT);
         return RC::INVALID_ARGUMENT;
     }
     if (std::isnan(tol)) {
-        logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NOT_NUMBER);
         return RC::NOT_NUMBER;
     }
     if (std::isinf(tol)) {
-        logger->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INFINITY_OVERFLOW);
         return RC::INFINITY_OVERFLOW;
     }
 
+    STATS_COUNT(SET_SCANS);
     for (size_t vec_idx = 0; vec_idx < size; ++vec_idx) {
+        STATS_COUNT(SET_SCANNED_VECTORS);
         bool found = false;
         double *cur_data = new double[dim];
 
@@ -193,10 +199,11 @@ RC SetImpl::findFirstAndCopyCoords(IVector const *const &pat, IVector::NORM n, d
 }
 
 RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol) {
+    STATS_TIMER(SET_INSERT);
     if (dim == 0)
         dim = val->getDim();
     else if (dim != val->getDim()) {
-        logger->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (size == 0)
@@ -204,7 +211,9 @@ RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol) {
 
     const double *vec_data = val->getData();
 
+    STATS_COUNT(SET_SCANS);
     for (size_t vec_idx = 0; vec_idx < size; ++vec_idx) {
+        STATS_COUNT(SET_SCANNED_VECTORS);
         double *sub = new double[dim];
         for (size_t idx = 0; idx < dim; ++idx)
             sub[idx] = fabs(vec_data[idx] - data[vec_idx * dim + idx]);
@@ -212,7 +221,7 @@ RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol) {
         if (tmp->norm(n) <= tol) {
             delete[] sub;
             delete tmp;
-            logger->warning(RC::VECTOR_ALREADY_EXIST, __FILE__, __func__, __LINE__);
+            SendWarning(logger, ILogger::Module::SET, RC::VECTOR_ALREADY_EXIST);
             return RC::VECTOR_ALREADY_EXIST;
         }
         delete[] sub;
@@ -241,11 +250,11 @@ RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol) {
 
 RC SetImpl::remove(size_t index) {
     if (size == 0) {
-        logger->warning(RC::SOURCE_SET_EMPTY, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::SOURCE_SET_EMPTY);
         return RC::SOURCE_SET_EMPTY;
     }
     if (index > size - 1) {
-        logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::INDEX_OUT_OF_BOUND);
         return RC::INDEX_OUT_OF_BOUND;
     }
 
@@ -273,27 +282,27 @@ RC SetImpl::remove(size_t index) {
 }
 RC SetImpl::remove(IVector const *const &pat, IVector::NORM n, double tol) {
     if (size == 0) {
-        logger->warning(RC::SOURCE_SET_EMPTY, __FILE__, __func__, __LINE__);
+        SendWarning(logger, ILogger::Module::SET, RC::SOURCE_SET_EMPTY);
         return RC::SOURCE_SET_EMPTY;
     }
     if (pat == nullptr) {
-        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NULLPTR_ERROR);
         return RC::NULLPTR_ERROR;
     }
     if (pat->getDim() != dim) {
-        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
     if (n == IVector::NORM::AMOUNT || tol < 0) {
-        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INVALID_ARGUMENT);
         return RC::INVALID_ARGUMENT;
     }
     if (std::isnan(tol)) {
-        logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::NOT_NUMBER);
         return RC::NOT_NUMBER;
     }
     if (std::isinf(tol)) {
-        logger->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INFINITY_OVERFLOW);
         return RC::INFINITY_OVERFLOW;
     }
 
@@ -302,7 +311,9 @@ RC SetImpl::remove(IVector const *const &pat, IVector::NORM n, double tol) {
     std::map<size_t, size_t> new_unique_idxs_to_order;
     std::map<size_t, size_t> new_order_idxs_to_unique;
 
+    STATS_COUNT(SET_SCANS);
     for (size_t vec_idx = 0, new_idx = 0, new_vec_idx = 0; vec_idx < size; ++vec_idx) {
+        STATS_COUNT(SET_SCANNED_VECTORS);
         double *cur_data = new double[dim];
 
         for (size_t idx = 0; idx < dim; ++idx)
@@ -367,8 +378,9 @@ RC ISet::setLogger(ILogger *const logger) { return SetImpl::setLogger(logger); }
 ILogger *ISet::getLogger() { return SetImpl::getLogger(); }
 ISet *ISet::createSet() { return SetImpl::createSet(); }
 ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol) {
+    STATS_TIMER(SET_MAKE_INTERSECTION);
     if (op1->getDim() != op2->getDim()) {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
 
@@ -386,7 +398,7 @@ ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVe
             delete tmp_vec;
             delete new_set;
             delete set1_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -398,7 +410,7 @@ ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVe
             delete tmp_vec;
             delete new_set;
             delete set1_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -419,7 +431,7 @@ ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVe
             delete tmp_vec;
             delete new_set;
             delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -431,7 +443,7 @@ ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVe
             delete tmp_vec;
             delete new_set;
             delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -444,8 +456,9 @@ ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVe
     return new_set;
 }
 ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol) {
+    STATS_TIMER(SET_MAKE_UNION);
     if (op1->getDim() != op2->getDim()) {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
 
@@ -463,7 +476,7 @@ ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::N
             delete tmp_vec;
             delete new_set;
             delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -474,7 +487,7 @@ ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::N
             delete tmp_vec;
             delete new_set;
             delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            SendSevere(getLogger(), ILogger::Module::SET, err);
             return nullptr;
         }
 
@@ -486,7 +499,7 @@ ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::N
 }
 ISet *ISet::sub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol) {
     if (op1->getDim() != op2->getDim()) {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
 
@@ -503,7 +516,7 @@ ISet *ISet::sub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n,
         if (err != RC::SUCCESS) {
             delete vec1;
             delete set1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
+            SendWarning(getLogger(), ILogger::Module::SET, err);
             return new_set;
         }
 
@@ -512,7 +525,7 @@ ISet *ISet::sub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n,
         if (err == RC::VECTOR_NOT_FOUND) {
             new_set->insert(vec1, n, tol);
         } else if (err != RC::SUCCESS) {
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
+            SendWarning(getLogger(), ILogger::Module::SET, err);
             delete vec1;
             delete set1_iter;
             return new_set;
@@ -534,7 +547,7 @@ ISet *ISet::symSub(ISet const *const &op1, ISet const *const &op2, IVector::NORM
 }
 bool ISet::equals(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol) {
     if (op1->getSize() != op2->getSize()) {
-        getLogger()->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendWarning(getLogger(), ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return false;
     }
 
@@ -542,7 +555,7 @@ bool ISet::equals(ISet const *const &op1, ISet const *const &op2, IVector::NORM
 }
 bool ISet::subSet(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol) {
     if (op1->getDim() != op2->getDim()) {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::SET, RC::MISMATCHING_DIMENSIONS);
         return false;
     }
 
@@ -558,7 +571,7 @@ bool ISet::subSet(ISet const *const &op1, ISet const *const &op2, IVector::NORM
         if (err != RC::SUCCESS) {
             delete vec1;
             delete vec1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
+            SendWarning(getLogger(), ILogger::Module::SET, err);
             return false;
         }
 
@@ -570,7 +583,7 @@ bool ISet::subSet(ISet const *const &op1, ISet const *const &op2, IVector::NORM
         } else if (err != RC::SUCCESS) {
             delete vec1;
             delete vec1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
+            SendWarning(getLogger(), ILogger::Module::SET, err);
             return false;
         }
 
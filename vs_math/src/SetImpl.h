@@ -1,6 +1,7 @@
 #pragma once
 #include "ISet.h"
 #include "SetImplControlBlock.h"
+#include <atomic>
 #include <map>
 
 class SetImpl : public ISet {
@@ -57,7 +58,7 @@ class SetImpl : public ISet {
         size_t cur_unique_idx;
         IVector *cur_vector;
         SetImplControlBlock *control_block;
-        static ILogger *logger;
+        static std::atomic<ILogger *> logger;
         bool valid;
     };
 
@@ -73,7 +74,7 @@ class SetImpl : public ISet {
     RC getLastByUniqueIndex(IVector *const &vec, size_t &index);
 
   private:
-    static ILogger *logger;
+    static std::atomic<ILogger *> logger;
     double *data;
     SetImplControlBlock *control_block;
     std::map<size_t, size_t> unique_idxs_to_order;
@@ -12,7 +12,7 @@ SetImpl::IteratorImpl::IteratorImpl(SetImplControlBlock *const &cb, size_t index
 ISet::IIterator *SetImpl::IteratorImpl::getNext(size_t indexInc) const {
     IIterator *copy = clone();
     if (copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::ALLOCATION_ERROR);
         return nullptr;
     }
     copy->next(indexInc);
@@ -21,7 +21,7 @@ ISet::IIterator *SetImpl::IteratorImpl::getNext(size_t indexInc) const {
 ISet::IIterator *SetImpl::IteratorImpl::getPrevious(size_t indexInc) const {
     IIterator *copy = clone();
     if (copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::ALLOCATION_ERROR);
         return nullptr;
     }
     copy->previous(indexInc);
@@ -60,7 +60,7 @@ RC SetImpl::IteratorImpl::makeEnd() { return control_block->getEnd(cur_vector, c
 RC SetImpl::IteratorImpl::getVectorCopy(IVector *&val) const {
     IVector *copy = cur_vector->clone();
     if (copy == nullptr) {
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::ALLOCATION_ERROR);
         return RC::ALLOCATION_ERROR;
     }
     val = copy;
@@ -75,20 +75,20 @@ ISet::IIterator::~IIterator() = default;
 
 ISet::IIterator *SetImpl::getIterator(size_t index) const {
     if (index > size - 1) {
-        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::INDEX_OUT_OF_BOUND);
         return nullptr;
     }
 
     IVector *vec;
     RC err = getCopy(index, vec);
     if (err != RC::SUCCESS) {
-        logger->severe(err, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, err);
         return nullptr;
     }
     IteratorImpl *iter = new (std::nothrow) IteratorImpl(control_block, order_idxs_to_unique.at(index), vec);
     if (iter == nullptr) {
         delete vec;
-        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(logger, ILogger::Module::SET, RC::ALLOCATION_ERROR);
         return nullptr;
     }
     IteratorImpl::setLogger(logger);
@@ -0,0 +1,850 @@
+#include "BestPoints.h"
+#include "IDiffProblem.h"
+#include "ISolver.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace {
+// Sufficient decrease and curvature constants usual for quasi-Newton methods
+const double ARMIJO_C1 = 1e-4;
+const double WOLFE_C2 = 0.9;
+// Trials of one line search
+const size_t MAX_LINE_SEARCH_STEPS = 40;
+// Buffers of dimension length: x, g, d, trial x and g, s, y, H * y, box bounds and solution
+const size_t BUFFERS = 11;
+// Relative rounding error of values, decrease predicted below it can't be detected
+const double ROUNDING = 16 * std::numeric_limits<double>::epsilon();
+const double INF = std::numeric_limits<double>::infinity();
+const double NOT_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+double dot(double const *a, double const *b, size_t dim) {
+    double sum = 0;
+    for (size_t idx = 0; idx < dim; ++idx)
+        sum += a[idx] * b[idx];
+    return sum;
+}
+
+bool isPrime(size_t number) {
+    for (size_t divisor = 2; divisor * divisor <= number; ++divisor)
+        if (number % divisor == 0)
+            return false;
+    return true;
+}
+
+// Digits of index in base mirrored around the point: index-th element of van der Corput sequence in base
+double radicalInverse(size_t index, size_t base) {
+    double result = 0, scale = 1.0 / (double)base;
+    for (; index > 0; index /= base, scale /= (double)base)
+        result += (double)(index % base) * scale;
+    return result;
+}
+
+double maxAbs(double const *a, size_t dim) {
+    double result = 0;
+    for (size_t idx = 0; idx < dim; ++idx)
+        result = std::max(result, std::fabs(a[idx]));
+    return result;
+}
+
+class SolverImpl : public ISolver {
+  public:
+    static RC setLogger(ILogger *const pLogger) {
+        if (pLogger == nullptr)
+            return RC::NULLPTR_ERROR;
+        logger = pLogger;
+        return RC::SUCCESS;
+    }
+    static ILogger *getLogger() { return logger; }
+
+    static SolverImpl *createSolver(Options const &options) {
+        if (options.maxIterations == 0 || !(options.gradientTolerance >= 0) || !(options.valueTolerance >= 0) ||
+            (options.method == Method::LBFGS && options.history == 0) ||
+            (options.seeds == Seeds::HALTON && options.seedsCount == 0) || !(options.optimaTolerance >= 0) ||
+            options.optimaCount == 0) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+            return nullptr;
+        }
+        SolverImpl *solver = new (std::nothrow) SolverImpl(options);
+        if (solver == nullptr)
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+        return solver;
+    }
+
+    SolverImpl *clone() const override {
+        SolverImpl *copy = createSolver(options);
+        if (copy == nullptr)
+            return nullptr;
+        if ((problem != nullptr && copy->setProblem(problem) != RC::SUCCESS) ||
+            (args.domain != nullptr && copy->setArgsDomain(args.domain) != RC::SUCCESS) ||
+            (params.domain != nullptr && copy->setParamsDomain(params.domain) != RC::SUCCESS)) {
+            delete copy;
+            return nullptr;
+        }
+        if (solution_dim > 0)
+            std::copy(solution(), solution() + solution_dim, copy->solution());
+        copy->solution_dim = solution_dim;
+        copy->summary = summary;
+        if (optima != nullptr && (copy->optima = optima->clone()) == nullptr) {
+            delete copy;
+            return nullptr;
+        }
+        return copy;
+    }
+
+    RC setProblem(IProblem const *const &pProblem) override {
+        if (pProblem == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        IDiffProblem const *diff = dynamic_cast<IDiffProblem const *>(pProblem);
+        if (diff == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+
+        IDiffProblem *copy = diff->clone();
+        const size_t args_dim = diff->getArgsDim(), params_dim = diff->getParamsDim();
+        const size_t dim = std::max(args_dim, params_dim);
+        const size_t history = options.method == Method::LBFGS ? options.history : 0;
+        const size_t size = BUFFERS * dim + (options.method == Method::BFGS ? dim * dim : 0) + history * (2 * dim + 2);
+        double *memory = new (std::nothrow) double[size]();
+        Side args_side = {nullptr, nullptr, nullptr}, params_side = {nullptr, nullptr, nullptr};
+        if (copy == nullptr || memory == nullptr || !args_side.create(args_dim, memory) ||
+            (params_dim > 0 && !params_side.create(params_dim, memory))) {
+            args_side.clear();
+            params_side.clear();
+            delete[] memory;
+            delete copy;
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+
+        delete problem;
+        delete[] workspace;
+        problem = copy;
+        workspace = memory;
+        workspace_dim = dim;
+        args_side.domain = args.domain;
+        params_side.domain = params.domain;
+        args.clear();
+        params.clear();
+        args = args_side;
+        params = params_side;
+        if (args.domain != nullptr && args.domain->getDim() != args_dim) {
+            delete args.domain;
+            args.domain = nullptr;
+        }
+        if (params.domain != nullptr && params.domain->getDim() != params_dim) {
+            delete params.domain;
+            params.domain = nullptr;
+        }
+        solution_dim = 0;
+        delete optima;
+        optima = nullptr;
+        return RC::SUCCESS;
+    }
+
+    bool isValidArgsDomain(ICompact const *const &domain) const override {
+        return domain != nullptr && (problem == nullptr || domain->getDim() == problem->getArgsDim());
+    }
+    bool isValidParamsDomain(ICompact const *const &domain) const override {
+        return domain != nullptr && (problem == nullptr || domain->getDim() == problem->getParamsDim());
+    }
+    RC setArgsDomain(ICompact const *const &domain) override {
+        return setDomain(args, domain, isValidArgsDomain(domain));
+    }
+    RC setParamsDomain(ICompact const *const &domain) override {
+        return setDomain(params, domain, isValidParamsDomain(domain));
+    }
+
+    RC solveByArgs(IVector const *const &initArg, IVector *const *const &solverParams) override {
+        return solve(true, initArg, solverParams);
+    }
+    RC solveByParams(IVector const *const &initParam, IVector *const *const &solverParams) override {
+        return solve(false, initParam, solverParams);
+    }
+
+    RC getSolution(IVector *&solution) const override {
+        if (solution_dim == 0) {
+            SendWarning(logger, ILogger::Module::SOLVER, RC::NO_ARGS_SET);
+            return RC::NO_ARGS_SET;
+        }
+        solution = IVector::createVector(solution_dim, this->solution());
+        if (solution == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        return RC::SUCCESS;
+    }
+    RC getOptima(ISet *&result) const override {
+        if (solution_dim == 0) {
+            SendWarning(logger, ILogger::Module::SOLVER, RC::NO_ARGS_SET);
+            return RC::NO_ARGS_SET;
+        }
+        if (optima != nullptr) {
+            result = optima->clone();
+        } else {
+            result = ISet::createSet();
+            IVector *point = IVector::createVector(solution_dim, solution());
+            if (result != nullptr && (point == nullptr || result->insert(point, IVector::NORM::CHEBYSHEV, 0) !=
+                                                              RC::SUCCESS)) {
+                delete result;
+                result = nullptr;
+            }
+            delete point;
+        }
+        if (result == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        return RC::SUCCESS;
+    }
+    Summary getSummary() const override { return summary; }
+
+    ~SolverImpl() override {
+        args.clear();
+        params.clear();
+        delete args.domain;
+        delete params.domain;
+        delete optima;
+        delete problem;
+        delete[] workspace;
+    }
+
+  private:
+    static std::atomic<ILogger *> logger;
+
+    // Clone of solver, starting point and results of one worker of global mode
+    struct Start {
+        SolverImpl *solver;
+        std::vector<double> point;
+        BestPoints optima, any;
+        Summary total;
+
+        Start() : solver(nullptr), total() {}
+    };
+
+    // Domain and vectors passing points to problem, for args or params
+    struct Side {
+        ICompact *domain;
+        IVector *point, *gradient;
+
+        bool create(size_t dim, double const *zeros) {
+            point = IVector::createVector(dim, zeros);
+            gradient = IVector::createVector(dim, zeros);
+            return point != nullptr && gradient != nullptr;
+        }
+        void clear() {
+            delete point;
+            delete gradient;
+            point = gradient = nullptr;
+        }
+    };
+
+    Options options;
+    IDiffProblem *problem;
+    Side args, params;
+    // BUFFERS vectors of workspace_dim, then BFGS matrix or L-BFGS history
+    double *workspace;
+    size_t workspace_dim;
+    // 0 until the first successful solve
+    size_t solution_dim;
+    Summary summary;
+    // Distinct optima of the last global solve, nullptr after local one
+    ISet *optima;
+
+    // Current solve: side being varied and its dimension
+    bool by_args;
+    size_t dim;
+    // Buffers of workspace
+    double *x, *g, *d, *x_trial, *g_trial, *s, *y, *hy, *lower, *upper;
+    // L-BFGS ring of pairs: the oldest is at start
+    size_t pairs, start;
+    // BFGS matrix was scaled by the first pair
+    bool scaled;
+    // Line search reached steps, which decrease value less than its rounding error
+    bool stalled;
+
+    explicit SolverImpl(Options const &options)
+        : options(options), problem(nullptr), workspace(nullptr), workspace_dim(0), solution_dim(0),
+          summary(), optima(nullptr), by_args(true), dim(0) {
+        args.domain = params.domain = nullptr;
+        args.point = args.gradient = params.point = params.gradient = nullptr;
+    }
+
+    double *solution() const { return workspace + 10 * workspace_dim; }
+    double *matrix() const { return workspace + BUFFERS * workspace_dim; }
+    double *historyS(size_t pair) const { return matrix() + ((start + pair) % options.history) * workspace_dim; }
+    double *historyY(size_t pair) const {
+        return matrix() + (options.history + (start + pair) % options.history) * workspace_dim;
+    }
+    double *historyRho() const { return matrix() + 2 * options.history * workspace_dim; }
+    double *historyAlpha() const { return historyRho() + options.history; }
+
+    RC setDomain(Side &side, ICompact const *domain, bool valid) {
+        if (domain == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        if (!valid) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        ICompact *copy = domain->clone();
+        if (copy == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        delete side.domain;
+        side.domain = copy;
+        return RC::SUCCESS;
+    }
+
+    RC solve(bool by_args, IVector const *init, IVector *const *solverParams) {
+        if (problem == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::NO_PROBLEM_SET);
+            return RC::NO_PROBLEM_SET;
+        }
+        const bool global = options.seeds != Seeds::NONE;
+        if (init == nullptr && !global) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::NULLPTR_ERROR);
+            return RC::NULLPTR_ERROR;
+        }
+        const size_t dim = by_args ? problem->getArgsDim() : problem->getParamsDim();
+        if (dim == 0 || (init != nullptr && init->getDim() != dim)) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::MISMATCHING_DIMENSIONS);
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        size_t max_iterations = options.maxIterations;
+        double tolerance = options.gradientTolerance;
+        if (solverParams != nullptr && solverParams[0] != nullptr) {
+            const size_t count = solverParams[0]->getDim();
+            double const *data = solverParams[0]->getData();
+            if (!(data[0] >= 1) || (count > 1 && !(data[1] >= 0))) {
+                SendSevere(logger, ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+                return RC::INVALID_ARGUMENT;
+            }
+            max_iterations = (size_t)data[0];
+            if (count > 1)
+                tolerance = data[1];
+        }
+
+        solution_dim = 0;
+        delete optima;
+        optima = nullptr;
+        RC err = global ? solveGlobal(by_args, init, max_iterations, tolerance)
+                        : solveLocal(by_args, init->getData(), max_iterations, tolerance);
+        if (err == RC::SUCCESS)
+            solution_dim = dim;
+        return err;
+    }
+
+    // Single local solve from init, writes solution() and summary
+    RC solveLocal(bool by_args, double const *init, size_t max_iterations, double tolerance) {
+        this->by_args = by_args;
+        dim = by_args ? problem->getArgsDim() : problem->getParamsDim();
+        double *buffer = workspace;
+        double **buffers[] = {&x, &g, &d, &x_trial, &g_trial, &s, &y, &hy, &lower, &upper};
+        for (size_t idx = 0; idx < sizeof(buffers) / sizeof(buffers[0]); ++idx, buffer += workspace_dim)
+            *buffers[idx] = buffer;
+        ICompact const *domain = (by_args ? args : params).domain;
+        for (size_t axis = 0; axis < dim; ++axis) {
+            lower[axis] = domain == nullptr ? -INF : domain->getLeftBoundaryData()[axis];
+            upper[axis] = domain == nullptr ? INF : domain->getRightBoundaryData()[axis];
+        }
+        std::copy(init, init + dim, x);
+        project(x);
+
+        Summary result = {1, 0, 0, 0, NOT_NUMBER, false};
+        summary = result;
+        RC err = minimize(max_iterations, tolerance);
+        if (err == RC::SUCCESS)
+            std::copy(x, x + dim, solution());
+        return err;
+    }
+
+    /*
+     * Local solves from every seed by workers with own clones of solver, every worker keeps the best of its converged
+     * solutions and the best solution at all. The first seed goes before the others (see WorkStealingPool.h), other
+     * failed seeds are skipped
+     */
+    RC solveGlobal(bool by_args, IVector const *init, size_t max_iterations, double tolerance) {
+        ICompact const *domain = (by_args ? args : params).domain;
+        if (domain == nullptr) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::INVALID_ARGUMENT);
+            return RC::INVALID_ARGUMENT;
+        }
+        const size_t dim = domain->getDim();
+        const size_t generated = options.seeds == Seeds::GRID ? domain->getNodesCount() : options.seedsCount;
+        const size_t seeds = generated + (init == nullptr ? 0 : 1);
+        const size_t threads =
+            std::min(options.threads == 0 ? WorkStealingPool::defaultThreads() : options.threads, seeds);
+
+        // Order of axes for grid nodes, bases of Halton sequence along axes, distances of the same optimum
+        std::vector<size_t> axes;
+        std::vector<double> same;
+        std::vector<Start> workers;
+        try {
+            axes.resize(dim);
+            same.assign(dim, options.optimaTolerance);
+            workers.resize(threads);
+            for (size_t worker = 0; worker < threads; ++worker) {
+                workers[worker].point.resize(dim);
+                workers[worker].optima.reset(options.optimaCount, dim);
+                workers[worker].any.reset(1, dim);
+            }
+        } catch (std::bad_alloc const &) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::ALLOCATION_ERROR);
+            return RC::ALLOCATION_ERROR;
+        }
+        for (size_t axis = 0, prime = 2; axis < dim; ++axis, ++prime) {
+            axes[axis] = axis;
+            if (options.seeds == Seeds::HALTON) {
+                while (!isPrime(prime))
+                    ++prime;
+                axes[axis] = prime;
+            }
+        }
+        IMultiIndex *bypass = IMultiIndex::createMultiIndex(dim, axes.data());
+        Options local_options = options;
+        local_options.seeds = Seeds::NONE;
+        bool created = bypass != nullptr;
+        for (size_t worker = 0; worker < threads && created; ++worker) {
+            SolverImpl *local = workers[worker].solver = createSolver(local_options);
+            created = local != nullptr && local->setProblem(problem) == RC::SUCCESS &&
+                      (by_args ? local->setArgsDomain(domain) : local->setParamsDomain(domain)) == RC::SUCCESS;
+        }
+
+        auto solveSeed = [&](size_t seed, size_t worker_idx) -> RC {
+            Start &worker = workers[worker_idx];
+            double *start = worker.point.data();
+            RC err = RC::SUCCESS;
+            if (seed == generated)
+                std::copy(init->getData(), init->getData() + dim, start);
+            else if (options.seeds == Seeds::GRID)
+                err = domain->getNode(seed, bypass, start);
+            else
+                for (size_t axis = 0; axis < dim; ++axis)
+                    start[axis] = domain->getLeftBoundaryData()[axis] +
+                                  (domain->getRightBoundaryData()[axis] - domain->getLeftBoundaryData()[axis]) *
+                                      radicalInverse(seed + 1, axes[axis]);
+            if (err == RC::SUCCESS)
+                err = worker.solver->solveLocal(by_args, start, max_iterations, tolerance);
+            if (err != RC::SUCCESS)
+                return err;
+            Summary const &local = worker.solver->summary;
+            if (local.converged)
+                worker.optima.push(local.value, worker.solver->solution(), 0, seed, same.data());
+            worker.any.push(local.value, worker.solver->solution(), 0, seed, same.data());
+            worker.total.starts += 1;
+            worker.total.iterations += local.iterations;
+            worker.total.evaluations += local.evaluations;
+            worker.total.gradients += local.gradients;
+            return RC::SUCCESS;
+        };
+
+        RC err = RC::ALLOCATION_ERROR;
+        if (created)
+            err = solveSeed(0, 0);
+        else
+            SendSevere(logger, ILogger::Module::SOLVER, err);
+        if (err == RC::SUCCESS)
+            WorkStealingPool::run(seeds - 1, threads, [&](size_t task, size_t worker) { solveSeed(task + 1, worker); });
+        for (size_t worker = 0; worker < threads; ++worker)
+            delete workers[worker].solver;
+        delete bypass;
+        if (err != RC::SUCCESS)
+            return err;
+
+        Summary result = {0, 0, 0, 0, NOT_NUMBER, false};
+        for (size_t worker = 0; worker < threads; ++worker) {
+            result.starts += workers[worker].total.starts;
+            result.iterations += workers[worker].total.iterations;
+            result.evaluations += workers[worker].total.evaluations;
+            result.gradients += workers[worker].total.gradients;
+        }
+        summary = result;
+        // Results of all workers are merged into the first one
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers[0].optima.merge(workers[worker].optima, same.data());
+            workers[0].any.merge(workers[worker].any, same.data());
+        }
+        return collectOptima(dim, workers[0].optima, workers[0].any);
+    }
+
+    /*
+     * The best converged solution is solution, or the best one at all if none converged, converged ones are optima.
+     * Workers have already merged points closer than optimaTolerance along every axis, but a point may be close to two
+     * kept ones, so set drops such points by the same tolerance in Chebyshev norm. Points go best first, so the best
+     * of close ones is kept
+     */
+    RC collectOptima(size_t dim, BestPoints const &converged, BestPoints const &any) {
+        BestPoints const &best = converged.size > 0 ? converged : any;
+        ISet *set = ISet::createSet();
+        IVector *point = IVector::createVector(dim, best.coords.data());
+        RC err = set == nullptr || point == nullptr ? RC::ALLOCATION_ERROR : RC::SUCCESS;
+        for (size_t idx = 0; idx < converged.size && err == RC::SUCCESS; ++idx) {
+            err = point->setData(dim, converged.coords.data() + idx * dim);
+            if (err == RC::SUCCESS)
+                err = set->insert(point, IVector::NORM::CHEBYSHEV, options.optimaTolerance);
+            if (err == RC::VECTOR_ALREADY_EXIST)
+                err = RC::SUCCESS;
+        }
+        delete point;
+        if (err != RC::SUCCESS) {
+            delete set;
+            SendSevere(logger, ILogger::Module::SOLVER, err);
+            return err;
+        }
+        optima = set;
+        std::copy(best.coords.data(), best.coords.data() + dim, solution());
+        summary.value = best.values[0];
+        summary.converged = converged.size > 0;
+        return RC::SUCCESS;
+    }
+
+    RC minimize(size_t max_iterations, double tolerance) {
+        RC err = gradient(x, g);
+        if (err != RC::SUCCESS)
+            return err;
+        double f = value(x);
+        if (!std::isfinite(f)) {
+            SendSevere(logger, ILogger::Module::SOLVER, RC::NOT_NUMBER);
+            return RC::NOT_NUMBER;
+        }
+        resetMemory();
+        double alpha = 0;
+        while (summary.iterations < max_iterations) {
+            if (projectedGradient() <= tolerance) {
+                summary.converged = true;
+                break;
+            }
+            direction();
+            double slope = dot(g, d, dim);
+            if (!(slope < 0)) {
+                resetMemory();
+                direction();
+                slope = dot(g, d, dim);
+                if (!(slope < 0))
+                    break;
+            }
+
+            // Quasi-Newton step of length 1 is natural once curvature is known, otherwise start from unit move
+            const bool has_memory = pairs > 0 || scaled;
+            double step = 1;
+            if (options.method == Method::GRADIENT_DESCENT && alpha > 0)
+                step = 2 * alpha;
+            else if (!has_memory)
+                step = 1 / std::max(1.0, maxAbs(d, dim));
+            double f_trial = NOT_NUMBER;
+            stalled = false;
+            bool found = options.lineSearch == LineSearch::WOLFE ? wolfe(f, slope, step, alpha, f_trial, err)
+                                                                 : armijo(f, step, alpha, f_trial, err);
+            if (err != RC::SUCCESS)
+                return err;
+            if (!found) {
+                // Stale curvature may give poor direction, retry once with steepest descent
+                if (has_memory) {
+                    resetMemory();
+                    continue;
+                }
+                // Decrease is lost in rounding of value, point is as good as function can tell
+                summary.converged = stalled;
+                break;
+            }
+
+            ++summary.iterations;
+            for (size_t axis = 0; axis < dim; ++axis) {
+                s[axis] = x_trial[axis] - x[axis];
+                y[axis] = g_trial[axis] - g[axis];
+            }
+            updateMemory();
+            const double decrease = f - f_trial;
+            std::swap(x, x_trial);
+            std::swap(g, g_trial);
+            f = f_trial;
+            if (decrease <= options.valueTolerance * std::max(1.0, std::fabs(f))) {
+                summary.converged = true;
+                break;
+            }
+        }
+        summary.converged = summary.converged || projectedGradient() <= tolerance;
+        summary.value = f;
+        return RC::SUCCESS;
+    }
+
+    // Value at point, NaN if point can't be passed to problem
+    double value(double const *point) {
+        Side &side = by_args ? args : params;
+        ++summary.evaluations;
+        if (side.point->setData(dim, point) != RC::SUCCESS)
+            return NOT_NUMBER;
+        return by_args ? problem->evalByArgs(side.point) : problem->evalByParams(side.point);
+    }
+
+    RC gradient(double const *point, double *grad) {
+        Side &side = by_args ? args : params;
+        ++summary.gradients;
+        RC err = side.point->setData(dim, point);
+        if (err == RC::SUCCESS)
+            err = by_args ? problem->evalGradientByArgs(side.point, side.gradient)
+                          : problem->evalGradientByParams(side.point, side.gradient);
+        if (err != RC::SUCCESS)
+            return err;
+        std::copy(side.gradient->getData(), side.gradient->getData() + dim, grad);
+        return RC::SUCCESS;
+    }
+
+    void project(double *point) const {
+        for (size_t axis = 0; axis < dim; ++axis)
+            point[axis] = std::min(std::max(point[axis], lower[axis]), upper[axis]);
+    }
+
+    // Largest coordinate of P(x - g) - x, zero at stationary point of box-constrained problem
+    double projectedGradient() const {
+        double result = 0;
+        for (size_t axis = 0; axis < dim; ++axis) {
+            const double moved = std::min(std::max(x[axis] - g[axis], lower[axis]), upper[axis]);
+            result = std::max(result, std::fabs(moved - x[axis]));
+        }
+        return result;
+    }
+
+    void resetMemory() {
+        pairs = start = 0;
+        scaled = false;
+        if (options.method != Method::BFGS)
+            return;
+        double *h = matrix();
+        for (size_t row = 0; row < dim; ++row)
+            for (size_t col = 0; col < dim; ++col)
+                h[row * dim + col] = row == col ? 1 : 0;
+    }
+
+    // Whether moving coordinate axis in direction of sign leaves box through bound where x lies
+    bool isBlocked(size_t axis, double sign) const {
+        return (x[axis] <= lower[axis] && sign < 0) || (x[axis] >= upper[axis] && sign > 0);
+    }
+
+    /*
+     * Search direction d = -H * g over free coordinates: gradient coordinates pushing x out of box through active
+     * bounds are dropped before multiplication by H, coordinates of d leaving box are zeroed after it
+     */
+    void direction() {
+        // s is free until the step is made
+        double *free = s;
+        for (size_t axis = 0; axis < dim; ++axis)
+            free[axis] = isBlocked(axis, -g[axis]) ? 0 : g[axis];
+        if (options.method == Method::GRADIENT_DESCENT || (options.method == Method::LBFGS && pairs == 0)) {
+            for (size_t axis = 0; axis < dim; ++axis)
+                d[axis] = -free[axis];
+        } else if (options.method == Method::BFGS) {
+            double const *h = matrix();
+            for (size_t row = 0; row < dim; ++row)
+                d[row] = -dot(h + row * dim, free, dim);
+        } else {
+            // Two-loop recursion, initial matrix is scaled by curvature of the newest pair
+            double *rho = historyRho(), *alpha = historyAlpha();
+            std::copy(free, free + dim, d);
+            for (size_t pair = pairs; pair-- > 0;) {
+                alpha[pair] = rho[(start + pair) % options.history] * dot(historyS(pair), d, dim);
+                double const *hist_y = historyY(pair);
+                for (size_t axis = 0; axis < dim; ++axis)
+                    d[axis] -= alpha[pair] * hist_y[axis];
+            }
+            double const *newest_s = historyS(pairs - 1), *newest_y = historyY(pairs - 1);
+            const double gamma = dot(newest_s, newest_y, dim) / dot(newest_y, newest_y, dim);
+            for (size_t axis = 0; axis < dim; ++axis)
+                d[axis] *= gamma;
+            for (size_t pair = 0; pair < pairs; ++pair) {
+                const double beta = rho[(start + pair) % options.history] * dot(historyY(pair), d, dim);
+                double const *hist_s = historyS(pair);
+                for (size_t axis = 0; axis < dim; ++axis)
+                    d[axis] += (alpha[pair] - beta) * hist_s[axis];
+            }
+            for (size_t axis = 0; axis < dim; ++axis)
+                d[axis] = -d[axis];
+        }
+        for (size_t axis = 0; axis < dim; ++axis)
+            if (isBlocked(axis, d[axis]))
+                d[axis] = 0;
+    }
+
+    // Adds pair s, y, which is skipped if its curvature isn't positive enough to keep H positive definite
+    void updateMemory() {
+        const double sy = dot(s, y, dim), yy = dot(y, y, dim);
+        if (options.method == Method::GRADIENT_DESCENT || !(sy > 1e-10 * std::sqrt(dot(s, s, dim) * yy)))
+            return;
+        if (options.method == Method::LBFGS) {
+            if (pairs == options.history)
+                start = (start + 1) % options.history;
+            else
+                ++pairs;
+            std::copy(s, s + dim, historyS(pairs - 1));
+            std::copy(y, y + dim, historyY(pairs - 1));
+            historyRho()[(start + pairs - 1) % options.history] = 1 / sy;
+            return;
+        }
+
+        // H = (I - rho s y^T) H (I - rho y s^T) + rho s s^T, H is symmetric
+        double *h = matrix();
+        if (!scaled) {
+            for (size_t row = 0; row < dim; ++row)
+                h[row * dim + row] = sy / yy;
+            scaled = true;
+        }
+        for (size_t row = 0; row < dim; ++row)
+            hy[row] = dot(h + row * dim, y, dim);
+        const double rho = 1 / sy, scale = rho * (1 + rho * dot(y, hy, dim));
+        for (size_t row = 0; row < dim; ++row)
+            for (size_t col = 0; col < dim; ++col)
+                h[row * dim + col] += scale * s[row] * s[col] - rho * (hy[row] * s[col] + s[row] * hy[col]);
+    }
+
+    // Moves x_trial to P(x + alpha * d) and returns value there
+    double trial(double alpha) {
+        for (size_t axis = 0; axis < dim; ++axis)
+            x_trial[axis] = x[axis] + alpha * d[axis];
+        project(x_trial);
+        return value(x_trial);
+    }
+
+    // Sufficient decrease along projected path, predicted by g * (x_trial - x)
+    bool isSufficient(double f, double f_trial) {
+        double predicted = 0;
+        for (size_t axis = 0; axis < dim; ++axis)
+            predicted += g[axis] * (x_trial[axis] - x[axis]);
+        stalled = stalled || std::fabs(predicted) <= ROUNDING * std::max(1.0, std::fabs(f));
+        return std::isfinite(f_trial) && f_trial <= f + ARMIJO_C1 * predicted;
+    }
+
+    // Derivative of f(P(x + alpha * d)) by alpha: coordinates stopped by bounds don't move
+    double pathSlope(double alpha) const {
+        double slope = 0;
+        for (size_t axis = 0; axis < dim; ++axis) {
+            const double moved = x[axis] + alpha * d[axis];
+            if (moved > lower[axis] && moved < upper[axis])
+                slope += g_trial[axis] * d[axis];
+        }
+        return slope;
+    }
+
+    // Backtracking with safeguarded quadratic interpolation, x_trial and g_trial are set on success
+    bool armijo(double f, double step, double &alpha, double &f_trial, RC &err) {
+        err = RC::SUCCESS;
+        alpha = step;
+        for (size_t trials = 0; trials < MAX_LINE_SEARCH_STEPS; ++trials) {
+            f_trial = trial(alpha);
+            if (isSufficient(f, f_trial)) {
+                err = gradient(x_trial, g_trial);
+                return err == RC::SUCCESS;
+            }
+            if (stalled)
+                return false;
+            const double slope = dot(g, d, dim), curvature = f_trial - f - slope * alpha;
+            double next = 0.1 * alpha;
+            if (std::isfinite(f_trial) && curvature > 0)
+                next = -slope * alpha * alpha / (2 * curvature);
+            alpha = std::min(std::max(next, 0.1 * alpha), 0.5 * alpha);
+        }
+        return false;
+    }
+
+    // Value and slope at alpha, g_trial is set
+    bool trialWithGradient(double alpha, double &f_trial, double &slope, RC &err) {
+        f_trial = trial(alpha);
+        if (!std::isfinite(f_trial)) {
+            slope = NOT_NUMBER;
+            return true;
+        }
+        err = gradient(x_trial, g_trial);
+        slope = pathSlope(alpha);
+        return err == RC::SUCCESS;
+    }
+
+    // Strong Wolfe conditions: bracketing by doubling of step, then zoom (Nocedal, Wright, algorithms 3.5 and 3.6)
+    bool wolfe(double f, double slope0, double step, double &alpha, double &f_trial, RC &err) {
+        err = RC::SUCCESS;
+        double lo = 0, f_lo = f, slope_lo = slope0, slope = 0;
+        alpha = step;
+        for (size_t trials = 0; trials < MAX_LINE_SEARCH_STEPS; ++trials) {
+            if (!trialWithGradient(alpha, f_trial, slope, err))
+                return false;
+            if (!isSufficient(f, f_trial) || (trials > 0 && f_trial >= f_lo))
+                return zoom(f, slope0, lo, f_lo, slope_lo, alpha, f_trial, slope, alpha, f_trial, err);
+            if (std::fabs(slope) <= -WOLFE_C2 * slope0)
+                return true;
+            if (slope >= 0)
+                return zoom(f, slope0, alpha, f_trial, slope, lo, f_lo, slope_lo, alpha, f_trial, err);
+            lo = alpha;
+            f_lo = f_trial;
+            slope_lo = slope;
+            alpha *= 2;
+        }
+        return false;
+    }
+
+    bool zoom(double f, double slope0, double lo, double f_lo, double slope_lo, double hi, double f_hi, double slope_hi,
+              double &alpha, double &f_trial, RC &err) {
+        for (size_t trials = 0; trials < MAX_LINE_SEARCH_STEPS; ++trials) {
+            // Minimizer of cubic interpolating values and slopes at ends, kept away from ends, else bisection
+            const double width = hi - lo;
+            alpha = lo + 0.5 * width;
+            if (std::isfinite(f_hi) && std::isfinite(slope_hi)) {
+                const double d1 = slope_lo + slope_hi - 3 * (f_lo - f_hi) / (lo - hi);
+                const double root = d1 * d1 - slope_lo * slope_hi;
+                if (root >= 0) {
+                    const double d2 = (width > 0 ? 1 : -1) * std::sqrt(root);
+                    const double cubic = hi - width * (slope_hi + d2 - d1) / (slope_hi - slope_lo + 2 * d2);
+                    const double low = std::min(lo, hi) + 0.1 * std::fabs(width);
+                    const double high = std::max(lo, hi) - 0.1 * std::fabs(width);
+                    if (std::isfinite(cubic))
+                        alpha = std::min(std::max(cubic, low), high);
+                }
+            }
+            double slope = 0;
+            if (!trialWithGradient(alpha, f_trial, slope, err))
+                return false;
+            if (!isSufficient(f, f_trial) || f_trial >= f_lo) {
+                hi = alpha;
+                f_hi = f_trial;
+                slope_hi = slope;
+                if (stalled)
+                    break;
+            } else {
+                if (std::fabs(slope) <= -WOLFE_C2 * slope0)
+                    return true;
+                if (slope * (hi - lo) >= 0) {
+                    hi = lo;
+                    f_hi = f_lo;
+                    slope_hi = slope_lo;
+                }
+                lo = alpha;
+                f_lo = f_trial;
+                slope_lo = slope;
+            }
+            if (std::fabs(hi - lo) <= std::numeric_limits<double>::epsilon() * std::max(1.0, lo))
+                break;
+        }
+        // Interval collapsed: lo still gives sufficient decrease without curvature condition
+        if (lo == 0)
+            return false;
+        alpha = lo;
+        double slope = 0;
+        return trialWithGradient(lo, f_trial, slope, err) && std::isfinite(f_trial);
+    }
+};
+
+std::atomic<ILogger *> SolverImpl::logger(nullptr);
+}; // namespace
+
+ISolver *ISolver::createSolver() { return SolverImpl::createSolver(Options()); }
+ISolver *ISolver::createSolver(Options const &options) { return SolverImpl::createSolver(options); }
+RC ISolver::setLogger(ILogger *const pLogger) { return SolverImpl::setLogger(pLogger); }
+ILogger *ISolver::getLogger() { return SolverImpl::getLogger(); }
+ISolver::~ISolver() = default;
@@ -0,0 +1,178 @@
+#include "Stats.h"
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+const char *const COUNTER_NAMES[] = {"vector_allocations", "vector_clones",          "vector_equals",
+                                     "set_scans",          "set_scanned_vectors",    "compact_iterator_steps",
+                                     "compact_sweep_nodes", "compact_allocations", "multi_index_allocations",
+                                     "log_calls"};
+const char *const TIMER_NAMES[] = {"set_make_union", "set_make_intersection", "set_insert", "compact_sweep"};
+static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == (size_t)Stats::Counter::AMOUNT,
+              "Every counter must have a name");
+static_assert(sizeof(TIMER_NAMES) / sizeof(TIMER_NAMES[0]) == (size_t)Stats::Timer::AMOUNT,
+              "Every timer must have a name");
+
+struct Block {
+    Stats::ThreadStats stats;
+    bool in_use;
+};
+
+void zero(Stats::ThreadStats &stats) {
+    for (size_t idx = 0; idx < (size_t)Stats::Counter::AMOUNT; ++idx)
+        stats.counters[idx].store(0, std::memory_order_relaxed);
+    for (size_t idx = 0; idx < (size_t)Stats::Timer::AMOUNT; ++idx) {
+        stats.timer_calls[idx].store(0, std::memory_order_relaxed);
+        stats.timer_ns[idx].store(0, std::memory_order_relaxed);
+        stats.timer_max_ns[idx].store(0, std::memory_order_relaxed);
+    }
+}
+
+/*
+ * Blocks are never freed, so counts of exited threads stay in sums and pointers cached by threads stay valid till
+ * the end of process
+ */
+struct Registry {
+    std::mutex lock;
+    std::vector<Block *> blocks;
+    Block shared; // used by threads, whose block couldn't be allocated
+
+    Registry() {
+        zero(shared.stats);
+        shared.in_use = true;
+        blocks.push_back(&shared);
+    }
+
+    // Registry is allocated on the first use and leaked on purpose, threads may count during static destruction
+    static Registry &instance() {
+        static Registry *registry = new Registry;
+        return *registry;
+    }
+};
+
+// Returns block of thread to registry when thread exits
+struct ThreadHolder {
+    Block *block = nullptr;
+
+    ~ThreadHolder() {
+        if (block == nullptr)
+            return;
+        std::lock_guard<std::mutex> guard(Registry::instance().lock);
+        block->in_use = false;
+    }
+};
+
+// Plain integer without constructor, so operator new may count into it at any time
+thread_local uint64_t heap_allocations = 0;
+
+// Sums field over blocks of all threads
+template <class Field>
+uint64_t sum(Field field) {
+    Registry &registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    uint64_t total = 0;
+    for (size_t idx = 0; idx < registry.blocks.size(); ++idx)
+        total += field(registry.blocks[idx]->stats).load(std::memory_order_relaxed);
+    return total;
+}
+} // namespace
+
+Stats::ThreadStats *Stats::registerThread() {
+    static thread_local ThreadHolder holder;
+    if (holder.block != nullptr)
+        return &holder.block->stats;
+
+    Registry &registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (size_t idx = 0; idx < registry.blocks.size() && holder.block == nullptr; ++idx)
+        if (!registry.blocks[idx]->in_use)
+            holder.block = registry.blocks[idx];
+    if (holder.block == nullptr) {
+        Block *block = new (std::nothrow) Block;
+        if (block == nullptr)
+            return &registry.shared.stats;
+        zero(block->stats);
+        registry.blocks.push_back(block);
+        holder.block = block;
+    }
+    holder.block->in_use = true;
+    return &holder.block->stats;
+}
+
+uint64_t Stats::getCounter(Counter counter) {
+    return sum([counter](ThreadStats &stats) -> std::atomic<uint64_t> & { return stats.counters[(size_t)counter]; });
+}
+
+uint64_t Stats::getTimerCalls(Timer timer) {
+    return sum([timer](ThreadStats &stats) -> std::atomic<uint64_t> & { return stats.timer_calls[(size_t)timer]; });
+}
+
+uint64_t Stats::getTimerNanoseconds(Timer timer) {
+    return sum([timer](ThreadStats &stats) -> std::atomic<uint64_t> & { return stats.timer_ns[(size_t)timer]; });
+}
+
+std::string Stats::getStats() {
+    uint64_t counters[(size_t)Counter::AMOUNT] = {};
+    uint64_t calls[(size_t)Timer::AMOUNT] = {}, total_ns[(size_t)Timer::AMOUNT] = {}, max_ns[(size_t)Timer::AMOUNT] = {};
+    size_t threads = 0;
+    {
+        Registry &registry = Registry::instance();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        threads = registry.blocks.size() - 1;
+        for (size_t block = 0; block < registry.blocks.size(); ++block) {
+            const ThreadStats &stats = registry.blocks[block]->stats;
+            for (size_t idx = 0; idx < (size_t)Counter::AMOUNT; ++idx)
+                counters[idx] += stats.counters[idx].load(std::memory_order_relaxed);
+            for (size_t idx = 0; idx < (size_t)Timer::AMOUNT; ++idx) {
+                calls[idx] += stats.timer_calls[idx].load(std::memory_order_relaxed);
+                total_ns[idx] += stats.timer_ns[idx].load(std::memory_order_relaxed);
+                uint64_t block_max = stats.timer_max_ns[idx].load(std::memory_order_relaxed);
+                max_ns[idx] = block_max > max_ns[idx] ? block_max : max_ns[idx];
+            }
+        }
+    }
+
+    char buf[160];
+#ifdef VS_MATH_STATS
+    std::string json = "{\"enabled\": true, ";
+#else
+    std::string json = "{\"enabled\": false, ";
+#endif
+    std::snprintf(buf, sizeof(buf), "\"threads\": %zu, \"counters\": {", threads);
+    json += buf;
+    for (size_t idx = 0; idx < (size_t)Counter::AMOUNT; ++idx) {
+        std::snprintf(buf, sizeof(buf), "%s\"%s\": %llu", idx == 0 ? "" : ", ", COUNTER_NAMES[idx],
+                      (unsigned long long)counters[idx]);
+        json += buf;
+    }
+    json += "}, \"timers\": {";
+    for (size_t idx = 0; idx < (size_t)Timer::AMOUNT; ++idx) {
+        std::snprintf(buf, sizeof(buf), "%s\"%s\": {\"calls\": %llu, \"total_ns\": %llu, \"max_ns\": %llu}",
+                      idx == 0 ? "" : ", ", TIMER_NAMES[idx], (unsigned long long)calls[idx],
+                      (unsigned long long)total_ns[idx], (unsigned long long)max_ns[idx]);
+        json += buf;
+    }
+    json += "}}";
+    return json;
+}
+
+void Stats::reset() {
+    Registry &registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (size_t idx = 0; idx < registry.blocks.size(); ++idx)
+        zero(registry.blocks[idx]->stats);
+}
+
+bool Stats::isHeapCounted() {
+#ifdef VS_MATH_HEAP_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t Stats::getThreadHeapAllocations() { return heap_allocations; }
+
+void Stats::countHeapAllocation() { ++heap_allocations; }
@@ -0,0 +1,286 @@
+#include "ILogger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Records older than this are written by the next logging thread even if its buffer isn't full, nanoseconds
+const int64_t FLUSH_INTERVAL = 100000000;
+
+struct Record {
+    int64_t time; // nanoseconds since creation of logger
+    size_t repeats;
+    const char *srcfile; // nullptr if record has no information about caller
+    const char *function;
+    int line;
+    RC code;
+    ILogger::Level level;
+};
+
+struct Buffer {
+    std::mutex lock; // taken by owner thread for every record and by flushing thread
+    std::vector<Record> records;
+    bool in_use; // owned by living thread, guarded by lock of registry
+};
+
+/*
+ * Buffers of logger. Threads give their buffers back on exit, and new threads take them with records left, so there
+ * are as many buffers as threads logged at once. Registry is shared with threads, so they may give buffers back after
+ * logger is deleted
+ */
+struct Registry {
+    std::mutex lock;
+    std::vector<Buffer *> buffers;
+
+    ~Registry() {
+        for (size_t idx = 0; idx < buffers.size(); ++idx)
+            delete buffers[idx];
+    }
+
+    // Free buffer or a new one, nullptr if it couldn't be allocated
+    Buffer *take(size_t buffer_size) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t idx = 0; idx < buffers.size(); ++idx) {
+            if (!buffers[idx]->in_use) {
+                buffers[idx]->in_use = true;
+                return buffers[idx];
+            }
+        }
+        Buffer *buffer = new (std::nothrow) Buffer;
+        if (buffer == nullptr)
+            return nullptr;
+        try {
+            buffer->records.reserve(buffer_size);
+            buffers.push_back(buffer);
+        } catch (std::bad_alloc const &) {
+            delete buffer;
+            return nullptr;
+        }
+        buffer->in_use = true;
+        return buffer;
+    }
+
+    void giveBack(Buffer *buffer) {
+        std::lock_guard<std::mutex> guard(lock);
+        buffer->in_use = false;
+    }
+};
+
+// Serial numbers of loggers, so that logger created at address of deleted one doesn't match cached buffer
+std::atomic<uint64_t> serials(0);
+
+// Buffers taken by thread, they are given back when thread exits
+struct Leases {
+    struct Lease {
+        uint64_t serial;
+        std::weak_ptr<Registry> registry;
+        Buffer *buffer;
+    };
+    std::vector<Lease> leases;
+
+    ~Leases();
+
+    static Leases &local() {
+        static thread_local Leases leases;
+        return leases;
+    }
+
+    // Buffer of logger with serial, taken from registry on the first call
+    Buffer *own(uint64_t serial, std::shared_ptr<Registry> const &registry, size_t buffer_size) {
+        for (size_t idx = 0; idx < leases.size(); ++idx)
+            if (leases[idx].serial == serial)
+                return leases[idx].buffer;
+        // Leases of deleted loggers are dropped, so thread doesn't collect them
+        for (size_t idx = leases.size(); idx-- > 0;)
+            if (leases[idx].registry.expired())
+                leases.erase(leases.begin() + idx);
+        Buffer *buffer = registry->take(buffer_size);
+        if (buffer == nullptr)
+            return nullptr;
+        try {
+            Lease lease = {serial, registry, buffer};
+            leases.push_back(lease);
+        } catch (std::bad_alloc const &) {
+            registry->giveBack(buffer);
+            return nullptr;
+        }
+        return buffer;
+    }
+};
+
+// Buffer of the last logger used by thread, trivial so that lookup of it is cheap
+struct ThreadCache {
+    uint64_t serial;
+    Buffer *buffer;
+};
+thread_local ThreadCache cache = {0, nullptr};
+
+Leases::~Leases() {
+    cache.serial = 0;
+    cache.buffer = nullptr;
+    for (size_t idx = 0; idx < leases.size(); ++idx) {
+        std::shared_ptr<Registry> registry = leases[idx].registry.lock();
+        if (registry != nullptr)
+            registry->giveBack(leases[idx].buffer);
+    }
+}
+
+class ThreadSafeLoggerImpl : public ILogger {
+  public:
+    static ILogger *createLogger(ILogger *const &logger, size_t buffer_size) {
+        if (logger == nullptr || buffer_size == 0)
+            return nullptr;
+        std::shared_ptr<Registry> registry;
+        try {
+            registry = std::make_shared<Registry>();
+        } catch (std::bad_alloc const &) {
+            return nullptr;
+        }
+        return new (std::nothrow) ThreadSafeLoggerImpl(logger, buffer_size, registry);
+    }
+
+    RC log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) override {
+        return logRepeated(code, level, srcfile, function, line, 1);
+    }
+    RC log(RC code, Level level) override { return append(code, level, nullptr, nullptr, 0, 1); }
+
+    RC logRepeated(RC code, Level level, const char *const &srcfile, const char *const &function, int line,
+                   size_t count) override {
+        if (srcfile == nullptr || function == nullptr) {
+            severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+            return RC::NULLPTR_ERROR;
+        }
+        return append(code, level, srcfile, function, line, count);
+    }
+
+    RC flush() override {
+        RC err = write();
+        RC flushed = logger->flush();
+        return err == RC::SUCCESS ? flushed : err;
+    }
+
+    ~ThreadSafeLoggerImpl() { write(); }
+
+  private:
+    ILogger *logger;
+    size_t buffer_size;
+    uint64_t serial;
+    Clock::time_point start;
+    std::atomic<int64_t> last_write;
+
+    std::shared_ptr<Registry> registry;
+    std::mutex write_lock; // guards merged and calls of logger
+    std::vector<Record> merged;
+
+    ThreadSafeLoggerImpl(ILogger *logger, size_t buffer_size, std::shared_ptr<Registry> const &registry)
+        : logger(logger), buffer_size(buffer_size), serial(++serials), start(Clock::now()), last_write(0),
+          registry(registry) {}
+
+    int64_t now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(); }
+
+    // Buffer of calling thread, taken on its first record
+    Buffer *own() {
+        if (cache.serial == serial)
+            return cache.buffer;
+        Buffer *buffer = Leases::local().own(serial, registry, buffer_size);
+        if (buffer == nullptr)
+            return nullptr;
+        cache.serial = serial;
+        cache.buffer = buffer;
+        return buffer;
+    }
+
+    RC append(RC code, Level level, const char *srcfile, const char *function, int line, size_t repeats) {
+        Buffer *buffer = own();
+        if (buffer == nullptr)
+            return RC::ALLOCATION_ERROR;
+
+        Record record;
+        record.repeats = repeats;
+        record.srcfile = srcfile;
+        record.function = function;
+        record.line = line;
+        record.code = code;
+        record.level = level;
+        bool full;
+        {
+            // Time is taken under lock of buffer, so records added after write() drained buffers are newer than
+            // all drained ones
+            std::lock_guard<std::mutex> guard(buffer->lock);
+            record.time = now();
+            try {
+                buffer->records.push_back(record);
+            } catch (std::bad_alloc const &) {
+                return RC::ALLOCATION_ERROR;
+            }
+            full = buffer->records.size() >= buffer_size;
+        }
+        if (full || record.time - last_write.load(std::memory_order_relaxed) >= FLUSH_INTERVAL)
+            return write();
+        return RC::SUCCESS;
+    }
+
+    /*
+     * Drains buffers of all threads at once, merges them by time and passes records to logger. Records of buffers,
+     * which didn't fit into merged, stay in them until the next write
+     */
+    RC write() {
+        std::lock_guard<std::mutex> writing(write_lock);
+        RC result = RC::SUCCESS;
+        {
+            std::lock_guard<std::mutex> guard(registry->lock);
+            std::vector<Buffer *> const &buffers = registry->buffers;
+            try {
+                // Usually records of all buffers fit, so that nothing is allocated while buffers are locked
+                merged.reserve(buffers.size() * buffer_size);
+            } catch (std::bad_alloc const &) {
+            }
+            for (size_t idx = 0; idx < buffers.size(); ++idx)
+                buffers[idx]->lock.lock();
+            for (size_t idx = 0; idx < buffers.size() && result == RC::SUCCESS; ++idx) {
+                std::vector<Record> &records = buffers[idx]->records;
+                size_t middle = merged.size();
+                try {
+                    merged.insert(merged.end(), records.begin(), records.end());
+                } catch (std::bad_alloc const &) {
+                    result = RC::ALLOCATION_ERROR;
+                    break;
+                }
+                std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(),
+                                   [](const Record &lhs, const Record &rhs) { return lhs.time < rhs.time; });
+                records.clear();
+            }
+            last_write.store(now(), std::memory_order_relaxed);
+            for (size_t idx = 0; idx < buffers.size(); ++idx)
+                buffers[idx]->lock.unlock();
+        }
+
+        for (size_t idx = 0; idx < merged.size(); ++idx) {
+            const Record &record = merged[idx];
+            RC err;
+            if (record.srcfile == nullptr)
+                err = logger->log(record.code, record.level);
+            else if (record.repeats == 1)
+                err = logger->log(record.code, record.level, record.srcfile, record.function, record.line);
+            else
+                err = logger->logRepeated(record.code, record.level, record.srcfile, record.function, record.line,
+                                          record.repeats);
+            if (err != RC::SUCCESS)
+                result = err;
+        }
+        merged.clear();
+        return result;
+    }
+};
+}; // namespace
+
+ILogger *ILogger::createThreadSafeLogger(ILogger *const &logger, size_t bufferSize) {
+    return ThreadSafeLoggerImpl::createLogger(logger, bufferSize);
+}
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <cstring>
 #include <cmath>
 #include "IVector.h"
@@ -19,26 +20,28 @@ namespace {
 
         static IVector* createVector(size_t dim, double const* const& ptr_data) {
             if (dim == 0) {
-                logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::INVALID_ARGUMENT);
                 return nullptr;
             }
             if (ptr_data == nullptr) {
-                logger->warning(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+                SendWarning(logger, ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
                 return nullptr;
             }
 
             uint8_t* ptr = new (std::nothrow) uint8_t[sizeof(VectorImpl) + dim * sizeof(double)];
             if (ptr == nullptr) {
-                logger->warning(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+                SendWarning(logger, ILogger::Module::VECTOR, RC::ALLOCATION_ERROR);
                 return nullptr;
             }
             IVector* vec = new (ptr) VectorImpl(dim);
             std::memcpy((uint8_t*)(ptr)+sizeof(VectorImpl), ptr_data, dim * sizeof(double));
+            STATS_COUNT(VECTOR_ALLOCATIONS);
 
             return vec;
         }
 
         IVector* clone() const override {
+            STATS_COUNT(VECTOR_CLONES);
             return createVector(dim, RawData());
         }
         double const* getData() const override {
@@ -46,17 +49,17 @@ namespace {
         }
         RC setData(size_t dim, double const* const& ptr_data) override {
             if (this->dim != dim) {
-                logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
                 return RC::MISMATCHING_DIMENSIONS;
             }
             if (ptr_data == nullptr) {
-                logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
                 return RC::NULLPTR_ERROR;
             }
             for (size_t idx = 0; idx < dim; ++idx)
             {
                 if (std::isnan(ptr_data[idx]) || std::isinf(ptr_data[idx])) {
-                    logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+                    SendSevere(logger, ILogger::Module::VECTOR, RC::NOT_NUMBER);
                     return RC::NOT_NUMBER;
                 }
             }
@@ -68,7 +71,7 @@ namespace {
 
         RC getCord(size_t index, double& val) const override {
             if (index >= dim) {
-                logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::INDEX_OUT_OF_BOUND);
                 return RC::INDEX_OUT_OF_BOUND;
             }
 
@@ -77,7 +80,7 @@ namespace {
         }
         RC setCord(size_t index, double val) override {
             if (index >= dim) {
-                logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::INDEX_OUT_OF_BOUND);
                 return RC::INDEX_OUT_OF_BOUND;
             }
 
@@ -94,11 +97,11 @@ namespace {
 
         RC inc(IVector const* const& op) override {
             if (op == nullptr) {
-                logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
                 return RC::NULLPTR_ERROR;
             }
             if (op->getDim() != dim) {
-                logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
                 return RC::MISMATCHING_DIMENSIONS;
             }
 
@@ -108,11 +111,11 @@ namespace {
         }
         RC dec(IVector const* const& op) override {
             if (op == nullptr) {
-                logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
                 return RC::NULLPTR_ERROR;
             }
             if (op->getDim() != dim) {
-                logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+                SendSevere(logger, ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
                 return RC::MISMATCHING_DIMENSIONS;
             }
 
@@ -143,7 +146,7 @@ namespace {
                 return max;
 
             default:
-                logger->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+                SendWarning(logger, ILogger::Module::VECTOR, RC::INVALID_ARGUMENT);
                 return 0;
             }
         }
@@ -171,7 +174,7 @@ namespace {
         ~VectorImpl() = default;
 
     private:
-        static ILogger* logger;
+        static std::atomic<ILogger*> logger;
         size_t dim;
 
         inline double* RawData() const
@@ -181,7 +184,7 @@ namespace {
 
         VectorImpl(size_t dim) : dim(dim) {}
     };
-    ILogger* VectorImpl::logger = nullptr;
+    std::atomic<ILogger*> VectorImpl::logger(nullptr);
 };
 
 IVector* IVector::createVector(size_t dim, double const* const& ptr_data) {
@@ -190,11 +193,11 @@ IVector* IVector::createVector(size_t dim, double const* const& ptr_data) {
 
 RC IVector::copyInstance(IVector* const dest, IVector const* const& src) {
     if (!(abs((int)((uint8_t*)src - (uint8_t*)dest)) >= src->sizeAllocated())) {
-        src->getLogger()->severe(RC::MEMORY_INTERSECTION, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MEMORY_INTERSECTION);
         return RC::MEMORY_INTERSECTION;
     }
     if (src->sizeAllocated() != dest->sizeAllocated()) {
-        src->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
@@ -204,11 +207,11 @@ RC IVector::copyInstance(IVector* const dest, IVector const* const& src) {
 
 RC IVector::moveInstance(IVector* const dest, IVector*& src) {
     if (!(abs((int)((uint8_t*)src - (uint8_t*)dest)) >= src->sizeAllocated())) {
-        src->getLogger()->severe(RC::MEMORY_INTERSECTION, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MEMORY_INTERSECTION);
         return RC::MEMORY_INTERSECTION;
     }
     if (src->sizeAllocated() != dest->sizeAllocated()) {
-        src->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return RC::MISMATCHING_DIMENSIONS;
     }
 
@@ -228,11 +231,11 @@ ILogger* IVector::getLogger() {
 
 IVector* IVector::add(IVector const* const& op1, IVector const* const& op2) {
     if (op1 == nullptr || op2 == nullptr) {
-        op1->getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
         return nullptr;
     }
     if (op1->getDim() != op2->getDim()) {
-        op1->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
 
@@ -243,11 +246,11 @@ IVector* IVector::add(IVector const* const& op1, IVector const* const& op2) {
 
 IVector* IVector::sub(IVector const* const& op1, IVector const* const& op2) {
     if (op1 == nullptr || op2 == nullptr) {
-        op1->getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
         return nullptr;
     }
     if (op1->getDim() != op2->getDim()) {
-        op1->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return nullptr;
     }
 
@@ -258,11 +261,11 @@ IVector* IVector::sub(IVector const* const& op1, IVector const* const& op2) {
 
 double IVector::dot(IVector const* const& op1, IVector const* const& op2) {
     if (op1 == nullptr || op2 == nullptr) {
-        op1->getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
         return 0;
     }
     if (op1->getDim() != op2->getDim()) {
-        op1->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return 0;
     }
 
@@ -273,16 +276,17 @@ double IVector::dot(IVector const* const& op1, IVector const* const& op2) {
 }
 
 bool IVector::equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol) {
+    STATS_COUNT(VECTOR_EQUALS);
     if (op1 == nullptr || op2 == nullptr) {
-        op1->getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::NULLPTR_ERROR);
         return false;
     }
     if (op1->getDim() != op2->getDim()) {
-        op1->getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::MISMATCHING_DIMENSIONS);
         return false;
     }
     if (tol < 0) {
-        op1->getLogger()->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        SendSevere(getLogger(), ILogger::Module::VECTOR, RC::INVALID_ARGUMENT);
         return false;
     }
 
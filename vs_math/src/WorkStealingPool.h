@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/*
+ * Minimal fork-join pool for coarse independent tasks numbered 0..tasks-1
+ *
+ * Every worker owns a contiguous range of task numbers and takes tasks from its front, so neighbour tasks run on the
+ * same thread one after another. Worker with empty range steals one task from the back of the fullest range of
+ * another worker. Tasks are supposed to be tiles of hundreds of nodes or more, so range is guarded with a mutex.
+ *
+ * Solvers run task 0 on calling thread first and the rest by run() only if it succeeded, so errors common to all tasks
+ * (like args or params not set) are logged once instead of once per task
+ */
+class WorkStealingPool {
+  public:
+    static size_t defaultThreads() {
+        size_t threads = std::thread::hardware_concurrency();
+        return threads == 0 ? 1 : threads;
+    }
+
+    /*
+     * Runs fn(task, worker) for every task in [0, tasks) and returns when all of them are done
+     *
+     * @param [in] tasks Quantity of tasks
+     *
+     * @param [in] threads Quantity of workers, 0 means defaultThreads(), calling thread is worker 0. If system can't
+     * start a thread, tasks of workers that weren't started are stolen by the started ones. Without memory for workers
+     * all tasks are run by calling thread
+     *
+     * @param [in] fn Callable, that must be safe to call from different threads for different tasks. If it throws on any
+     * worker, workers take no more tasks, run() joins all of them and rethrows the first exception on calling thread
+     */
+    template <class Fn>
+    static void run(size_t tasks, size_t threads, Fn fn) {
+        if (threads == 0)
+            threads = defaultThreads();
+        if (threads > tasks)
+            threads = tasks;
+        if (threads <= 1) {
+            for (size_t task = 0; task < tasks; ++task)
+                fn(task, 0);
+            return;
+        }
+
+        // Without memory for ranges and threads tasks are run by calling thread
+        std::vector<Range> ranges;
+        std::vector<std::thread> workers;
+        try {
+            ranges = std::vector<Range>(threads);
+            workers.reserve(threads - 1);
+        } catch (std::bad_alloc const &) {
+            for (size_t task = 0; task < tasks; ++task)
+                fn(task, 0);
+            return;
+        }
+        for (size_t worker = 0; worker < threads; ++worker) {
+            ranges[worker].begin = tasks * worker / threads;
+            ranges[worker].end = tasks * (worker + 1) / threads;
+        }
+
+        Failure failure;
+        try {
+            for (size_t worker = 1; worker < threads; ++worker)
+                workers.push_back(std::thread(&WorkStealingPool::work<Fn>, std::ref(ranges), worker, std::ref(fn),
+                                              std::ref(failure)));
+        } catch (std::system_error const &) {
+        } catch (std::bad_alloc const &) {
+        }
+        work(ranges, 0, fn, failure);
+        for (size_t worker = 0; worker < workers.size(); ++worker)
+            workers[worker].join();
+        if (failure.first)
+            std::rethrow_exception(failure.first);
+    }
+
+  private:
+    struct Range {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // The first exception thrown by fn, workers stop taking tasks once it's set
+    struct Failure {
+        std::mutex lock;
+        std::exception_ptr first;
+        std::atomic<bool> failed;
+
+        Failure() : failed(false) {}
+
+        void set(std::exception_ptr error) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!first)
+                first = error;
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    static bool popOwn(Range &range, size_t &task) {
+        std::lock_guard<std::mutex> guard(range.lock);
+        if (range.begin == range.end)
+            return false;
+        task = range.begin++;
+        return true;
+    }
+
+    static bool steal(std::vector<Range> &ranges, size_t self, size_t &task) {
+        while (true) {
+            size_t victim = ranges.size();
+            size_t victim_left = 0;
+            for (size_t worker = 0; worker < ranges.size(); ++worker) {
+                if (worker == self)
+                    continue;
+                std::lock_guard<std::mutex> guard(ranges[worker].lock);
+                size_t left = ranges[worker].end - ranges[worker].begin;
+                if (left > victim_left) {
+                    victim = worker;
+                    victim_left = left;
+                }
+            }
+            if (victim == ranges.size())
+                return false;
+
+            std::lock_guard<std::mutex> guard(ranges[victim].lock);
+            if (ranges[victim].begin != ranges[victim].end) {
+                task = --ranges[victim].end;
+                return true;
+            }
+        }
+    }
+
+    template <class Fn>
+    static void work(std::vector<Range> &ranges, size_t self, Fn &fn, Failure &failure) {
+        size_t task;
+        try {
+            while (!failure.failed.load(std::memory_order_relaxed) &&
+                   (popOwn(ranges[self], task) || steal(ranges, self, task)))
+                fn(task, self);
+        } catch (...) {
+            failure.set(std::current_exception());
+        }
+    }
+};
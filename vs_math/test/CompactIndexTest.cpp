@@ -0,0 +1,163 @@
+#include "ICompactIndex.h"
+#include "tests.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+const size_t BOXES = 500;
+const size_t DIM = 3;
+
+// Random boxes in [0, 10]^DIM with sides up to 2
+std::vector<ICompact *> createBoxes() {
+    std::srand(7);
+    size_t grid_data[DIM] = {2, 2, 2};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(DIM, grid_data);
+    std::vector<ICompact *> boxes(BOXES);
+    double left[DIM], right[DIM];
+    for (size_t box = 0; box < BOXES; ++box) {
+        for (size_t idx = 0; idx < DIM; ++idx) {
+            left[idx] = 10.0 * std::rand() / RAND_MAX;
+            right[idx] = left[idx] + 2.0 * std::rand() / RAND_MAX;
+        }
+        IVector *left_vec = IVector::createVector(DIM, left);
+        IVector *right_vec = IVector::createVector(DIM, right);
+        boxes[box] = ICompact::createCompact(left_vec, right_vec, grid);
+        delete left_vec;
+        delete right_vec;
+    }
+    delete grid;
+    return boxes;
+}
+
+void clearBoxes(std::vector<ICompact *> &boxes) {
+    for (size_t box = 0; box < boxes.size(); ++box)
+        delete boxes[box];
+}
+
+std::vector<size_t> bruteContaining(const std::vector<ICompact *> &boxes, const double *point) {
+    std::vector<size_t> found;
+    IVector *vec = IVector::createVector(DIM, point);
+    for (size_t box = 0; box < boxes.size(); ++box)
+        if (boxes[box]->isInside(vec))
+            found.push_back(box);
+    delete vec;
+    return found;
+}
+} // namespace
+
+void CompactIndexTest::testCreate() {
+    CREATE_LOGGER
+    std::vector<ICompact *> boxes = createBoxes();
+
+    ICompactIndex *index = ICompactIndex::createCompactIndex(boxes.data(), boxes.size(), 4);
+    assert(index != nullptr);
+    assert(index->getDim() == DIM);
+    assert(index->getSize() == BOXES);
+    assert(ICompactIndex::createCompactIndex(boxes.data(), 0) == nullptr);
+
+    delete index;
+    clearBoxes(boxes);
+    CLEAR_LOGGER
+}
+
+void CompactIndexTest::testFindContaining() {
+    CREATE_LOGGER
+    std::vector<ICompact *> boxes = createBoxes();
+    ICompactIndex *index = ICompactIndex::createCompactIndex(boxes.data(), boxes.size(), 4);
+
+    size_t found[BOXES];
+    double point[DIM];
+    for (size_t probe = 0; probe < 200; ++probe) {
+        for (size_t idx = 0; idx < DIM; ++idx)
+            point[idx] = 11.0 * std::rand() / RAND_MAX;
+        size_t count = 0;
+        RC err = index->findContaining(point, found, BOXES, count);
+        assert(err == RC::SUCCESS);
+
+        std::vector<size_t> expected = bruteContaining(boxes, point);
+        std::vector<size_t> actual(found, found + count);
+        std::sort(actual.begin(), actual.end());
+        assert(actual == expected);
+    }
+
+    delete index;
+    clearBoxes(boxes);
+    CLEAR_LOGGER
+}
+
+void CompactIndexTest::testFindOverlapping() {
+    CREATE_LOGGER
+    std::vector<ICompact *> boxes = createBoxes();
+    ICompactIndex *index = ICompactIndex::createCompactIndex(boxes.data(), boxes.size(), 1);
+
+    double left_data[DIM] = {4, 4, 4}, right_data[DIM] = {5, 6, 5};
+    size_t found[BOXES];
+    size_t count = 0;
+    RC err = index->findOverlapping(left_data, right_data, found, BOXES, count);
+    assert(err == RC::SUCCESS);
+
+    std::vector<size_t> expected;
+    for (size_t box = 0; box < BOXES; ++box) {
+        bool overlap = true;
+        for (size_t idx = 0; idx < DIM; ++idx)
+            overlap = overlap && boxes[box]->getLeftBoundaryData()[idx] <= right_data[idx] &&
+                      left_data[idx] <= boxes[box]->getRightBoundaryData()[idx];
+        if (overlap)
+            expected.push_back(box);
+    }
+    std::vector<size_t> actual(found, found + count);
+    std::sort(actual.begin(), actual.end());
+    assert(actual == expected);
+
+    // count is reported even if buffer is too small
+    size_t small_count = 0;
+    err = index->findOverlapping(left_data, right_data, found, 1, small_count);
+    assert(err == RC::SUCCESS);
+    assert(small_count == count);
+
+    delete index;
+    clearBoxes(boxes);
+    CLEAR_LOGGER
+}
+
+void CompactIndexTest::testFindContainingBatch() {
+    CREATE_LOGGER
+    std::vector<ICompact *> boxes = createBoxes();
+    ICompactIndex *index = ICompactIndex::createCompactIndex(boxes.data(), boxes.size(), 4);
+
+    const size_t points = 3000;
+    std::vector<double> rows(points * DIM);
+    for (size_t idx = 0; idx < rows.size(); ++idx)
+        rows[idx] = 11.0 * std::rand() / RAND_MAX;
+    std::vector<size_t> offsets(points + 1);
+
+    RC err = index->findContainingBatch(rows.data(), points, offsets.data(), nullptr, 0, 4);
+    assert(err == RC::INDEX_OUT_OF_BOUND || offsets[points] == 0);
+    std::vector<size_t> found(offsets[points]);
+    err = index->findContainingBatch(rows.data(), points, offsets.data(), found.data(), found.size(), 4);
+    assert(err == RC::SUCCESS);
+
+    for (size_t point = 0; point < points; ++point) {
+        std::vector<size_t> actual(found.begin() + offsets[point], found.begin() + offsets[point + 1]);
+        std::sort(actual.begin(), actual.end());
+        assert(actual == bruteContaining(boxes, rows.data() + point * DIM));
+    }
+
+    delete index;
+    clearBoxes(boxes);
+    CLEAR_LOGGER
+}
+
+void CompactIndexTest::testAll() {
+    std::cout << "Running all CompactIndex tests" << std::endl;
+
+    testCreate();
+    testFindContaining();
+    testFindOverlapping();
+    testFindContainingBatch();
+
+    std::cout << "Successfully ran all CompactIndex tests" << std::endl;
+}
@@ -1,6 +1,16 @@
+#include "Stats.h"
 #include "tests.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Heap blocks allocated by calling thread through operator new of libraries
+uint64_t allocations() { return Stats::getThreadHeapAllocations(); }
+} // namespace
 
 void CompactTest::testCreate() {
     CREATE_ALL
@@ -106,6 +116,36 @@ void CompactTest::testIsInside() {
     CLEAR_COM_ONE
 }
 
+void CompactTest::testIsInsideBatch() {
+    CREATE_LOGGER
+    CREATE_COM_ONE
+    double rows[] = {2.5, 4.3, 6, 1, 0, 0, 5, 5, -0.1, 2, 1, 1, 2, 2, 3, 3, 4, 4.9, 5.1, 0};
+    const size_t count = SIZEOF_ARR(rows) / 2;
+    uint8_t mask[(count + 7) / 8];
+    size_t nodes[count];
+    size_t order_data[] = {0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+
+    RC err = com1->isInsideBatch(rows, count, mask, order, nodes);
+    assert(err == RC::SUCCESS);
+    assert(mask[0] == 0xED); // all points of the first byte except 1 and 4
+    assert(mask[1] == 0x01);
+    for (size_t point = 0; point < count; ++point) {
+        IVector *vec = IVector::createVector(2, rows + point * 2);
+        assert(com1->isInside(vec) == (bool)(mask[point / 8] & (1 << (point % 8))));
+        delete vec;
+    }
+    assert(nodes[0] == 3 + 6 * 4);
+    assert(nodes[1] == com1->getNodesCount());
+    assert(nodes[2] == 0);
+    assert(nodes[3] == 35);
+    assert(nodes[8] == 4 + 6 * 5);
+
+    delete order;
+    CLEAR_COM_ONE
+    CLEAR_LOGGER
+}
+
 void CompactTest::testIntersection() {
     CREATE_LOGGER
     CREATE_COM_ONE
@@ -169,6 +209,76 @@ void CompactTest::testSpan() {
     CLEAR_LOGGER
 }
 
+void CompactTest::testBatchIntersection() {
+    CREATE_LOGGER
+    CREATE_COM_ONE
+    CREATE_COM_TWO
+
+    // [6, 7]^2 doesn't touch com1, [5, 6] x [1, 2] touches it by a segment of the line x = 5
+    double far_left_data[] = {6, 6}, far_right_data[] = {7, 7};
+    double edge_left_data[] = {5, 1}, edge_right_data[] = {6, 2};
+    IVector *far_left = IVector::createVector(SIZEOF_ARR(far_left_data), far_left_data);
+    IVector *far_right = IVector::createVector(SIZEOF_ARR(far_right_data), far_right_data);
+    IVector *edge_left = IVector::createVector(SIZEOF_ARR(edge_left_data), edge_left_data);
+    IVector *edge_right = IVector::createVector(SIZEOF_ARR(edge_right_data), edge_right_data);
+    ICompact *far = ICompact::createCompact(far_left, far_right, grid1);
+    ICompact *edge = ICompact::createCompact(edge_left, edge_right, grid1);
+
+    ICompact const *others[] = {com2, far, edge};
+    ICompact *results[SIZEOF_ARR(others)];
+    RC err = ICompact::createIntersections(com1, others, SIZEOF_ARR(others), grid1, TOLERANCE, results);
+    assert(err == RC::SUCCESS);
+
+    assert(results[0] != nullptr);
+    for (size_t idx = 0; idx < com1->getDim(); ++idx) {
+        assert(results[0]->getLeftBoundaryData()[idx] == left_bound_data2[idx]);
+        assert(results[0]->getRightBoundaryData()[idx] == right_bound_data1[idx]);
+    }
+    assert(results[1] == nullptr);
+    assert(results[2] != nullptr);
+    IMultiIndex *edge_grid = results[2]->getGrid();
+    assert(edge_grid->getData()[0] == 1);
+    assert(edge_grid->getData()[1] == grid_data1[1]);
+    assert(results[2]->getNodesCount() == grid_data1[1]);
+
+    ICompact *spans[SIZEOF_ARR(others)];
+    err = ICompact::createCompactSpans(com1, others, SIZEOF_ARR(others), grid1, spans);
+    assert(err == RC::SUCCESS);
+    for (size_t idx = 0; idx < com1->getDim(); ++idx) {
+        assert(spans[1]->getLeftBoundaryData()[idx] == left_bound_data1[idx]);
+        assert(spans[1]->getRightBoundaryData()[idx] == far_right_data[idx]);
+    }
+
+    // Invalid grid is reported as such, not as lack of memory
+    size_t empty_data[] = {0, 2}, huge_data[] = {SIZE_MAX / 2, 3};
+    IMultiIndex *empty = IMultiIndex::createMultiIndex(SIZEOF_ARR(empty_data), empty_data);
+    IMultiIndex *huge = IMultiIndex::createMultiIndex(SIZEOF_ARR(huge_data), huge_data);
+    ICompact *rejected[SIZEOF_ARR(others)];
+    assert(ICompact::createIntersections(com1, others, SIZEOF_ARR(others), empty, TOLERANCE, rejected) ==
+           RC::INVALID_ARGUMENT);
+    assert(ICompact::createIntersections(com1, others, SIZEOF_ARR(others), huge, TOLERANCE, rejected) ==
+           RC::INFINITY_OVERFLOW);
+    assert(ICompact::createCompactSpans(com1, others, SIZEOF_ARR(others), empty, rejected) == RC::INVALID_ARGUMENT);
+    assert(ICompact::createCompactSpans(com1, others, SIZEOF_ARR(others), huge, rejected) == RC::INFINITY_OVERFLOW);
+    delete huge;
+    delete empty;
+
+    for (size_t idx = 0; idx < SIZEOF_ARR(others); ++idx) {
+        delete results[idx];
+        delete spans[idx];
+    }
+    delete edge_grid;
+    delete edge;
+    delete far;
+    delete edge_right;
+    delete edge_left;
+    delete far_right;
+    delete far_left;
+    CLEAR_COM_TWO
+    CLEAR_COM_ONE
+    CLEAR_LOGGER
+}
+
 void CompactTest::testIterator() {
     CREATE_LOGGER
     CREATE_COM_ONE
@@ -187,11 +297,485 @@ void CompactTest::testIterator() {
     }
 
     delete iter;
+
+    // bypass order must be a permutation of axes
+    size_t repeated_data[] = {1, 1};
+    IMultiIndex *repeated = IMultiIndex::createMultiIndex(SIZEOF_ARR(repeated_data), repeated_data);
+    assert(com1->getBegin(repeated) == nullptr && com1->getEnd(repeated) == nullptr);
+    delete repeated;
+
     delete order;
     CLEAR_COM_ONE
     CLEAR_LOGGER
 }
 
+void CompactTest::testIteratorNodes() {
+    CREATE_LOGGER
+    double left_data[] = {-1, 2};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 5};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {3, 4};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+
+    size_t order_data[] = {1, 0};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    ICompact::IIterator *iter = com->getBegin(order);
+    assert(iter != nullptr);
+
+    // axis 1 is the fastest one, so nodes go as (-1, 2), (-1, 3), ..., (-1, 5), (0, 2), ...
+    double coords[2];
+    size_t count = 0;
+    for (; iter->isValid(); iter->next(), ++count) {
+        RC err = iter->getVectorCoords(coords, SIZEOF_ARR(coords));
+        assert(err == RC::SUCCESS);
+        assert(std::fabs(coords[0] - (-1.0 + (double)(count / 4))) < TOLERANCE);
+        assert(std::fabs(coords[1] - (2.0 + (double)(count % 4))) < TOLERANCE);
+    }
+    assert(count == grid_data[0] * grid_data[1]);
+    assert(iter->next() == RC::INDEX_OUT_OF_BOUND);
+
+    delete iter;
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testGenerateNodes() {
+    CREATE_LOGGER
+    double left_data[] = {-1, 2, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 5, 1};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {3, 4, 2};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+    size_t order_data[] = {1, 2, 0};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    assert(com->getNodesCount() == 24);
+
+    // tile size doesn't divide nodes count, so the last tile is shorter
+    const size_t tile = 5;
+    const size_t dim = SIZEOF_ARR(left_data);
+    double block[tile * dim];
+    double coords[dim];
+    ICompact::IIterator *iter = com->getBegin(order);
+    for (size_t start = 0; start < com->getNodesCount(); start += tile) {
+        size_t count = std::min(tile, com->getNodesCount() - start);
+        RC err = com->generateNodes(start, count, order, block);
+        assert(err == RC::SUCCESS);
+        for (size_t row = 0; row < count; ++row, iter->next()) {
+            assert(iter->isValid());
+            iter->getVectorCoords(coords, dim);
+            for (size_t idx = 0; idx < dim; ++idx)
+                assert(block[row * dim + idx] == coords[idx]);
+        }
+    }
+    assert(!iter->isValid());
+    assert(com->generateNodes(20, tile, order, block) == RC::INDEX_OUT_OF_BOUND);
+
+    delete iter;
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testParallelForEachNode() {
+    CREATE_LOGGER
+    double left_data[] = {-1, 2, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 5, 1};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {7, 5, 30};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+    size_t order_data[] = {2, 0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+
+    const size_t dim = SIZEOF_ARR(left_data);
+    const size_t count = com->getNodesCount();
+    std::vector<double> expected(count * dim);
+    RC err = com->generateNodes(0, count, order, expected.data());
+    assert(err == RC::SUCCESS);
+
+    // every node is visited by exactly one thread, so writes to distinct slots don't race
+    std::vector<double> visited(count * dim);
+    std::vector<int> visits(count, 0);
+    err = com->parallelForEachNode(
+        order,
+        [&](size_t node, double const *coords) {
+            ++visits[node];
+            for (size_t idx = 0; idx < dim; ++idx)
+                visited[node * dim + idx] = coords[idx];
+        },
+        4);
+    assert(err == RC::SUCCESS);
+    for (size_t node = 0; node < count; ++node)
+        assert(visits[node] == 1);
+    assert(visited == expected);
+
+    // Exception of callback reaches caller after all threads stopped
+    bool thrown = false;
+    try {
+        com->parallelForEachNode(
+            order,
+            [&](size_t node, double const *) {
+                if (node == count / 2)
+                    throw std::runtime_error("node");
+            },
+            4);
+    } catch (std::runtime_error const &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testLinearIndex() {
+    CREATE_LOGGER
+    double left_data[] = {-1, 2, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 5, 1};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {3, 4, 2};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+    size_t order_data[] = {1, 2, 0};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+
+    const size_t dim = SIZEOF_ARR(left_data);
+    size_t zero_data[] = {0, 0, 0};
+    IMultiIndex *index = IMultiIndex::createMultiIndex(SIZEOF_ARR(zero_data), zero_data);
+    double node[dim], expected[dim];
+    for (size_t k = 0; k < com->getNodesCount(); ++k) {
+        RC err = com->fromLinear(k, order, index);
+        assert(err == RC::SUCCESS);
+        size_t linear = 0;
+        err = com->toLinear(index, order, linear);
+        assert(err == RC::SUCCESS);
+        assert(linear == k);
+
+        // random access gives the same node as sequential generation and as an iterator started from that index
+        com->getNode(k, order, node);
+        com->generateNodes(k, 1, order, expected);
+        for (size_t idx = 0; idx < dim; ++idx)
+            assert(node[idx] == expected[idx]);
+        ICompact::IIterator *iter = com->getIterator(index, order);
+        iter->getVectorCoords(expected, dim);
+        for (size_t idx = 0; idx < dim; ++idx)
+            assert(node[idx] == expected[idx]);
+        delete iter;
+    }
+    // fastest axis of the order is the least significant digit
+    size_t pos_data[] = {2, 1, 1};
+    IMultiIndex *pos = IMultiIndex::createMultiIndex(SIZEOF_ARR(pos_data), pos_data);
+    size_t linear = 0;
+    com->toLinear(pos, order, linear);
+    assert(linear == 1 + 4 * (1 + 2 * 2));
+    assert(com->getNode(com->getNodesCount(), order, node) == RC::INDEX_OUT_OF_BOUND);
+
+    delete pos;
+    delete index;
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+namespace {
+// Visits all nodes of compact over [0, n - 1] along axes (coordinates are positions) with given traversal, checks that
+// every node is visited once and returns visited positions
+std::vector<std::vector<double>> traverse(ICompact const *com, IMultiIndex const *order,
+                                          ICompact::TRAVERSAL traversal, IMultiIndex const *tile) {
+    const size_t dim = com->getDim();
+    std::vector<std::vector<double>> visited;
+    std::vector<int> visits(com->getNodesCount(), 0);
+    ICompact::IIterator *iter = com->getBegin(order, traversal, tile);
+    assert(iter != nullptr);
+    std::vector<double> coords(dim);
+    for (; iter->isValid(); iter->next()) {
+        iter->getVectorCoords(coords.data(), dim);
+        size_t node = 0;
+        for (size_t axis = dim; axis-- > 0;)
+            node = node * (size_t)(com->getRightBoundaryData()[axis] + 1.5) + (size_t)coords[axis];
+        ++visits[node];
+        visited.push_back(coords);
+    }
+    delete iter;
+    for (size_t node = 0; node < visits.size(); ++node)
+        assert(visits[node] == 1);
+    return visited;
+}
+} // namespace
+
+void CompactTest::testIteratorAllocations() {
+    // Without counter every check below would hold trivially
+    assert(Stats::isHeapCounted());
+    CREATE_LOGGER
+    double left_data[] = {-1, 2, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 5, 1};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {4, 5, 6};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+    size_t order_data[] = {1, 2, 0};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    size_t tile_data[] = {2, 2, 2};
+    IMultiIndex *tile = IMultiIndex::createMultiIndex(SIZEOF_ARR(tile_data), tile_data);
+    IMultiIndex *index = IMultiIndex::createMultiIndex(SIZEOF_ARR(tile_data), tile_data);
+    IVector *val = left->clone();
+    const size_t dim = SIZEOF_ARR(left_data);
+    double coords[dim];
+
+    // Moving iterators and reading coordinates never touch heap
+    const ICompact::TRAVERSAL traversals[] = {ICompact::TRAVERSAL::LEXICOGRAPHIC, ICompact::TRAVERSAL::TILED,
+                                              ICompact::TRAVERSAL::MORTON, ICompact::TRAVERSAL::HILBERT};
+    for (size_t kind = 0; kind < SIZEOF_ARR(traversals); ++kind) {
+        ICompact::IIterator *iter = com->getBegin(order, traversals[kind], tile);
+        size_t steps = 0;
+        const uint64_t before = allocations();
+        for (; iter->isValid(); iter->next(), ++steps)
+            iter->getVectorCoords(coords, dim);
+        assert(iter->next() == RC::INDEX_OUT_OF_BOUND);
+        assert(allocations() == before);
+        assert(steps == com->getNodesCount());
+        delete iter;
+    }
+
+    const uint64_t before = allocations();
+    for (size_t node = 0; node < com->getNodesCount(); ++node) {
+        com->getNode(node, order, coords);
+        com->fromLinear(node, order, index);
+        com->getVectorCoords(index, val);
+    }
+    assert(com->getGridData()[2] == grid_data[2]);
+    assert(allocations() == before);
+    // Counter does see allocations of the library
+    ICompact::IIterator *iter = com->getBegin(order);
+    assert(allocations() > before);
+    delete iter;
+
+    delete val;
+    delete index;
+    delete tile;
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testTraversal() {
+    CREATE_LOGGER
+    double left_data[] = {0, 0, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {4, 2, 6};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {5, 3, 7};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    ICompact *com = ICompact::createCompact(left, right, grid);
+    size_t order_data[] = {2, 0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    size_t tile_data[] = {2, 2, 3};
+    IMultiIndex *tile = IMultiIndex::createMultiIndex(SIZEOF_ARR(tile_data), tile_data);
+
+    // nodes of the first tile go first, axis 2 is the fastest one
+    std::vector<std::vector<double>> tiled = traverse(com, order, ICompact::TRAVERSAL::TILED, tile);
+    double first_tile[][3] = {{0, 0, 0}, {0, 0, 1}, {0, 0, 2}, {1, 0, 0}, {1, 0, 1}, {1, 0, 2}, {0, 1, 0}};
+    for (size_t row = 0; row < SIZEOF_ARR(first_tile); ++row)
+        for (size_t axis = 0; axis < 3; ++axis)
+            assert(tiled[row][axis] == first_tile[row][axis]);
+    traverse(com, order, ICompact::TRAVERSAL::MORTON, nullptr);
+    traverse(com, order, ICompact::TRAVERSAL::HILBERT, nullptr);
+    assert(com->getBegin(order, ICompact::TRAVERSAL::TILED, nullptr) == nullptr);
+
+    // on grid of 2^k nodes per axis consecutive nodes of Hilbert curve are neighbours
+    double square_data[] = {7, 7};
+    IVector *square_right = IVector::createVector(SIZEOF_ARR(square_data), square_data);
+    size_t square_grid_data[] = {8, 8};
+    IMultiIndex *square_grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(square_grid_data), square_grid_data);
+    IVector *square_left = IVector::createVector(2, left_data);
+    ICompact *square = ICompact::createCompact(square_left, square_right, square_grid);
+    size_t square_order_data[] = {0, 1};
+    IMultiIndex *square_order = IMultiIndex::createMultiIndex(SIZEOF_ARR(square_order_data), square_order_data);
+    std::vector<std::vector<double>> hilbert = traverse(square, square_order, ICompact::TRAVERSAL::HILBERT, nullptr);
+    for (size_t row = 1; row < hilbert.size(); ++row)
+        assert(std::fabs(hilbert[row][0] - hilbert[row - 1][0]) + std::fabs(hilbert[row][1] - hilbert[row - 1][1]) ==
+               1);
+    std::vector<std::vector<double>> morton = traverse(square, square_order, ICompact::TRAVERSAL::MORTON, nullptr);
+    double first_morton[][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {2, 0}};
+    for (size_t row = 0; row < SIZEOF_ARR(first_morton); ++row)
+        assert(morton[row][0] == first_morton[row][0] && morton[row][1] == first_morton[row][1]);
+
+    // clone continues the same traversal
+    ICompact::IIterator *iter = square->getBegin(square_order, ICompact::TRAVERSAL::HILBERT);
+    for (size_t step = 0; step < 10; ++step)
+        iter->next();
+    ICompact::IIterator *copy = iter->clone();
+    double coords[2], copy_coords[2];
+    for (; iter->isValid(); iter->next(), copy->next()) {
+        assert(copy->isValid());
+        iter->getVectorCoords(coords, 2);
+        copy->getVectorCoords(copy_coords, 2);
+        assert(coords[0] == copy_coords[0] && coords[1] == copy_coords[1]);
+    }
+    assert(!copy->isValid());
+
+    delete copy;
+    delete iter;
+    delete square_order;
+    delete square;
+    delete square_left;
+    delete square_grid;
+    delete square_right;
+    delete tile;
+    delete order;
+    delete com;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testNonUniformGrid() {
+    CREATE_LOGGER
+    double left_data[] = {-1, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {1, 7};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {5, 4};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    IGridSpec *spec = IGridSpec::createGridSpec(grid);
+    assert(spec != nullptr && spec->isUniform());
+    assert(spec->setAxis(0, IGridSpec::SPACING::CHEBYSHEV, 5) == RC::SUCCESS);
+    assert(spec->setAxis(1, IGridSpec::SPACING::GEOMETRIC, 4, 2) == RC::SUCCESS);
+    assert(spec->setAxis(1, IGridSpec::SPACING::GEOMETRIC, 4, -2) == RC::INVALID_ARGUMENT);
+    double bad_nodes[] = {0, 0.5, 0.4, 1};
+    assert(spec->setAxisNodes(1, SIZEOF_ARR(bad_nodes), bad_nodes) == RC::INVALID_ARGUMENT);
+    assert(!spec->isUniform());
+    ICompact *com = ICompact::createCompact(left, right, spec);
+    assert(com != nullptr && !com->isUniform());
+
+    // Chebyshev-Lobatto nodes of [-1, 1] are -cos(pi * k / 4), distances along axis 1 are 1, 2, 4
+    const double pi = std::acos(-1.0);
+    double expected0[] = {-1, -std::cos(pi / 4), 0, std::cos(pi / 4), 1};
+    double expected1[] = {0, 1, 3, 7};
+    size_t order_data[] = {0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    const size_t dim = SIZEOF_ARR(left_data);
+    std::vector<double> block(com->getNodesCount() * dim);
+    RC err = com->generateNodes(0, com->getNodesCount(), order, block.data());
+    assert(err == RC::SUCCESS);
+    ICompact::IIterator *iter = com->getBegin(order);
+    double coords[dim];
+    for (size_t node = 0; node < com->getNodesCount(); ++node, iter->next()) {
+        assert(iter->isValid());
+        iter->getVectorCoords(coords, dim);
+        assert(std::fabs(coords[0] - expected0[node % 5]) < TOLERANCE);
+        assert(coords[1] == expected1[node / 5]);
+        assert(coords[0] == block[node * dim] && coords[1] == block[node * dim + 1]);
+    }
+    assert(!iter->isValid());
+
+    // nearest node is searched among actual node coordinates
+    double rows[] = {0.6, 1.9, 0.1, 5.5, 2, 0};
+    uint8_t mask[1];
+    size_t nodes[3];
+    err = com->isInsideBatch(rows, 3, mask, order, nodes);
+    assert(err == RC::SUCCESS);
+    assert(nodes[0] == 3 + 5 * 1 && nodes[1] == 2 + 5 * 3 && nodes[2] == com->getNodesCount());
+
+    ICompact *copy = com->clone();
+    double copy_coords[dim];
+    for (size_t node = 0; node < com->getNodesCount(); ++node) {
+        com->getNode(node, order, coords);
+        copy->getNode(node, order, copy_coords);
+        assert(coords[0] == copy_coords[0] && coords[1] == copy_coords[1]);
+    }
+
+    delete copy;
+    delete iter;
+    delete order;
+    delete com;
+    delete spec;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
+void CompactTest::testRefinement() {
+    CREATE_LOGGER
+    double left_data[] = {0, 0};
+    IVector *left = IVector::createVector(SIZEOF_ARR(left_data), left_data);
+    double right_data[] = {4, 7};
+    IVector *right = IVector::createVector(SIZEOF_ARR(right_data), right_data);
+    size_t grid_data[] = {5, 4};
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(SIZEOF_ARR(grid_data), grid_data);
+    IGridSpec *spec = IGridSpec::createGridSpec(grid);
+    spec->setAxis(1, IGridSpec::SPACING::GEOMETRIC, 4, 2);
+    ICompact *com = ICompact::createCompact(left, right, spec);
+
+    // refine sub-box between nodes (1, 1) and (3, 2): x in [1, 3], y in [1, 3]
+    size_t first_data[] = {1, 1}, last_data[] = {3, 2};
+    IMultiIndex *first = IMultiIndex::createMultiIndex(SIZEOF_ARR(first_data), first_data);
+    IMultiIndex *last = IMultiIndex::createMultiIndex(SIZEOF_ARR(last_data), last_data);
+    ICompact *fine = com->createRefinement(first, last);
+    assert(fine != nullptr);
+    assert(fine->getNodesCount() == 5 * 3);
+    assert(fine->getLeftBoundaryData()[1] == 1 && fine->getRightBoundaryData()[1] == 3);
+
+    size_t order_data[] = {0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    const size_t dim = SIZEOF_ARR(left_data);
+    size_t count = 0;
+    RC err = fine->generateRefinementNodes(order, nullptr, 0, count);
+    assert(err == RC::SUCCESS);
+    assert(count == 5 * 3 - 3 * 2);
+    std::vector<double> fresh(count * dim);
+    err = fine->generateRefinementNodes(order, fresh.data(), count, count);
+    assert(err == RC::SUCCESS);
+
+    // new nodes are exactly nodes of the refinement, which aren't nodes of the original grid
+    double expected[][2] = {{1.5, 1}, {2.5, 1}, {1, 2}, {1.5, 2}, {2, 2}, {2.5, 2}, {3, 2}, {1.5, 3}, {2.5, 3}};
+    assert(count == SIZEOF_ARR(expected));
+    for (size_t row = 0; row < count; ++row)
+        assert(fresh[row * dim] == expected[row][0] && fresh[row * dim + 1] == expected[row][1]);
+
+    size_t bad_data[] = {3, 4};
+    IMultiIndex *bad = IMultiIndex::createMultiIndex(SIZEOF_ARR(bad_data), bad_data);
+    assert(com->createRefinement(first, bad) == nullptr);
+
+    delete bad;
+    delete order;
+    delete fine;
+    delete last;
+    delete first;
+    delete com;
+    delete spec;
+    delete grid;
+    delete right;
+    delete left;
+    CLEAR_LOGGER
+}
+
 void CompactTest::testAll() {
     std::cout << "Running all Compact tests" << std::endl;
 
@@ -204,9 +788,19 @@ void CompactTest::testAll() {
     testGetVectorCoords();
     testGetVectorCopy();
     testIsInside();
+    testIsInsideBatch();
     testIntersection();
     testSpan();
+    testBatchIntersection();
     testIterator();
+    testIteratorNodes();
+    testGenerateNodes();
+    testParallelForEachNode();
+    testLinearIndex();
+    testTraversal();
+    testIteratorAllocations();
+    testNonUniformGrid();
+    testRefinement();
 
     std::cout << "Successfully ran all Compact tests" << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,472 @@
+#include "BinaryLog.h"
+#include "tests.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+const char *const LOG_FILE = "logger_test.log";
+
+std::vector<std::string> readLines(const char *filename) {
+    std::vector<std::string> lines;
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+    return lines;
+}
+
+// Counts records, which reached virtual log(), and records they stand for
+class CountingLogger : public ILogger {
+  public:
+    std::atomic<size_t> count;
+    std::atomic<size_t> repeats;
+
+    CountingLogger() : count(0), repeats(0) {}
+
+    RC log(RC code, Level level, const char *const &srcfile, const char *const &function, int line) override {
+        return logRepeated(code, level, srcfile, function, line, 1);
+    }
+    RC log(RC, Level) override {
+        ++count;
+        ++repeats;
+        return RC::SUCCESS;
+    }
+    RC logRepeated(RC, Level, const char *const &, const char *const &, int, size_t count) override {
+        ++this->count;
+        repeats += count;
+        return RC::SUCCESS;
+    }
+};
+
+// Checks that it's never called from two threads at once and that records come in order of phases (passed as line)
+class OrderCheckingLogger : public ILogger {
+  public:
+    std::atomic<bool> inside;
+    size_t count = 0;
+    int phase = 0;
+
+    OrderCheckingLogger() : inside(false) {}
+
+    RC log(RC, Level, const char *const &, const char *const &, int line) override {
+        assert(!inside.exchange(true));
+        assert(line >= phase);
+        phase = line;
+        ++count;
+        inside.store(false);
+        return RC::SUCCESS;
+    }
+    RC log(RC, Level) override { return RC::UNKNOWN; }
+};
+
+// Logs count records from each of threads threads, every record carries number of its thread as line
+void logFromThreads(ILogger *logger, size_t threads, size_t count) {
+    std::vector<std::thread> workers;
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.push_back(std::thread([=]() {
+            for (size_t idx = 0; idx < count; ++idx)
+                logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, (int)thread);
+        }));
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers[thread].join();
+}
+} // namespace
+
+void LoggerTest::testAsyncLogger() {
+    ILogger *logger = ILogger::createAsyncLogger(LOG_FILE);
+    assert(logger != nullptr);
+
+    logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    logger->info(RC::SUCCESS);
+    assert(logger->log(RC::UNKNOWN, ILogger::Level::INFO, nullptr, __func__, __LINE__) == RC::NULLPTR_ERROR);
+    assert(logger->flush() == RC::SUCCESS);
+
+    std::vector<std::string> lines = readLines(LOG_FILE);
+    assert(lines.size() == 3);
+    assert(lines[0].find("[SEVERE] Couldn't allocate more memory") != std::string::npos);
+    assert(lines[0].find(__FILE__) != std::string::npos);
+    assert(lines[1].find("[INFO] Successful") != std::string::npos);
+    assert(lines[2].find("[SEVERE] Received nullptr") != std::string::npos);
+
+    delete logger;
+    std::remove(LOG_FILE);
+
+    assert(ILogger::createAsyncLogger("missing_directory/logger_test.log") == nullptr);
+}
+
+void LoggerTest::testAsyncLoggerThreads() {
+    const size_t threads = 4, count = 5000;
+    ILogger *logger = ILogger::createAsyncLogger(LOG_FILE, true, 64, ILogger::Overflow::BLOCK);
+    logFromThreads(logger, threads, count);
+    delete logger;
+
+    // Nothing is lost with BLOCK policy
+    std::vector<std::string> lines = readLines(LOG_FILE);
+    assert(lines.size() == threads * count);
+    std::vector<size_t> per_thread(threads, 0);
+    for (size_t idx = 0; idx < lines.size(); ++idx) {
+        assert(lines[idx].find("[WARNING] Index out of bound") != std::string::npos);
+        size_t pos = lines[idx].rfind('[', lines[idx].find("] [WARNING]"));
+        ++per_thread[std::strtoul(lines[idx].c_str() + pos + 1, nullptr, 10)];
+    }
+    for (size_t thread = 0; thread < threads; ++thread)
+        assert(per_thread[thread] == count);
+    std::remove(LOG_FILE);
+}
+
+void LoggerTest::testAsyncLoggerOverflow() {
+    const size_t threads = 4, count = 5000;
+    ILogger *logger = ILogger::createAsyncLogger(LOG_FILE, true, 2, ILogger::Overflow::DROP);
+    logFromThreads(logger, threads, count);
+    delete logger;
+
+    // Every record is either written or counted in report about dropped ones
+    std::vector<std::string> lines = readLines(LOG_FILE);
+    size_t written = 0, dropped = 0;
+    for (size_t idx = 0; idx < lines.size(); ++idx) {
+        if (lines[idx].find("records were dropped") != std::string::npos)
+            dropped += std::strtoul(lines[idx].c_str() + std::strlen("[WARNING] "), nullptr, 10);
+        else
+            ++written;
+    }
+    assert(written + dropped == threads * count);
+    std::remove(LOG_FILE);
+}
+
+void LoggerTest::testLevelFilter() {
+    CountingLogger logger;
+    assert(logger.getLevel() == ILogger::Level::INFO);
+
+    logger.setLevel(ILogger::Level::WARNING);
+    assert(logger.isEnabled(ILogger::Level::SEVERE) && logger.isEnabled(ILogger::Level::WARNING));
+    assert(!logger.isEnabled(ILogger::Level::INFO));
+    logger.severe(RC::UNKNOWN);
+    logger.warning(RC::UNKNOWN, __FILE__, __func__, __LINE__);
+    logger.info(RC::UNKNOWN, __FILE__, __func__, __LINE__);
+    SendInfo(&logger, ILogger::Module::VECTOR, RC::UNKNOWN);
+    assert(logger.count == 2);
+
+    logger.setLevel(ILogger::Level::SEVERE);
+    SendWarning(&logger, ILogger::Module::VECTOR, RC::UNKNOWN);
+    SendSevere(&logger, ILogger::Module::VECTOR, RC::UNKNOWN);
+    assert(logger.count == 3);
+
+    // Records of unset logger are ignored
+    ILogger *unset = nullptr;
+    SendSevere(unset, ILogger::Module::SET, RC::UNKNOWN);
+}
+
+void LoggerTest::testModuleMask() {
+    CountingLogger logger;
+    logger.setModuleEnabled(ILogger::Module::COMPACT, false);
+    assert(!logger.isModuleEnabled(ILogger::Module::COMPACT));
+    assert(logger.isModuleEnabled(ILogger::Module::SET));
+
+    SendSevere(&logger, ILogger::Module::COMPACT, RC::UNKNOWN);
+    SendSevere(&logger, ILogger::Module::SET, RC::UNKNOWN);
+    assert(logger.count == 1);
+
+    // Disabled module of library doesn't reach logger
+    ILogger *compact_logger = ICompact::getLogger(), *set_logger = ISet::getLogger();
+    ICompact::setLogger(&logger);
+    ISet::setLogger(&logger);
+    ISet *set = ISet::createSet();
+    IVector *vec = nullptr;
+    IMultiIndex *grid = nullptr;
+    assert(set->getCopy(0, vec) != RC::SUCCESS);
+    assert(logger.count == 2);
+    assert(ICompact::createCompact(nullptr, nullptr, grid) == nullptr);
+    assert(logger.count == 2);
+
+    logger.setModuleEnabled(ILogger::Module::COMPACT, true);
+    assert(ICompact::createCompact(nullptr, nullptr, grid) == nullptr);
+    assert(logger.count == 3);
+    delete set;
+    ICompact::setLogger(compact_logger);
+    ISet::setLogger(set_logger);
+}
+
+void LoggerTest::testRateLimitedLogger() {
+    assert(ILogger::createRateLimitedLogger(nullptr) == nullptr);
+    CountingLogger counter;
+    assert(ILogger::createRateLimitedLogger(&counter, -1.0) == nullptr);
+    assert(ILogger::createRateLimitedLogger(&counter, 1e300) == nullptr);
+
+    ILogger *logger = ILogger::createRateLimitedLogger(&counter, 3600.0);
+    for (size_t idx = 0; idx < 1000; ++idx)
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    assert(counter.count == 1);
+    for (size_t idx = 0; idx < 10; ++idx) {
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    }
+    assert(counter.count == 3);
+
+    // Counts left are passed as one record per call site
+    assert(logger->flush() == RC::SUCCESS);
+    assert(counter.count == 6 && counter.repeats == 1020);
+    assert(logger->flush() == RC::SUCCESS);
+    assert(counter.count == 6);
+    delete logger;
+
+    counter.count = 0;
+    logger = ILogger::createRateLimitedLogger(&counter, 0);
+    for (size_t idx = 0; idx < 5; ++idx)
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    assert(counter.count == 5);
+    delete logger;
+
+    // Burst followed by silence is summarized by the next record of another call site after interval, or by flush()
+    counter.count = 0;
+    counter.repeats = 0;
+    logger = ILogger::createRateLimitedLogger(&counter, 0.05);
+    auto burst = [&](size_t count) {
+        for (size_t idx = 0; idx < count; ++idx)
+            logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    };
+    burst(10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    assert(counter.count == 1);
+    logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    assert(counter.count == 3 && counter.repeats == 11);
+    burst(5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    assert(counter.count == 3);
+    assert(logger->flush() == RC::SUCCESS);
+    assert(counter.count == 4 && counter.repeats == 16);
+    delete logger;
+
+    // Summary of synchronous logger
+    ILogger *file_logger = ILogger::createLogger(LOG_FILE);
+    logger = ILogger::createRateLimitedLogger(file_logger, 3600.0);
+    for (size_t idx = 0; idx < 3; ++idx)
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    delete logger;
+    delete file_logger;
+    std::vector<std::string> lines = readLines(LOG_FILE);
+    assert(lines.size() == 2);
+    assert(lines[1].find("Index out of bound (repeated 2 times)") != std::string::npos);
+    std::remove(LOG_FILE);
+}
+
+void LoggerTest::testRateLimitedLoggerThreads() {
+    const size_t threads = 4, count = 10000;
+    const double intervals[] = {3600.0, 1e-6};
+    for (size_t kind = 0; kind < SIZEOF_ARR(intervals); ++kind) {
+        CountingLogger counter;
+        ILogger *logger = ILogger::createRateLimitedLogger(&counter, intervals[kind]);
+        logFromThreads(logger, threads, count);
+        delete logger;
+        assert(counter.repeats == threads * count);
+        assert(counter.count <= threads * count);
+    }
+}
+
+void LoggerTest::testBinaryLogger() {
+    assert(ILogger::createBinaryLogger("missing_directory/logger_test.log") == nullptr);
+
+    const size_t count = 100;
+    ILogger *logger = ILogger::createBinaryLogger(LOG_FILE);
+    for (size_t idx = 0; idx < count; ++idx)
+        logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, (int)idx);
+    logger->info(RC::SUCCESS);
+    logger->logRepeated(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __func__, -1, 42);
+    assert(logger->flush() == RC::SUCCESS);
+    delete logger;
+    // Appended log has its own header and string table
+    logger = ILogger::createBinaryLogger(LOG_FILE, false);
+    logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+    delete logger;
+
+    // srcfile and function are written once, records have fixed width
+    std::ifstream file(LOG_FILE, std::ios::binary | std::ios::ate);
+    const size_t strings = 2 * BinaryLog::STRING_HEADER_SIZE + std::strlen(__FILE__) + std::strlen(__func__);
+    assert((size_t)file.tellg() == 2 * BinaryLog::HEADER_SIZE + 2 * strings + (count + 3) * BinaryLog::RECORD_SIZE);
+
+    BinaryLog::Reader reader;
+    assert(reader.open(LOG_FILE) == RC::SUCCESS);
+    BinaryLog::Record record;
+    uint64_t previous = reader.getHeader().start_time;
+    for (size_t idx = 0; idx < count; ++idx) {
+        assert(reader.next(record) == RC::SUCCESS);
+        assert(record.code == RC::INDEX_OUT_OF_BOUND && record.level == ILogger::Level::WARNING);
+        assert(record.line == (int)idx && record.repeats == 1);
+        assert(reader.getString(record.srcfile) == __FILE__ && reader.getString(record.function) == __func__);
+        assert(record.time >= previous);
+        previous = record.time;
+    }
+    assert(reader.next(record) == RC::SUCCESS);
+    assert(record.code == RC::SUCCESS && record.level == ILogger::Level::INFO && record.srcfile == 0);
+    assert(reader.next(record) == RC::SUCCESS);
+    assert(record.code == RC::NOT_NUMBER && record.line == -1 && record.repeats == 42);
+    assert(reader.next(record) == RC::SUCCESS);
+    assert(record.code == RC::ALLOCATION_ERROR && reader.getString(record.function) == __func__);
+    assert(reader.next(record) == RC::INDEX_OUT_OF_BOUND);
+    std::remove(LOG_FILE);
+
+    // Text log isn't binary one
+    ILogger *text = ILogger::createLogger(LOG_FILE);
+    text->severe(RC::UNKNOWN);
+    delete text;
+    BinaryLog::Reader text_reader;
+    assert(text_reader.open(LOG_FILE) == RC::INVALID_ARGUMENT);
+    std::remove(LOG_FILE);
+
+    // Buffer of caller reused for another text is interned anew
+    char srcfile[] = "first.cpp";
+    logger = ILogger::createBinaryLogger(LOG_FILE);
+    logger->warning(RC::UNKNOWN, srcfile, __func__, 1);
+    std::strcpy(srcfile, "other.cpp");
+    logger->warning(RC::UNKNOWN, srcfile, __func__, 2);
+    delete logger;
+    BinaryLog::Reader reused;
+    assert(reused.open(LOG_FILE) == RC::SUCCESS);
+    assert(reused.next(record) == RC::SUCCESS && reused.getString(record.srcfile) == "first.cpp");
+    assert(reused.next(record) == RC::SUCCESS && reused.getString(record.srcfile) == "other.cpp");
+    std::remove(LOG_FILE);
+}
+
+void LoggerTest::testThreadSafeLogger() {
+    CountingLogger counter;
+    assert(ILogger::createThreadSafeLogger(nullptr) == nullptr);
+    assert(ILogger::createThreadSafeLogger(&counter, 0) == nullptr);
+
+    ILogger *logger = ILogger::createThreadSafeLogger(&counter, 100);
+    for (size_t idx = 0; idx < 10; ++idx)
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    logger->logRepeated(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __func__, __LINE__, 5);
+    logger->info(RC::SUCCESS);
+    assert(counter.count == 0);
+    assert(logger->flush() == RC::SUCCESS);
+    assert(counter.count == 12 && counter.repeats == 16);
+
+    // Full buffer is written at once
+    for (size_t idx = 0; idx < 100; ++idx)
+        logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    assert(counter.count == 112);
+    logger->severe(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+    delete logger;
+    assert(counter.count == 113);
+}
+
+void LoggerTest::testThreadSafeLoggerStress() {
+    // Threads log in phases separated by barrier, so records of a phase are older than records of the next one and
+    // have to be written before them
+    const size_t threads = 8, phases = 20, count = 50;
+    OrderCheckingLogger checker;
+    ILogger *logger = ILogger::createThreadSafeLogger(&checker, 16);
+    std::atomic<size_t> arrived(0);
+    std::vector<std::thread> workers;
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.push_back(std::thread([&]() {
+            for (size_t phase = 0; phase < phases; ++phase) {
+                for (size_t idx = 0; idx < count; ++idx)
+                    logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, (int)phase);
+                if (phase % 4 == 3)
+                    logger->flush();
+                ++arrived;
+                while (arrived.load() < (phase + 1) * threads)
+                    std::this_thread::yield();
+            }
+        }));
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers[thread].join();
+    delete logger;
+    assert(checker.count == threads * phases * count);
+}
+
+void LoggerTest::testThreadSafeLoggerThreadExit() {
+    // Exited threads give their buffers with records left to the next ones, records are written by flush()
+    const size_t rounds = 50, threads = 4, count = 3;
+    CountingLogger counter;
+    ILogger *logger = ILogger::createThreadSafeLogger(&counter, 100);
+    for (size_t round = 0; round < rounds; ++round) {
+        std::vector<std::thread> workers;
+        for (size_t thread = 0; thread < threads; ++thread)
+            workers.push_back(std::thread([&]() {
+                for (size_t idx = 0; idx < count; ++idx)
+                    logger->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+            }));
+        for (size_t thread = 0; thread < threads; ++thread)
+            workers[thread].join();
+    }
+    assert(logger->flush() == RC::SUCCESS);
+    assert(counter.count == rounds * threads * count);
+
+    // Thread may outlive logger it used
+    ILogger *short_lived = ILogger::createThreadSafeLogger(&counter, 100);
+    std::atomic<bool> logged(false), deleted(false);
+    std::thread worker([&]() {
+        short_lived->warning(RC::INDEX_OUT_OF_BOUND, __FILE__, __func__, __LINE__);
+        logged = true;
+        while (!deleted.load())
+            std::this_thread::yield();
+    });
+    while (!logged.load())
+        std::this_thread::yield();
+    delete short_lived;
+    deleted = true;
+    worker.join();
+    assert(counter.count == rounds * threads * count + 1);
+    delete logger;
+}
+
+void LoggerTest::testSetLoggerThreads() {
+    // Loggers are replaced while other threads log through them
+    CountingLogger first, second;
+    ILogger *loggers[] = {ILogger::createThreadSafeLogger(&first), ILogger::createThreadSafeLogger(&second)};
+    const size_t threads = 4, count = 2000;
+    ILogger *compact_logger = ICompact::getLogger(), *vector_logger = IVector::getLogger();
+    ICompact::setLogger(loggers[0]);
+    IVector::setLogger(loggers[0]);
+    std::vector<std::thread> workers;
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.push_back(std::thread([&, thread]() {
+            IMultiIndex *grid = nullptr;
+            for (size_t idx = 0; idx < count; ++idx) {
+                if (thread == 0) {
+                    ICompact::setLogger(loggers[idx % 2]);
+                    IVector::setLogger(loggers[idx % 2]);
+                } else {
+                    assert(ICompact::createCompact(nullptr, nullptr, grid) == nullptr);
+                    assert(IVector::createVector(1, nullptr) == nullptr);
+                }
+            }
+        }));
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers[thread].join();
+    loggers[0]->flush();
+    loggers[1]->flush();
+    assert(first.count + second.count == 2 * (threads - 1) * count);
+    ICompact::setLogger(compact_logger);
+    IVector::setLogger(vector_logger);
+    delete loggers[0];
+    delete loggers[1];
+}
+
+void LoggerTest::testAll() {
+    std::cout << "Running all Logger tests" << std::endl;
+
+    testAsyncLogger();
+    testAsyncLoggerThreads();
+    testAsyncLoggerOverflow();
+    testLevelFilter();
+    testModuleMask();
+    testRateLimitedLogger();
+    testRateLimitedLoggerThreads();
+    testBinaryLogger();
+    testThreadSafeLogger();
+    testThreadSafeLoggerStress();
+    testThreadSafeLoggerThreadExit();
+    testSetLoggerThreads();
+
+    std::cout << "Successfully ran all Logger tests" << std::endl;
+}
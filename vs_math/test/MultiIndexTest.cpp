@@ -1,3 +1,4 @@
+#include "SmallMultiIndex.h"
 #include "tests.hpp"
 #include <cassert>
 #include <iostream>
@@ -97,6 +98,48 @@ void MultiIndexTest::testGetDim() {
     CLEAR_INDEX_ONE
 }
 
+void MultiIndexTest::testSmallMultiIndex() {
+    CREATE_LOGGER
+    CREATE_INDEX_ONE
+
+    SmallMultiIndex small(index1);
+    assert(small.getDim() == index1->getDim());
+    for (size_t idx = 0; idx < small.getDim(); ++idx)
+        assert(small[idx] == idata1[idx]);
+    small[0] = 0;
+    assert(small.copyTo(index1) == RC::SUCCESS);
+    assert(index1->getData()[0] == 0);
+    IMultiIndex *back = small.toMultiIndex();
+    assert(back != nullptr && back->getData()[1] == idata1[1]);
+    delete back;
+
+    // odometer over 2 x 3 grid, axis 1 is the fastest one
+    size_t limits[] = {2, 3}, order[] = {1, 0};
+    SmallMultiIndex pos(2, 0);
+    size_t expected[][2] = {{0, 1}, {0, 2}, {1, 0}, {1, 1}, {1, 2}};
+    size_t changed[] = {1, 1, 2, 1, 1};
+    for (size_t step = 0; step < SIZEOF_ARR(expected); ++step) {
+        assert(pos.increment(order, limits) == changed[step]);
+        assert(pos[0] == expected[step][0] && pos[1] == expected[step][1]);
+    }
+    assert(pos.increment(order, limits) == 0);
+    assert(pos[0] == 0 && pos[1] == 0);
+
+    // more than INLINE_DIM axes are stored on heap, copies are independent
+    size_t wide_data[SmallMultiIndex::INLINE_DIM + 3];
+    for (size_t idx = 0; idx < SIZEOF_ARR(wide_data); ++idx)
+        wide_data[idx] = idx;
+    SmallMultiIndex wide = SmallMultiIndex::fromData(SIZEOF_ARR(wide_data), wide_data);
+    SmallMultiIndex copy(wide);
+    copy[0] = 42;
+    assert(wide[0] == 0 && copy[0] == 42 && copy[SIZEOF_ARR(wide_data) - 1] == SIZEOF_ARR(wide_data) - 1);
+    copy = small;
+    assert(copy.getDim() == small.getDim() && copy[1] == idata1[1]);
+
+    CLEAR_LOGGER
+    CLEAR_INDEX_ONE
+}
+
 void MultiIndexTest::testAll() {
     std::cout << "Running all MultiIndex tests" << std::endl;
 
@@ -108,6 +151,7 @@ void MultiIndexTest::testAll() {
     testSetData();
     testSetAxisIndex();
     testIncAxisIndex();
+    testSmallMultiIndex();
 
     std::cout << "Successfully ran all MultiIndex tests" << std::endl;
 }
\ No newline at end of file
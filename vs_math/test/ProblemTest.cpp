@@ -0,0 +1,346 @@
+#include "AutoDiff.h"
+#include "ProblemKernel.h"
+#include "tests.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+// f(x, p) = p0 * x0^2 * x1 + p1 * sin(x1), args in [-2, 2]^2, params in [0, 5]^2
+double mixed(double const *x, double const *p) { return p[0] * x[0] * x[0] * x[1] + p[1] * std::sin(x[1]); }
+
+// The same function for any type of numbers
+struct Mixed {
+    template <class T>
+    T operator()(T const *x, T const *p) const {
+        return p[0] * x[0] * x[0] * x[1] + p[1] * AutoDiff::sin(x[1]);
+    }
+};
+
+// Elementary functions of args, one of them is selected by term
+struct Elementary {
+    int term;
+
+    template <class T>
+    T operator()(T const *x, T const *) const {
+        switch (term) {
+        case 0:
+            return AutoDiff::exp(x[0] * x[1]);
+        case 1:
+            return AutoDiff::log(x[0]) + AutoDiff::sqrt(x[1]);
+        case 2:
+            return AutoDiff::pow(x[0], 2.5) / x[1];
+        default:
+            return AutoDiff::cos(x[0]) * AutoDiff::fabs(x[1] - 3);
+        }
+    }
+};
+} // namespace
+
+void ProblemTest::testCreate() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    auto f = [](double const *x, double const *p) { return mixed(x, p); };
+
+    IProblem *problem = IProblem::createProblem(params, args, ProblemKernel::make(f));
+    assert(problem != nullptr);
+    assert(problem->getArgsDim() == 2 && problem->getParamsDim() == 2);
+    IProblem::Kernel empty = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+    assert(IProblem::createProblem(params, args, empty) == nullptr);
+    assert(IProblem::createProblem(params, nullptr, ProblemKernel::make(f)) == nullptr);
+
+    // Function without params
+    IProblem *plain = IProblem::createProblem(nullptr, args, ProblemKernel::make(f));
+    assert(plain != nullptr && plain->getParamsDim() == 0);
+
+    IProblem *copy = problem->clone();
+    assert(copy != nullptr && copy->getArgsDim() == 2);
+
+    delete copy;
+    delete plain;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testEval() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    auto f = [](double const *x, double const *p) { return mixed(x, p); };
+    IProblem *problem = IProblem::createProblem(params, args, ProblemKernel::make(f));
+
+    double x_data[] = {1.5, -0.5}, p_data[] = {2, 3}, outside_data[] = {6, 0};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    IVector *outside = IVector::createVector(SIZEOF_ARR(outside_data), outside_data);
+    CREATE_VEC_THREE
+
+    // Params aren't set yet
+    assert(std::isnan(problem->evalByArgs(x)));
+    assert(problem->isValidArgs(x) && !problem->isValidArgs(outside) && !problem->isValidArgs(vec3));
+    assert(problem->isValidParams(p) && !problem->isValidParams(vec3));
+    assert(problem->setParams(outside) == RC::INVALID_ARGUMENT);
+    assert(problem->setParams(vec3) == RC::MISMATCHING_DIMENSIONS);
+    assert(problem->setParams(p) == RC::SUCCESS);
+    assert(std::fabs(problem->evalByArgs(x) - mixed(x_data, p_data)) < TOLERANCE);
+    assert(std::isnan(problem->evalByArgs(vec3)));
+
+    assert(std::isnan(problem->evalByParams(p)));
+    assert(problem->setArgs(x) == RC::SUCCESS);
+    assert(std::fabs(problem->evalByParams(p) - mixed(x_data, p_data)) < TOLERANCE);
+
+    // Clone keeps fixed values
+    IProblem *copy = problem->clone();
+    assert(std::fabs(copy->evalByArgs(x) - mixed(x_data, p_data)) < TOLERANCE);
+    assert(std::fabs(copy->evalByParams(p) - mixed(x_data, p_data)) < TOLERANCE);
+
+    delete copy;
+    CLEAR_VEC_THREE
+    delete outside;
+    delete p;
+    delete x;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testBatch() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    auto f = [](double const *x, double const *p) { return mixed(x, p); };
+    IProblem::Kernel batched = ProblemKernel::make(f);
+    IProblem::Kernel scalar = batched;
+    scalar.evalBatch = nullptr;
+    IProblem *problem = IProblem::createProblem(params, args, batched);
+    IProblem *per_row = IProblem::createProblem(params, args, scalar);
+    double p_data[] = {2, 3};
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    problem->setParams(p);
+    per_row->setParams(p);
+
+    // Enough rows for several tiles and threads, the last tile is partial
+    const size_t n = 50000;
+    std::vector<double> rows(2 * n), out(n), out_per_row(n);
+    for (size_t idx = 0; idx < rows.size(); ++idx)
+        rows[idx] = -2.0 + 4.0 * (double)((idx * 7919) % 1000) / 1000.0;
+    for (size_t threads = 0; threads <= 3; ++threads) {
+        problem->setThreads(threads);
+        assert(problem->evalByArgsBatch(rows.data(), n, out.data()) == RC::SUCCESS);
+        for (size_t row = 0; row < n; ++row)
+            assert(out[row] == mixed(rows.data() + 2 * row, p_data));
+    }
+    assert(per_row->evalByArgsBatch(rows.data(), n, out_per_row.data()) == RC::SUCCESS);
+    assert(out == out_per_row);
+
+    // By params with fixed args
+    double x_data[] = {1, 2};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    assert(problem->evalByParamsBatch(rows.data(), n, out.data()) == RC::NO_ARGS_SET);
+    problem->setArgs(x);
+    assert(problem->evalByParamsBatch(rows.data(), n, out.data()) == RC::SUCCESS);
+    for (size_t row = 0; row < n; row += 97)
+        assert(out[row] == mixed(x_data, rows.data() + 2 * row));
+
+    assert(problem->evalByArgsBatch(nullptr, 1, out.data()) == RC::NULLPTR_ERROR);
+    assert(problem->evalByArgsBatch(nullptr, 0, nullptr) == RC::SUCCESS);
+
+    delete x;
+    delete p;
+    delete per_row;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testGradient() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    auto f = [](double const *x, double const *p) { return mixed(x, p); };
+    auto grad = [](double const *x, double const *p, double *g) {
+        g[0] = 2 * p[0] * x[0] * x[1];
+        g[1] = p[0] * x[0] * x[0] + p[1] * std::cos(x[1]);
+    };
+    auto exact = ProblemKernel::withGradient(f, grad);
+    IDiffProblem *with_gradient = IDiffProblem::createDiffProblem(params, args, exact.kernel());
+    IDiffProblem *differences = IDiffProblem::createDiffProblem(params, args, ProblemKernel::make(f));
+
+    double x_data[] = {1.5, -0.5}, p_data[] = {2, 3};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    IVector *val = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    double expected[2];
+    grad(x_data, p_data, expected);
+
+    assert(with_gradient->evalGradientByArgs(x, val) == RC::NO_PARAMS_SET);
+    with_gradient->setParams(p);
+    differences->setParams(p);
+    assert(with_gradient->evalGradientByArgs(x, val) == RC::SUCCESS);
+    assert(val->getData()[0] == expected[0] && val->getData()[1] == expected[1]);
+    assert(differences->evalGradientByArgs(x, val) == RC::SUCCESS);
+    assert(std::fabs(val->getData()[0] - expected[0]) < TOLERANCE);
+    assert(std::fabs(val->getData()[1] - expected[1]) < TOLERANCE);
+
+    // By params: df/dp = (x0^2 * x1, sin(x1))
+    differences->setArgs(x);
+    assert(differences->evalGradientByParams(p, val) == RC::SUCCESS);
+    assert(std::fabs(val->getData()[0] - x_data[0] * x_data[0] * x_data[1]) < TOLERANCE);
+    assert(std::fabs(val->getData()[1] - std::sin(x_data[1])) < TOLERANCE);
+
+    CREATE_VEC_THREE
+    assert(differences->evalGradientByArgs(x, vec3) == RC::MISMATCHING_DIMENSIONS);
+
+    CLEAR_VEC_THREE
+    delete val;
+    delete p;
+    delete x;
+    delete differences;
+    delete with_gradient;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testDerivative() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    auto f = [](double const *x, double const *p) { return mixed(x, p); };
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, ProblemKernel::make(f));
+    double x_data[] = {1.5, -0.5}, p_data[] = {2, 3};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    problem->setParams(p);
+
+    const struct {
+        size_t orders[2];
+        double expected;
+        double tol;
+    } cases[] = {
+        {{0, 0}, mixed(x_data, p_data), 1e-12},
+        {{1, 0}, 2 * p_data[0] * x_data[0] * x_data[1], 1e-6},
+        {{2, 0}, 2 * p_data[0] * x_data[1], 1e-4},
+        {{1, 1}, 2 * p_data[0] * x_data[0], 1e-4},
+        {{2, 1}, 2 * p_data[0], 1e-3},
+        {{0, 3}, -p_data[1] * std::cos(x_data[1]), 1e-2},
+    };
+    for (size_t idx = 0; idx < SIZEOF_ARR(cases); ++idx) {
+        IMultiIndex *index = IMultiIndex::createMultiIndex(2, cases[idx].orders);
+        assert(std::fabs(problem->evalDerivativeByArgs(x, index) - cases[idx].expected) < cases[idx].tol);
+        delete index;
+    }
+
+    // Too high order for finite differences and wrong dimension of index
+    size_t high_data[] = {3, 2}, wrong_data[] = {1, 0, 0};
+    IMultiIndex *high = IMultiIndex::createMultiIndex(SIZEOF_ARR(high_data), high_data);
+    IMultiIndex *wrong = IMultiIndex::createMultiIndex(SIZEOF_ARR(wrong_data), wrong_data);
+    assert(std::isnan(problem->evalDerivativeByArgs(x, high)));
+    assert(std::isnan(problem->evalDerivativeByArgs(x, wrong)));
+
+    delete wrong;
+    delete high;
+    delete p;
+    delete x;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testAutoDiff() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 5, 5);
+    Mixed f;
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, AutoDiff::kernel(f));
+    double x_data[] = {1.5, -0.5}, p_data[] = {2, 3};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    IVector *val = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    problem->setParams(p);
+    problem->setArgs(x);
+
+    // Values and gradients by reverse mode
+    assert(problem->evalByArgs(x) == mixed(x_data, p_data));
+    assert(problem->evalGradientByArgs(x, val) == RC::SUCCESS);
+    assert(std::fabs(val->getData()[0] - 2 * p_data[0] * x_data[0] * x_data[1]) < 1e-14);
+    assert(std::fabs(val->getData()[1] - (p_data[0] * x_data[0] * x_data[0] + p_data[1] * std::cos(x_data[1]))) <
+           1e-14);
+    assert(problem->evalGradientByParams(p, val) == RC::SUCCESS);
+    assert(std::fabs(val->getData()[0] - x_data[0] * x_data[0] * x_data[1]) < 1e-14);
+    assert(std::fabs(val->getData()[1] - std::sin(x_data[1])) < 1e-14);
+
+    // Mixed derivatives by forward mode, orders above finite differences too
+    const struct {
+        size_t orders[2];
+        double expected;
+    } cases[] = {
+        {{1, 0}, 2 * p_data[0] * x_data[0] * x_data[1]},
+        {{2, 1}, 2 * p_data[0]},
+        {{0, 3}, -p_data[1] * std::cos(x_data[1])},
+        {{0, 6}, -p_data[1] * std::sin(x_data[1])},
+        {{3, 2}, 0},
+    };
+    for (size_t idx = 0; idx < SIZEOF_ARR(cases); ++idx) {
+        IMultiIndex *index = IMultiIndex::createMultiIndex(2, cases[idx].orders);
+        assert(std::fabs(problem->evalDerivativeByArgs(x, index) - cases[idx].expected) < 1e-12);
+        delete index;
+    }
+    size_t by_params_data[] = {0, 1}, large_data[] = {10, 10};
+    IMultiIndex *by_params = IMultiIndex::createMultiIndex(SIZEOF_ARR(by_params_data), by_params_data);
+    IMultiIndex *large = IMultiIndex::createMultiIndex(SIZEOF_ARR(large_data), large_data);
+    assert(std::fabs(problem->evalDerivativeByParams(p, by_params) - std::sin(x_data[1])) < 1e-14);
+    // More coefficients than Jet holds
+    assert(std::isnan(problem->evalDerivativeByArgs(x, large)));
+
+    // Elementary functions at (a, b): orders and expected derivatives for every term
+    const double a = 1.3, b = 0.7, c = std::cos(a);
+    const struct {
+        int term;
+        size_t orders[2];
+        double expected;
+    } elementary[] = {
+        {0, {1, 1}, std::exp(a * b) * (1 + a * b)},
+        {0, {2, 2}, std::exp(a * b) * (2 + 4 * a * b + a * a * b * b)},
+        {1, {2, 0}, -1 / (a * a)},
+        {1, {0, 3}, 0.375 * std::pow(b, -2.5)},
+        {2, {3, 1}, -2.5 * 1.5 * 0.5 * std::pow(a, -0.5) / (b * b)},
+        {3, {4, 1}, -c},
+    };
+    double point_data[] = {a, b};
+    IVector *point = IVector::createVector(SIZEOF_ARR(point_data), point_data);
+    for (size_t idx = 0; idx < SIZEOF_ARR(elementary); ++idx) {
+        Elementary g = {elementary[idx].term};
+        IDiffProblem *term = IDiffProblem::createDiffProblem(nullptr, args, AutoDiff::kernel(g));
+        IMultiIndex *index = IMultiIndex::createMultiIndex(2, elementary[idx].orders);
+        const double derivative = term->evalDerivativeByArgs(point, index);
+        assert(std::fabs(derivative - elementary[idx].expected) < 1e-12 * std::max(1.0, std::fabs(derivative)));
+        delete index;
+        delete term;
+    }
+
+    delete point;
+    delete large;
+    delete by_params;
+    delete val;
+    delete p;
+    delete x;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void ProblemTest::testAll() {
+    std::cout << "Running all Problem tests" << std::endl;
+
+    testCreate();
+    testEval();
+    testBatch();
+    testGradient();
+    testDerivative();
+    testAutoDiff();
+
+    std::cout << "Successfully ran all Problem tests" << std::endl;
+}
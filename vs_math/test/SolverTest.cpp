@@ -0,0 +1,381 @@
+#include "ISolver.h"
+#include "ProblemKernel.h"
+#include "tests.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace {
+// Rosenbrock function with params (a, b): (a - x0)^2 + b * (x1 - x0^2)^2, minimum at (a, a^2)
+double rosenbrock(double const *x, double const *p) {
+    return (p[0] - x[0]) * (p[0] - x[0]) + p[1] * (x[1] - x[0] * x[0]) * (x[1] - x[0] * x[0]);
+}
+void rosenbrockGradient(double const *x, double const *p, double *g) {
+    g[0] = -2 * (p[0] - x[0]) - 4 * p[1] * x[0] * (x[1] - x[0] * x[0]);
+    g[1] = 2 * p[1] * (x[1] - x[0] * x[0]);
+}
+
+// Solves from init and checks solution against expected
+void checkSolve(ISolver *solver, double const *init, double const *expected, double tol) {
+    IVector *start = IVector::createVector(2, init);
+    assert(solver->solveByArgs(start, nullptr) == RC::SUCCESS);
+    IVector *solution = nullptr;
+    assert(solver->getSolution(solution) == RC::SUCCESS);
+    assert(std::fabs(solution->getData()[0] - expected[0]) < tol);
+    assert(std::fabs(solution->getData()[1] - expected[1]) < tol);
+    assert(solver->getSummary().converged);
+    delete solution;
+    delete start;
+}
+} // namespace
+
+void SolverTest::testCreate() {
+    CREATE_LOGGER
+    ISolver::Options options;
+    options.history = 0;
+    assert(ISolver::createSolver(options) == nullptr);
+    options.method = ISolver::Method::BFGS;
+    ISolver *solver = ISolver::createSolver(options);
+    assert(solver != nullptr);
+
+    ICompact *args = createBox(2, -2, 2, 5);
+    auto f = [](double const *x, double const *p) { return rosenbrock(x, p); };
+    IProblem *plain = IProblem::createProblem(nullptr, args, ProblemKernel::make(f));
+    double init_data[] = {0, 0};
+    IVector *init = IVector::createVector(SIZEOF_ARR(init_data), init_data);
+    assert(solver->setProblem(nullptr) == RC::NULLPTR_ERROR);
+    assert(solver->solveByArgs(init, nullptr) == RC::NO_PROBLEM_SET);
+    IVector *solution = nullptr;
+    assert(solver->getSolution(solution) == RC::NO_ARGS_SET);
+    // Problems of createProblem() are differentiable
+    assert(solver->setProblem(plain) == RC::SUCCESS);
+
+    ISolver *copy = solver->clone();
+    assert(copy != nullptr);
+
+    delete copy;
+    delete init;
+    delete plain;
+    delete args;
+    delete solver;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testMethods() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 200, 5);
+    auto f = [](double const *x, double const *p) { return rosenbrock(x, p); };
+    auto exact = ProblemKernel::withGradient(f, rosenbrockGradient);
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, exact.kernel());
+    IDiffProblem *differences = IDiffProblem::createDiffProblem(params, args, ProblemKernel::make(f));
+    double p_data[] = {1, 100};
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    problem->setParams(p);
+    differences->setParams(p);
+
+    const ISolver::Method methods[] = {ISolver::Method::GRADIENT_DESCENT, ISolver::Method::BFGS,
+                                       ISolver::Method::LBFGS};
+    const ISolver::LineSearch searches[] = {ISolver::LineSearch::ARMIJO, ISolver::LineSearch::WOLFE};
+    double init[] = {-1.2, 1}, expected[] = {1, 1};
+    for (size_t method = 0; method < SIZEOF_ARR(methods); ++method) {
+        for (size_t search = 0; search < SIZEOF_ARR(searches); ++search) {
+            ISolver::Options options;
+            options.method = methods[method];
+            options.lineSearch = searches[search];
+            options.maxIterations = methods[method] == ISolver::Method::GRADIENT_DESCENT ? 100000 : 500;
+            options.gradientTolerance = 1e-9;
+            ISolver *solver = ISolver::createSolver(options);
+            assert(solver->setProblem(problem) == RC::SUCCESS);
+            checkSolve(solver, init, expected, methods[method] == ISolver::Method::GRADIENT_DESCENT ? 1e-3 : 1e-6);
+            if (methods[method] != ISolver::Method::GRADIENT_DESCENT)
+                assert(solver->getSummary().iterations < 100);
+            assert(std::fabs(solver->getSummary().value) < 1e-8);
+
+            // Finite differences are accurate enough for quasi-Newton methods
+            if (methods[method] != ISolver::Method::GRADIENT_DESCENT) {
+                assert(solver->setProblem(differences) == RC::SUCCESS);
+                checkSolve(solver, init, expected, 1e-4);
+            }
+            delete solver;
+        }
+    }
+
+    delete p;
+    delete differences;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testDomain() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5), *params = createBox(2, 0, 200, 5);
+    auto f = [](double const *x, double const *p) { return rosenbrock(x, p); };
+    auto exact = ProblemKernel::withGradient(f, rosenbrockGradient);
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, exact.kernel());
+    double p_data[] = {1, 100};
+    IVector *p = IVector::createVector(SIZEOF_ARR(p_data), p_data);
+    problem->setParams(p);
+    ISolver *solver = ISolver::createSolver();
+    assert(solver->setProblem(problem) == RC::SUCCESS);
+
+    // Minimum (1, 1) is cut off by box, constrained minimum lies on its side x0 = 0.5
+    double box_left[] = {-2, -2}, box_right[] = {0.5, 2};
+    ICompact *box = createBox(2, box_left, box_right, 5), *wrong = createBox(2, 0, 1, 5);
+    CREATE_VEC_THREE
+    assert(solver->setArgsDomain(nullptr) == RC::NULLPTR_ERROR);
+    assert(solver->isValidArgsDomain(box) && !solver->isValidParamsDomain(nullptr));
+    assert(solver->setArgsDomain(box) == RC::SUCCESS);
+    double init[] = {-1.2, 1}, expected[] = {0.5, 0.25};
+    checkSolve(solver, init, expected, 1e-6);
+
+    // Starting point outside is projected onto box
+    double outside[] = {3, -3};
+    checkSolve(solver, outside, expected, 1e-6);
+    assert(solver->solveByArgs(vec3, nullptr) == RC::MISMATCHING_DIMENSIONS);
+
+    // Overrides of options: one iteration isn't enough
+    double overrides_data[] = {1, 1e-9};
+    IVector *overrides = IVector::createVector(SIZEOF_ARR(overrides_data), overrides_data);
+    IVector *start = IVector::createVector(SIZEOF_ARR(init), init);
+    assert(solver->solveByArgs(start, &overrides) == RC::SUCCESS);
+    assert(solver->getSummary().iterations == 1 && !solver->getSummary().converged);
+
+    // Clone keeps problem and domain
+    ISolver *copy = solver->clone();
+    checkSolve(copy, init, expected, 1e-6);
+
+    delete copy;
+    delete start;
+    delete overrides;
+    CLEAR_VEC_THREE
+    delete wrong;
+    delete box;
+    delete solver;
+    delete p;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testByParams() {
+    CREATE_LOGGER
+    // Least squares fit of line p0 * x + p1 to points (x0, x1) = (1, 3), (2, 5): params are (2, 1)
+    ICompact *args = createBox(2, -10, 10, 5), *params = createBox(2, -10, 10, 5);
+    auto f = [](double const *x, double const *p) {
+        const double r0 = p[0] * x[0] + p[1] - x[1], r1 = p[0] * 2 * x[0] + p[1] - (2 * x[1] - 1);
+        return r0 * r0 + r1 * r1;
+    };
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(params, args, ProblemKernel::make(f));
+    double x_data[] = {1, 3};
+    IVector *x = IVector::createVector(SIZEOF_ARR(x_data), x_data);
+    ISolver *solver = ISolver::createSolver();
+    assert(solver->setProblem(problem) == RC::SUCCESS);
+
+    // Args of problem aren't set
+    double init_data[] = {0, 0};
+    IVector *init = IVector::createVector(SIZEOF_ARR(init_data), init_data);
+    assert(solver->solveByParams(init, nullptr) == RC::NO_ARGS_SET);
+
+    problem->setArgs(x);
+    assert(solver->setProblem(problem) == RC::SUCCESS);
+    assert(solver->setParamsDomain(params) == RC::SUCCESS);
+    assert(solver->solveByParams(init, nullptr) == RC::SUCCESS);
+    IVector *solution = nullptr;
+    assert(solver->getSolution(solution) == RC::SUCCESS);
+    assert(std::fabs(solution->getData()[0] - 2) < TOLERANCE && std::fabs(solution->getData()[1] - 1) < TOLERANCE);
+
+    delete solution;
+    delete init;
+    delete solver;
+    delete x;
+    delete problem;
+    delete args;
+    delete params;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testGlobal() {
+    CREATE_LOGGER
+    // Four minima near (+-1, +-1), tilted so the one near (-1, -1) is the lowest
+    ICompact *args = createBox(2, -2, 2, 5);
+    auto f = [](double const *x, double const *) {
+        return (x[0] * x[0] - 1) * (x[0] * x[0] - 1) + (x[1] * x[1] - 1) * (x[1] * x[1] - 1) + 0.1 * x[0] +
+               0.05 * x[1];
+    };
+    IDiffProblem *problem = IDiffProblem::createDiffProblem(nullptr, args, ProblemKernel::make(f));
+    ISolver::Options options;
+    options.seeds = ISolver::Seeds::GRID;
+    ISolver *solver = ISolver::createSolver(options);
+    assert(solver->setProblem(problem) == RC::SUCCESS);
+
+    // Global mode requires domain, local solve keeps its solution as the only optimum
+    assert(solver->solveByArgs(nullptr, nullptr) == RC::INVALID_ARGUMENT);
+    ISet *optima = nullptr;
+    assert(solver->getOptima(optima) == RC::NO_ARGS_SET);
+    assert(solver->setArgsDomain(args) == RC::SUCCESS);
+
+    const ISolver::Seeds seeds[] = {ISolver::Seeds::GRID, ISolver::Seeds::HALTON};
+    double best_data[2] = {0, 0};
+    for (size_t kind = 0; kind < SIZEOF_ARR(seeds); ++kind) {
+        for (size_t threads = 1; threads <= 3; threads += 2) {
+            options.seeds = seeds[kind];
+            options.seedsCount = 32;
+            options.threads = threads;
+            ISolver *global = ISolver::createSolver(options);
+            global->setProblem(problem);
+            global->setArgsDomain(args);
+            assert(global->solveByArgs(nullptr, nullptr) == RC::SUCCESS);
+            ISolver::Summary summary = global->getSummary();
+            assert(summary.converged && summary.starts == (kind == 0 ? 25 : 32));
+
+            assert(global->getOptima(optima) == RC::SUCCESS);
+            assert(optima->getSize() == 4);
+            IVector *best = nullptr, *solution = nullptr;
+            assert(optima->getCopy(0, best) == RC::SUCCESS && global->getSolution(solution) == RC::SUCCESS);
+            assert(best->getData()[0] < -1 && best->getData()[1] < -1);
+            assert(IVector::equals(best, solution, IVector::NORM::CHEBYSHEV, TOLERANCE));
+            assert(std::fabs(summary.value - f(best->getData(), nullptr)) < TOLERANCE);
+            if (kind == 0 && threads == 1)
+                std::copy(best->getData(), best->getData() + 2, best_data);
+            assert(std::fabs(best->getData()[0] - best_data[0]) < TOLERANCE);
+            assert(std::fabs(best->getData()[1] - best_data[1]) < TOLERANCE);
+
+            delete solution;
+            delete best;
+            delete optima;
+            delete global;
+        }
+    }
+
+    // Only the best optima are kept
+    options.optimaCount = 0;
+    assert(ISolver::createSolver(options) == nullptr);
+    options.optimaCount = 2;
+    ISolver *bounded = ISolver::createSolver(options);
+    bounded->setProblem(problem);
+    bounded->setArgsDomain(args);
+    assert(bounded->solveByArgs(nullptr, nullptr) == RC::SUCCESS);
+    assert(bounded->getOptima(optima) == RC::SUCCESS && optima->getSize() == 2);
+    IVector *best = nullptr;
+    assert(optima->getCopy(0, best) == RC::SUCCESS);
+    assert(std::fabs(best->getData()[0] - best_data[0]) < TOLERANCE);
+    delete best;
+    delete optima;
+    delete bounded;
+
+    // Local solve
+    options.seeds = ISolver::Seeds::NONE;
+    ISolver *local = ISolver::createSolver(options);
+    local->setProblem(problem);
+    double init_data[] = {1.5, 1.5};
+    IVector *init = IVector::createVector(SIZEOF_ARR(init_data), init_data);
+    assert(local->solveByArgs(init, nullptr) == RC::SUCCESS);
+    assert(local->getOptima(optima) == RC::SUCCESS && optima->getSize() == 1);
+    assert(local->getSummary().starts == 1);
+
+    delete optima;
+    delete init;
+    delete local;
+    delete solver;
+    delete problem;
+    delete args;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testGrid() {
+    CREATE_LOGGER
+    ICompact *args = createBox(2, -2, 2, 5);
+    ISolver::GridOptions options;
+    options.best = 0;
+    assert(ISolver::createGridSolver(options) == nullptr);
+
+    // Non-differentiable function, the nearest node of 5 x 5 grid is (0, -1)
+    auto corner = [](double const *x, double const *) { return std::fabs(x[0] - 0.3) + std::fabs(x[1] + 0.7); };
+    IProblem *problem = IProblem::createProblem(nullptr, args, ProblemKernel::make(corner));
+    options.best = 1;
+    ISolver *solver = ISolver::createGridSolver(options);
+    assert(solver->setProblem(problem) == RC::SUCCESS);
+    assert(solver->solveByArgs(nullptr, nullptr) == RC::INVALID_ARGUMENT);
+    assert(solver->setArgsDomain(args) == RC::SUCCESS);
+    assert(solver->solveByArgs(nullptr, nullptr) == RC::SUCCESS);
+    IVector *solution = nullptr;
+    assert(solver->getSolution(solution) == RC::SUCCESS);
+    assert(solution->getData()[0] == 0 && solution->getData()[1] == -1);
+    assert(solver->getSummary().evaluations == 25 && solver->getSummary().iterations == 1);
+    delete solution;
+
+    // Grid of several blocks, every refinement halves step around the best node, result doesn't depend on threads
+    ICompact *fine = createBox(2, -2, 2, 37);
+    double levels_data[] = {12};
+    IVector *levels = IVector::createVector(SIZEOF_ARR(levels_data), levels_data);
+    IVector *overrides[] = {levels};
+    double refined[2] = {0, 0};
+    for (size_t threads = 1; threads <= 3; threads += 2) {
+        options.threads = threads;
+        ISolver *parallel = ISolver::createGridSolver(options);
+        parallel->setProblem(problem);
+        parallel->setArgsDomain(fine);
+        assert(parallel->solveByArgs(nullptr, overrides) == RC::SUCCESS);
+        assert(parallel->getSummary().iterations == 13);
+        assert(parallel->getSolution(solution) == RC::SUCCESS);
+        assert(std::fabs(solution->getData()[0] - 0.3) < 1e-4 && std::fabs(solution->getData()[1] + 0.7) < 1e-4);
+        if (threads == 1)
+            std::copy(solution->getData(), solution->getData() + 2, refined);
+        assert(solution->getData()[0] == refined[0] && solution->getData()[1] == refined[1]);
+        delete solution;
+        delete parallel;
+    }
+
+    // The best nodes of grid near four minima, the lowest one first
+    auto wells = [](double const *x, double const *) {
+        return (x[0] * x[0] - 1) * (x[0] * x[0] - 1) + (x[1] * x[1] - 1) * (x[1] * x[1] - 1) + 0.1 * x[0] +
+               0.05 * x[1];
+    };
+    IProblem *multimodal = IProblem::createProblem(nullptr, args, ProblemKernel::make(wells));
+    options.best = 4;
+    ISolver *top = ISolver::createGridSolver(options);
+    top->setProblem(multimodal);
+    top->setArgsDomain(args);
+    assert(top->solveByArgs(nullptr, nullptr) == RC::SUCCESS);
+    ISet *optima = nullptr;
+    assert(top->getOptima(optima) == RC::SUCCESS && optima->getSize() == 4);
+    IVector *best = nullptr;
+    assert(optima->getCopy(0, best) == RC::SUCCESS);
+    assert(best->getData()[0] == -1 && best->getData()[1] == -1);
+    delete best;
+    delete optima;
+
+    // No finite values
+    auto undefined = [](double const *, double const *) { return std::numeric_limits<double>::quiet_NaN(); };
+    IProblem *nowhere = IProblem::createProblem(nullptr, args, ProblemKernel::make(undefined));
+    top->setProblem(nowhere);
+    assert(top->solveByArgs(nullptr, nullptr) == RC::NOT_NUMBER);
+    assert(top->getSolution(solution) == RC::NO_ARGS_SET);
+
+    delete nowhere;
+    delete top;
+    delete multimodal;
+    delete levels;
+    delete fine;
+    delete solver;
+    delete problem;
+    delete args;
+    CLEAR_LOGGER
+}
+
+void SolverTest::testAll() {
+    std::cout << "Running all Solver tests" << std::endl;
+
+    testCreate();
+    testMethods();
+    testDomain();
+    testByParams();
+    testGlobal();
+    testGrid();
+
+    std::cout << "Successfully ran all Solver tests" << std::endl;
+}
@@ -0,0 +1,178 @@
+#include "Stats.h"
+#include "tests.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// Without VS_MATH_STATS every counter stays zero
+uint64_t expected(uint64_t value) {
+#ifdef VS_MATH_STATS
+    return value;
+#else
+    (void)value;
+    return 0;
+#endif
+}
+} // namespace
+
+void StatsTest::testVectorCounters() {
+    Stats::reset();
+    CREATE_VEC_ONE
+    CREATE_VEC_TWO
+
+    IVector *copy = vec1->clone();
+    assert(Stats::getCounter(Stats::Counter::VECTOR_CLONES) == expected(1));
+    assert(Stats::getCounter(Stats::Counter::VECTOR_ALLOCATIONS) == expected(3));
+
+    Stats::reset();
+    assert(IVector::equals(vec1, copy, DEFAULT_NORM, TOLERANCE));
+    assert(!IVector::equals(vec1, vec2, DEFAULT_NORM, TOLERANCE));
+    assert(Stats::getCounter(Stats::Counter::VECTOR_EQUALS) == expected(2));
+
+    delete copy;
+    CLEAR_VEC_ONE
+    CLEAR_VEC_TWO
+}
+
+void StatsTest::testSetCounters() {
+    CREATE_VEC_ONE
+    CREATE_VEC_TWO
+    CREATE_VEC_FOUR
+    CREATE_SET_ONE
+    CREATE_SET_TWO
+    Stats::reset();
+
+    set1->insert(vec1, DEFAULT_NORM, TOLERANCE);
+    set1->insert(vec2, DEFAULT_NORM, TOLERANCE);
+    set2->insert(vec4, DEFAULT_NORM, TOLERANCE);
+    // Inserts scan 0, 1 and 0 vectors
+    assert(Stats::getCounter(Stats::Counter::SET_SCANS) == expected(3));
+    assert(Stats::getCounter(Stats::Counter::SET_SCANNED_VECTORS) == expected(1));
+    assert(Stats::getTimerCalls(Stats::Timer::SET_INSERT) == expected(3));
+
+    Stats::reset();
+    assert(set1->findFirst(vec2, DEFAULT_NORM, TOLERANCE) == RC::SUCCESS);
+    assert(Stats::getCounter(Stats::Counter::SET_SCANS) == expected(1));
+    assert(Stats::getCounter(Stats::Counter::SET_SCANNED_VECTORS) == expected(2));
+
+    ISet *un = ISet::makeUnion(set1, set2, DEFAULT_NORM, TOLERANCE);
+    ISet *inter = ISet::makeIntersection(set1, set2, DEFAULT_NORM, TOLERANCE);
+    assert(un != nullptr && inter != nullptr);
+    assert(Stats::getTimerCalls(Stats::Timer::SET_MAKE_UNION) == expected(1));
+    assert(Stats::getTimerCalls(Stats::Timer::SET_MAKE_INTERSECTION) == expected(1));
+    assert((Stats::getTimerNanoseconds(Stats::Timer::SET_MAKE_UNION) > 0) == (expected(1) == 1));
+
+    delete un;
+    delete inter;
+    CLEAR_SET_ONE
+    CLEAR_SET_TWO
+    CLEAR_VEC_ONE
+    CLEAR_VEC_TWO
+    CLEAR_VEC_FOUR
+}
+
+void StatsTest::testCompactCounters() {
+    CREATE_COM_ONE
+    size_t order_data[] = {0, 1};
+    IMultiIndex *order = IMultiIndex::createMultiIndex(SIZEOF_ARR(order_data), order_data);
+    Stats::reset();
+
+    ICompact::IIterator *iter = com1->getBegin(order);
+    size_t nodes = 0;
+    for (; iter->isValid(); iter->next())
+        ++nodes;
+    assert(nodes == 36);
+    // The last step leaves the grid
+    assert(Stats::getCounter(Stats::Counter::COMPACT_ITERATOR_STEPS) == expected(36));
+
+    std::vector<double> out(36 * 2);
+    assert(com1->generateNodes(0, 36, order, out.data()) == RC::SUCCESS);
+    assert(com1->parallelForEachNode(order, [](size_t, double const *) {}, 2) == RC::SUCCESS);
+    assert(Stats::getCounter(Stats::Counter::COMPACT_SWEEP_NODES) == expected(72));
+    assert(Stats::getTimerCalls(Stats::Timer::COMPACT_SWEEP) == expected(2));
+
+    // Multi-indices are counted apart from blocks of compacts
+    Stats::reset();
+    IMultiIndex *copy = order->clone();
+    assert(copy != nullptr);
+    assert(Stats::getCounter(Stats::Counter::MULTI_INDEX_ALLOCATIONS) == expected(1));
+    assert(Stats::getCounter(Stats::Counter::COMPACT_ALLOCATIONS) == 0);
+
+    delete copy;
+    delete iter;
+    delete order;
+    CLEAR_COM_ONE
+}
+
+void StatsTest::testThreads() {
+    const size_t THREADS = 4, VECTORS = 100;
+    Stats::reset();
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < THREADS; ++thread)
+        threads.emplace_back([&]() {
+            double data[] = {1, 2, 3};
+            for (size_t idx = 0; idx < VECTORS; ++idx)
+                delete IVector::createVector(SIZEOF_ARR(data), data);
+        });
+    for (size_t thread = 0; thread < THREADS; ++thread)
+        threads[thread].join();
+
+    // Counts of exited threads stay in sums
+    assert(Stats::getCounter(Stats::Counter::VECTOR_ALLOCATIONS) == expected(THREADS * VECTORS));
+
+    // Blocks of exited threads are reused, so counts don't get lost
+    threads.clear();
+    for (size_t thread = 0; thread < THREADS; ++thread)
+        threads.emplace_back([&]() {
+            double data[] = {1, 2, 3};
+            delete IVector::createVector(SIZEOF_ARR(data), data);
+        });
+    for (size_t thread = 0; thread < THREADS; ++thread)
+        threads[thread].join();
+    assert(Stats::getCounter(Stats::Counter::VECTOR_ALLOCATIONS) == expected(THREADS * (VECTORS + 1)));
+}
+
+void StatsTest::testGetStats() {
+    CREATE_LOGGER
+    CREATE_VEC_ONE
+    Stats::reset();
+
+    SendSevere(logger, ILogger::Module::VECTOR, RC::INVALID_ARGUMENT);
+    delete vec1->clone();
+    const std::string json = Stats::getStats();
+    assert(json.front() == '{' && json.back() == '}');
+    const char *const keys[] = {"\"enabled\"", "\"threads\"", "\"counters\"", "\"timers\"", "\"vector_clones\": ",
+                                "\"log_calls\": ", "\"set_make_union\": {\"calls\": ", "\"max_ns\": "};
+    for (size_t idx = 0; idx < SIZEOF_ARR(keys); ++idx)
+        assert(json.find(keys[idx]) != std::string::npos);
+#ifdef VS_MATH_STATS
+    assert(json.find("\"enabled\": true") != std::string::npos);
+    assert(json.find("\"vector_clones\": 1") != std::string::npos);
+    assert(json.find("\"log_calls\": 1") != std::string::npos);
+#else
+    assert(json.find("\"enabled\": false") != std::string::npos);
+#endif
+
+    Stats::reset();
+    assert(Stats::getCounter(Stats::Counter::VECTOR_CLONES) == 0);
+    assert(Stats::getCounter(Stats::Counter::LOG_CALLS) == 0);
+
+    CLEAR_VEC_ONE
+    CLEAR_LOGGER
+}
+
+void StatsTest::testAll() {
+    std::cout << "Running all Stats tests" << std::endl;
+
+    testVectorCounters();
+    testSetCounters();
+    testCompactCounters();
+    testThreads();
+    testGetStats();
+
+    std::cout << "Successfully ran all Stats tests" << std::endl;
+}
@@ -5,5 +5,10 @@ int main() {
     SetTest::testAll();
     MultiIndexTest::testAll();
     CompactTest::testAll();
+    CompactIndexTest::testAll();
+    LoggerTest::testAll();
+    StatsTest::testAll();
+    ProblemTest::testAll();
+    SolverTest::testAll();
     return 0;
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #pragma once
 #include "ICompact.h"
+#include "IDiffProblem.h"
 #include "ILogger.h"
 #include "IMultiIndex.h"
 #include "ISet.h"
+#include "ISolver.h"
 #include "IVector.h"
+#include <cstddef>
+#include <vector>
 
 #define TOLERANCE 1e-6
 #define DEFAULT_NORM IVector::NORM::SECOND
@@ -15,7 +19,10 @@
     IVector::setLogger(logger);                                                                                        \
     ISet::setLogger(logger);                                                                                           \
     IMultiIndex::setLogger(logger);                                                                                    \
-    ICompact::setLogger(logger);
+    ICompact::setLogger(logger);                                                                                       \
+    IProblem::setLogger(logger);                                                                                       \
+    IDiffProblem::setLogger(logger);                                                                                   \
+    ISolver::setLogger(logger);
 #define CREATE_VEC_ONE                                                                                                 \
     double data1[] = {1, 5.5, 6, 8.5};                                                                                 \
     IVector *vec1 = IVector::createVector(SIZEOF_ARR(data1), data1);
@@ -81,6 +88,24 @@
     CLEAR_LOGGER CLEAR_VEC_ONE CLEAR_VEC_TWO CLEAR_VEC_THREE CLEAR_SET_ONE CLEAR_SET_TWO CLEAR_SET_THREE               \
         CLEAR_VEC_FOUR CLEAR_INDEX_ONE CLEAR_INDEX_TWO CLEAR_COM_ONE CLEAR_COM_TWO
 
+// Box [left, right] of dim axes with nodes nodes per axis, caller deletes it
+inline ICompact *createBox(size_t dim, double const *left, double const *right, size_t nodes) {
+    std::vector<size_t> grid_data(dim, nodes);
+    IVector *left_vec = IVector::createVector(dim, left);
+    IVector *right_vec = IVector::createVector(dim, right);
+    IMultiIndex *grid = IMultiIndex::createMultiIndex(dim, grid_data.data());
+    ICompact *box = ICompact::createCompact(left_vec, right_vec, grid);
+    delete left_vec;
+    delete right_vec;
+    delete grid;
+    return box;
+}
+// Cube [left, right]^dim
+inline ICompact *createBox(size_t dim, double left, double right, size_t nodes) {
+    std::vector<double> left_data(dim, left), right_data(dim, right);
+    return createBox(dim, left_data.data(), right_data.data(), nodes);
+}
+
 namespace VecTest {
 void testCreate();
 
@@ -155,6 +180,8 @@ void testSetData();
 void testSetAxisIndex();
 void testIncAxisIndex();
 
+void testSmallMultiIndex();
+
 void testAll();
 }; // namespace MultiIndexTest
 
@@ -170,11 +197,81 @@ void testGetRightBoundary();
 void testGetVectorCoords();
 void testGetVectorCopy();
 void testIsInside();
+void testIsInsideBatch();
 
 void testIntersection();
 void testSpan();
+void testBatchIntersection();
 
 void testIterator();
+void testIteratorNodes();
+void testGenerateNodes();
+void testParallelForEachNode();
+void testLinearIndex();
+void testTraversal();
+void testIteratorAllocations();
+
+void testNonUniformGrid();
+void testRefinement();
+
+void testAll();
+}; // namespace CompactTest
+
+namespace CompactIndexTest {
+void testCreate();
+
+void testFindContaining();
+void testFindOverlapping();
+void testFindContainingBatch();
+
+void testAll();
+}; // namespace CompactIndexTest
+
+namespace LoggerTest {
+void testAsyncLogger();
+void testAsyncLoggerThreads();
+void testAsyncLoggerOverflow();
+void testLevelFilter();
+void testModuleMask();
+void testRateLimitedLogger();
+void testRateLimitedLoggerThreads();
+void testBinaryLogger();
+void testThreadSafeLogger();
+void testThreadSafeLoggerStress();
+void testThreadSafeLoggerThreadExit();
+void testSetLoggerThreads();
+
+void testAll();
+}; // namespace LoggerTest
+
+namespace StatsTest {
+void testVectorCounters();
+void testSetCounters();
+void testCompactCounters();
+void testThreads();
+void testGetStats();
+
+void testAll();
+}; // namespace StatsTest
+
+namespace ProblemTest {
+void testCreate();
+void testEval();
+void testBatch();
+void testGradient();
+void testDerivative();
+void testAutoDiff();
+
+void testAll();
+}; // namespace ProblemTest
+
+namespace SolverTest {
+void testCreate();
+void testMethods();
+void testDomain();
+void testByParams();
+void testGlobal();
+void testGrid();
 
 void testAll();
-}; // namespace CompactTest
\ No newline at end of file
+}; // namespace SolverTest
@@ -0,0 +1,175 @@
+#include "BinaryLog.h"
+#include "LoggerMessages.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*
+ * Decoder of binary logs written by ILogger::createBinaryLogger()
+ *
+ * Usage: vs_math-logdecode [--csv] [--by-code | --by-site] <log>
+ *
+ * Prints records as text in format of ILogger::createLogger() prefixed with seconds since start of log, or as CSV.
+ * --by-code and --by-site print quantity of records per error code or per call site instead, the most frequent first
+ */
+
+namespace {
+enum class Mode { RECORDS, BY_CODE, BY_SITE };
+
+struct Count {
+    uint64_t records = 0; // entries in log
+    uint64_t total = 0;   // records they stand for, including collapsed ones
+};
+
+// Call site: srcfile, function, line, code, level
+typedef std::tuple<std::string, std::string, int32_t, int, int> Site;
+
+// Quotes CSV field if needed
+std::string csv(const std::string &field) {
+    if (field.find_first_of(",\"\n") == std::string::npos)
+        return field;
+    std::string quoted = "\"";
+    for (size_t idx = 0; idx < field.size(); ++idx) {
+        if (field[idx] == '"')
+            quoted += '"';
+        quoted += field[idx];
+    }
+    return quoted + "\"";
+}
+
+void printRecord(const BinaryLog::Reader &reader, const BinaryLog::Record &record, bool as_csv) {
+    const std::string &srcfile = reader.getString(record.srcfile);
+    const std::string &function = reader.getString(record.function);
+    const char *level = LoggerMessages::level(record.level);
+    const char *message = LoggerMessages::message(record.code);
+    const uint64_t elapsed = record.time - reader.getHeader().start_time;
+
+    if (as_csv) {
+        std::printf("%llu,%llu,%s,%d,%s,%s,%s,%d,%llu\n", (unsigned long long)(reader.getHeader().start_wall + elapsed),
+                    (unsigned long long)elapsed, level, (int)record.code, csv(message).c_str(), csv(srcfile).c_str(),
+                    csv(function).c_str(), (int)record.line, (unsigned long long)record.repeats);
+        return;
+    }
+    std::printf("[%llu.%06llu] ", (unsigned long long)(elapsed / 1000000000),
+                (unsigned long long)(elapsed / 1000 % 1000000));
+    if (!srcfile.empty())
+        std::printf("[%s] [%s] [%d] ", srcfile.c_str(), function.c_str(), (int)record.line);
+    std::printf("[%s] %s", level, message);
+    if (record.repeats > 1)
+        std::printf(" (repeated %llu times)", (unsigned long long)record.repeats);
+    std::printf("\n");
+}
+
+template <class Key>
+std::vector<std::pair<Key, Count>> sorted(const std::map<Key, Count> &counts) {
+    std::vector<std::pair<Key, Count>> rows(counts.begin(), counts.end());
+    std::stable_sort(rows.begin(), rows.end(), [](const std::pair<Key, Count> &lhs, const std::pair<Key, Count> &rhs) {
+        return lhs.second.total > rhs.second.total;
+    });
+    return rows;
+}
+
+void printByCode(const std::map<int, Count> &counts, bool as_csv) {
+    if (as_csv)
+        std::printf("code,message,records,total\n");
+    else
+        std::printf("%12s %12s  %s\n", "total", "records", "code");
+    std::vector<std::pair<int, Count>> rows = sorted(counts);
+    for (size_t idx = 0; idx < rows.size(); ++idx) {
+        const char *message = LoggerMessages::message((RC)rows[idx].first);
+        if (as_csv)
+            std::printf("%d,%s,%llu,%llu\n", rows[idx].first, csv(message).c_str(),
+                        (unsigned long long)rows[idx].second.records, (unsigned long long)rows[idx].second.total);
+        else
+            std::printf("%12llu %12llu  [%d] %s\n", (unsigned long long)rows[idx].second.total,
+                        (unsigned long long)rows[idx].second.records, rows[idx].first, message);
+    }
+}
+
+void printBySite(const std::map<Site, Count> &counts, bool as_csv) {
+    if (as_csv)
+        std::printf("srcfile,function,line,level,code,message,records,total\n");
+    else
+        std::printf("%12s %12s  %s\n", "total", "records", "call site");
+    std::vector<std::pair<Site, Count>> rows = sorted(counts);
+    for (size_t idx = 0; idx < rows.size(); ++idx) {
+        const Site &site = rows[idx].first;
+        const char *level = LoggerMessages::level((ILogger::Level)std::get<4>(site));
+        const char *message = LoggerMessages::message((RC)std::get<3>(site));
+        if (as_csv)
+            std::printf("%s,%s,%d,%s,%d,%s,%llu,%llu\n", csv(std::get<0>(site)).c_str(),
+                        csv(std::get<1>(site)).c_str(), (int)std::get<2>(site), level, std::get<3>(site),
+                        csv(message).c_str(), (unsigned long long)rows[idx].second.records,
+                        (unsigned long long)rows[idx].second.total);
+        else
+            std::printf("%12llu %12llu  [%s] [%s] [%d] [%s] %s\n", (unsigned long long)rows[idx].second.total,
+                        (unsigned long long)rows[idx].second.records, std::get<0>(site).c_str(),
+                        std::get<1>(site).c_str(), (int)std::get<2>(site), level, message);
+    }
+}
+
+int usage(const char *program) {
+    std::fprintf(stderr, "Usage: %s [--csv] [--by-code | --by-site] <log>\n", program);
+    return 2;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Mode mode = Mode::RECORDS;
+    bool as_csv = false;
+    const char *filename = nullptr;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (std::strcmp(argv[arg], "--csv") == 0)
+            as_csv = true;
+        else if (std::strcmp(argv[arg], "--by-code") == 0)
+            mode = Mode::BY_CODE;
+        else if (std::strcmp(argv[arg], "--by-site") == 0)
+            mode = Mode::BY_SITE;
+        else if (argv[arg][0] == '-' || filename != nullptr)
+            return usage(argv[0]);
+        else
+            filename = argv[arg];
+    }
+    if (filename == nullptr)
+        return usage(argv[0]);
+
+    BinaryLog::Reader reader;
+    RC err = reader.open(filename);
+    if (err != RC::SUCCESS) {
+        std::fprintf(stderr, "%s: %s\n", filename,
+                     err == RC::FILE_NOT_FOUND ? LoggerMessages::message(err) : "Not a binary log of vs_math");
+        return 1;
+    }
+
+    if (mode == Mode::RECORDS && as_csv)
+        std::printf("wall_ns,elapsed_ns,level,code,message,srcfile,function,line,repeats\n");
+    std::map<int, Count> by_code;
+    std::map<Site, Count> by_site;
+    BinaryLog::Record record;
+    while ((err = reader.next(record)) == RC::SUCCESS) {
+        if (mode == Mode::RECORDS) {
+            printRecord(reader, record, as_csv);
+            continue;
+        }
+        Count &count = mode == Mode::BY_CODE ? by_code[(int)record.code]
+                                             : by_site[Site(reader.getString(record.srcfile),
+                                                            reader.getString(record.function), record.line,
+                                                            (int)record.code, (int)record.level)];
+        ++count.records;
+        count.total += record.repeats;
+    }
+
+    if (mode == Mode::BY_CODE)
+        printByCode(by_code, as_csv);
+    else if (mode == Mode::BY_SITE)
+        printBySite(by_site, as_csv);
+    if (err != RC::INDEX_OUT_OF_BOUND) {
+        std::fprintf(stderr, "%s: log is truncated or corrupted\n", filename);
+        return 1;
+    }
+    return 0;
+}